@@ -9,13 +9,17 @@
 #include <glow/ScopedBinder.h>
 
 #include <algorithm>
+#include <cstring>
 #include <random>
 #include <vector>
 #include <opencv2/opencv.hpp>
 #include <glow/GlSampler.h>
 
 #include <glow/GlCapabilities.h>
+#include <glow/GlFormatConverter.h>
+#include <glow/GlProfiler.h>
 #include <glow/GlState.h>
+#include <glow/GlTextureUploader.h>
 #include <glow/util/X11OffscreenContext.h>
 
 #include "timer.h"
@@ -59,34 +63,33 @@ int main(int argc, char** argv) {
     cv::Mat image = cv::imread(image_file, CV_LOAD_IMAGE_COLOR);
     uint32_t width = image.cols, height = image.rows;
 
-    std::vector<float> values(3 * width * height, 0);
-    for(auto i = 0 ; i < image.rows; i++)
-        for(auto j = 0; j < image.cols; j++) {
-            float r = image.at<cv::Vec3b>(i,j)[0];
-            float g = image.at<cv::Vec3b>(i,j)[1];
-            float b = image.at<cv::Vec3b>(i,j)[2];
-
-            values[3 * (i * width +j)] = (float)r;
-            values[3 * (i * width +j) + 1] = (float)g;
-            values[3 * (i * width +j) + 2] = (float)b;
-        }
-
     cv::Mat cpu_smoothed_image;
-    Timer cpu_timer, gpu_timer;
+    Timer cpu_timer;
+    GlProfiler profiler;
     cpu_timer.start();
     imageConvolution(image, cpu_smoothed_image, convolution_radius);
     cpu_timer.stop();
     std::cout << "cpu Convolution: " << cpu_timer.elapsedMilliseconds() << "ms"<< std::endl;
 
 
-    gpu_timer.start();
+    profiler.beginFrame();
+    profiler.begin("setup");
     GlFramebuffer fbo(width, height);
 
     _CheckGlError(__FILE__, __LINE__);
 
     GlTexture input{width, height, TextureFormat::RGB_FLOAT};
 
-    input.assign(PixelFormat::RGB, PixelType::FLOAT, &values[0]);
+    // upload the 8-bit BGR rows of the image as they are; the transfer itself does not block.
+    GlTexture frame{width, height, TextureFormat::RGB};
+    PixelStore image_layout = PixelStore::fromStride(image.step, PixelFormat::BGR, PixelType::UNSIGNED_BYTE);
+    GlTextureUploader uploader(image.step * image.rows);
+    std::memcpy(uploader.map(), image.data, image.step * image.rows);
+    uploader.upload(frame, PixelFormat::BGR, PixelType::UNSIGNED_BYTE, image_layout);
+
+    // conversion to float on the GPU instead of the CPU.
+    GlFormatConverter converter;
+    converter.convert(frame, input);
 
     GlTexture output{width, height, TextureFormat::RGB_FLOAT};
     GlRenderbuffer rbo(width, height, RenderbufferFormat::DEPTH_STENCIL);
@@ -112,7 +115,9 @@ int main(int argc, char** argv) {
     sampler.setMinifyingOperation(TexMinOp::NEAREST);
 
     GlVertexArray vao_no_points;
+    profiler.end();
 
+    profiler.begin("convolution");
     fbo.bind();
     vao_no_points.bind();
     glActiveTexture(GL_TEXTURE0);
@@ -134,21 +139,19 @@ int main(int argc, char** argv) {
     sampler.release(0);
 
     glEnable(GL_DEPTH_TEST);
+    profiler.end();
+    profiler.endFrame();
 
-    gpu_timer.stop();
-    std::cout << "gpu Convolution : " << gpu_timer.elapsedMilliseconds() << "ms" << std::endl;
-
-    std::vector<vec4> data;
-    output.download(data);
+    // single frame: wait for the timestamps instead of reading them back some frames later.
+    profiler.flush();
+    auto stats = profiler.statistics();
+    std::cout << "gpu setup       : " << stats["setup"].gpuMean << "ms (cpu " << stats["setup"].cpuMean << "ms)" << std::endl;
+    std::cout << "gpu Convolution : " << stats["convolution"].gpuMean << "ms" << std::endl;
 
+    // download directly into the rows of the 8-bit BGR image.
     cv::Mat out_image(height,width, CV_8UC3);
-    for (int i = 0; i < width* height; i++) {
-        int x = i % width;
-        int y = i / width;
-        out_image.at<cv::Vec3b>(y,x)[0] =   data[i].x ;
-        out_image.at<cv::Vec3b>(y,x)[1] =   data[i].y ;
-        out_image.at<cv::Vec3b>(y,x)[2] =   data[i].z ;
-    }
+    output.download(PixelFormat::BGR, PixelType::UNSIGNED_BYTE, out_image.data,
+                    PixelStore::fromStride(out_image.step, PixelFormat::BGR, PixelType::UNSIGNED_BYTE));
 
     cv::imshow("image", image);
     cv::imshow("out_image", out_image);
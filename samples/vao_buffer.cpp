@@ -6,6 +6,7 @@
 #include <glow/GlFramebuffer.h>
 #include <glow/GlProgram.h>
 #include <glow/GlVertexArray.h>
+#include <glow/GlVertexLayout.h>
 #include <glow/ScopedBinder.h>
 
 #include <algorithm>
@@ -21,6 +22,12 @@
 #include "timer.h"
 using namespace glow;
 
+struct PixelVertex {
+  vec4 position;
+  vec4 color;
+};
+GLOW_VERTEX_LAYOUT(PixelVertex, position, color);
+
 int main(int argc, char** argv) {
     // init window
     glow::X11OffscreenContext ctx(3,3);  // OpenGl context
@@ -71,12 +78,8 @@ int main(int argc, char** argv) {
     color_buffer.assign(colors);
 
     GlVertexArray vao;
-    // 1. set
-    vao.setVertexAttribute(0, pixel_buffer, 4, AttributeType::FLOAT, false, 4 * sizeof(float), nullptr);
-    vao.setVertexAttribute(1, color_buffer, 4, AttributeType::FLOAT, false, 4 * sizeof(float), nullptr);
-    // 2. enable
-    vao.enableVertexAttribute(0);
-    vao.enableVertexAttribute(1);
+    // positions and colors in separate buffers as attributes 0 and 1.
+    vao.setSplitLayout<PixelVertex>(pixel_buffer, color_buffer);
 
     glDisable(GL_DEPTH_TEST);
 
@@ -84,11 +87,7 @@ int main(int argc, char** argv) {
     glClear(GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT);
     glViewport(0, 0, width, height);
     program.bind();
-    vao.bind();
-
-    glDrawArrays(GL_POINTS, 0, pixel_buffer.size());
-
-    vao.release();
+    vao.drawArrays(PrimitiveType::POINTS, 0, pixel_buffer.size());
     program.release();
     fbo.release();
 
@@ -0,0 +1,503 @@
+#include "GlBlitter.h"
+
+#include <algorithm>
+
+#include "GlSamplerCache.h"
+#include "GlStateGuard.h"
+#include "GlStats.h"
+#include "GlUniform.h"
+#include "glexception.h"
+#include "glutil.h"
+
+namespace glow {
+
+enum class BlitFormat { FLOAT, INT, UINT, DEPTH, DEPTH_STENCIL, STENCIL };
+
+/** \brief kind of internal format, which decides how values can be copied. **/
+inline BlitFormat blit_format(GLenum format) {
+  switch (format) {
+    case GL_R8I:
+    case GL_R16I:
+    case GL_R32I:
+    case GL_RG8I:
+    case GL_RG16I:
+    case GL_RG32I:
+    case GL_RGB8I:
+    case GL_RGB16I:
+    case GL_RGB32I:
+    case GL_RGBA8I:
+    case GL_RGBA16I:
+    case GL_RGBA32I:
+      return BlitFormat::INT;
+    case GL_R8UI:
+    case GL_R16UI:
+    case GL_R32UI:
+    case GL_RG8UI:
+    case GL_RG16UI:
+    case GL_RG32UI:
+    case GL_RGB8UI:
+    case GL_RGB16UI:
+    case GL_RGB32UI:
+    case GL_RGBA8UI:
+    case GL_RGBA16UI:
+    case GL_RGBA32UI:
+    case GL_RGB10_A2UI:
+      return BlitFormat::UINT;
+    case GL_DEPTH:
+    case GL_DEPTH_COMPONENT:
+    case GL_DEPTH_COMPONENT16:
+    case GL_DEPTH_COMPONENT24:
+    case GL_DEPTH_COMPONENT32:
+    case GL_DEPTH_COMPONENT32F:
+      return BlitFormat::DEPTH;
+    case GL_DEPTH_STENCIL:
+    case GL_DEPTH24_STENCIL8:
+    case GL_DEPTH32F_STENCIL8:
+      return BlitFormat::DEPTH_STENCIL;
+    case GL_STENCIL_INDEX:
+    case GL_STENCIL_INDEX8:
+      return BlitFormat::STENCIL;
+    default:
+      return BlitFormat::FLOAT;
+  }
+}
+
+inline bool is_color(BlitFormat format) {
+  return (format == BlitFormat::FLOAT || format == BlitFormat::INT || format == BlitFormat::UINT);
+}
+
+inline GLenum attachment_of(BlitFormat format) {
+  switch (format) {
+    case BlitFormat::DEPTH:
+      return GL_DEPTH_ATTACHMENT;
+    case BlitFormat::DEPTH_STENCIL:
+      return GL_DEPTH_STENCIL_ATTACHMENT;
+    case BlitFormat::STENCIL:
+      return GL_STENCIL_ATTACHMENT;
+    default:
+      return GL_COLOR_ATTACHMENT0;
+  }
+}
+
+inline GLbitfield mask_of(BlitFormat format) {
+  switch (format) {
+    case BlitFormat::DEPTH:
+      return GL_DEPTH_BUFFER_BIT;
+    case BlitFormat::DEPTH_STENCIL:
+      return GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT;
+    case BlitFormat::STENCIL:
+      return GL_STENCIL_BUFFER_BIT;
+    default:
+      return GL_COLOR_BUFFER_BIT;
+  }
+}
+
+/** \brief attach given level (and layer for 3D textures) to the currently bound framebuffer. **/
+inline void attach_texture(GLenum target, GLenum attachment, const GlBlitTexture& texture, uint32_t layer,
+                           uint32_t level = 0) {
+  switch (texture.target) {
+    case GL_TEXTURE_1D:
+      glFramebufferTexture1D(target, attachment, GL_TEXTURE_1D, texture.id, level);
+      break;
+    case GL_TEXTURE_3D:
+    case GL_TEXTURE_2D_ARRAY:
+      glFramebufferTextureLayer(target, attachment, texture.id, level, layer);
+      break;
+    default:
+      glFramebufferTexture2D(target, attachment, texture.target, texture.id, level);
+  }
+}
+
+/** \brief remove the texture, so that the cached framebuffer does not keep it alive. **/
+inline void detach_texture(GLenum target, GLenum attachment) {
+  glFramebufferTexture2D(target, attachment, GL_TEXTURE_2D, 0, 0);
+}
+
+GlBlitter& GlBlitter::getInstance() {
+  static std::unique_ptr<GlBlitter> instance(new GlBlitter());
+
+  return *instance;
+}
+
+GlBlitter::GlBlitter() {}
+
+void GlBlitter::copy(const GlBlitTexture& src, const GlBlitTexture& dst, TexMagOp filter) {
+  if (src.id == dst.id) return;
+
+  bool scaled = (src.width != dst.width || src.height != dst.height);
+  if (filter == TexMagOp::LINEAR && scaled && blit_format(src.format) != BlitFormat::FLOAT) {
+    throw GlTextureError("Unable to copy: only float or normalized values can be interpolated LINEAR.");
+  }
+  if (!scaled) filter = TexMagOp::NEAREST;
+
+  if (copyImage(src, dst)) return;
+  if (blit(src, dst, false, filter)) return;
+
+  draw(src, dst, nullptr, false, filter);
+}
+
+void GlBlitter::copy(const GlBlitTexture& src, const GlBlitTexture& dst, uint32_t width, uint32_t height,
+                     uint32_t depth) {
+  if (width == 0 || height == 0 || depth == 0) return;
+  if (width > std::min(src.width, dst.width) || height > std::min(src.height, dst.height) ||
+      depth > std::min(src.depth, dst.depth)) {
+    throw GlTextureError("Region exceeds the size of the source or destination texture.");
+  }
+
+  // the extent of the textures is only used as extent of the copied region.
+  GlBlitTexture srcRegion = src, dstRegion = dst;
+  srcRegion.width = dstRegion.width = width;
+  srcRegion.height = dstRegion.height = height;
+  srcRegion.depth = dstRegion.depth = depth;
+
+  copy(srcRegion, dstRegion);
+}
+
+void GlBlitter::convert(const GlBlitTexture& src, const GlBlitTexture& dst, const GlBlitConversion& conversion) {
+  draw(src, dst, &conversion);
+}
+
+void GlBlitter::flip(const GlBlitTexture& src, const GlBlitTexture& dst) {
+  if (src.id == dst.id) throw GlTextureError("Unable to flip a texture in place.");
+
+  if (blit(src, dst, true)) return;
+
+  draw(src, dst, nullptr, true);
+}
+
+void GlBlitter::read(const GlBlitTexture& src, uint32_t level, uint32_t layer, uint32_t x, uint32_t y,
+                     uint32_t width, uint32_t height, PixelFormat pixelfmt, PixelType type, void* data,
+                     const PixelStore* layout) {
+  if (width == 0 || height == 0) return;
+  PixelStore previous = (layout != nullptr) ? layout->apply(true) : PixelStore::current(true);
+
+#if __GL_VERSION >= 450L
+  // size of the destination including the padding of the rows.
+  GLsizei bufSize = PixelStore::current(true).size(width, height, pixelfmt, type);
+
+  glGetTextureSubImage(src.id, level, x, y, layer, width, height, 1, static_cast<GLenum>(pixelfmt),
+                       static_cast<GLenum>(type), bufSize, data);
+#else
+  BlitFormat format = blit_format(src.format);
+  GLenum attachment = attachment_of(format);
+
+  GlStateGuard guard(GlStateCategory::FRAMEBUFFER);
+  guard.bindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer(0));
+  glReadBuffer(is_color(format) ? GL_COLOR_ATTACHMENT0 : GL_NONE);
+  attach_texture(GL_READ_FRAMEBUFFER, attachment, src, layer, level);
+  if (glCheckFramebufferStatus(GL_READ_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+    detach_texture(GL_READ_FRAMEBUFFER, attachment);
+    previous.apply(true);
+    throw GlTextureError("Unable to read region: format of texture is not renderable.");
+  }
+
+  glReadPixels(x, y, width, height, static_cast<GLenum>(pixelfmt), static_cast<GLenum>(type), data);
+  detach_texture(GL_READ_FRAMEBUFFER, attachment);
+#endif
+
+  previous.apply(true);
+  GLOW_STATS_DOWNLOADED(static_cast<uint64_t>(width) * height * pixelComponents(pixelfmt) * pixelTypeSize(type));
+  CheckGlError();
+}
+
+GlTexture& GlBlitter::scratch(uint32_t width, uint32_t height, TextureFormat format) {
+  std::shared_ptr<GlTexture>& texture = scratch_[format];
+  if (texture == nullptr) {
+    texture = std::make_shared<GlTexture>(width, height, format);
+  } else if (texture->width() != width || texture->height() != height) {
+    texture->resize(width, height);
+  }
+
+  return *texture;
+}
+
+void GlBlitter::clear() {
+  scratch_.clear();
+  framebuffers_ = nullptr;
+  vao_ = nullptr;
+  sampler_ = nullptr;
+  vertexShader_ = nullptr;
+  layeredVertexShader_ = nullptr;
+  geometryShader_ = nullptr;
+  programs_.clear();
+}
+
+bool GlBlitter::copyImage(const GlBlitTexture& src, const GlBlitTexture& dst) {
+#if __GL_VERSION >= 430L
+  if (src.format != dst.format) return false;
+  if (src.width != dst.width || src.height != dst.height || src.depth != dst.depth) return false;
+
+  glCopyImageSubData(src.id, src.target, 0, 0, 0, 0, dst.id, dst.target, 0, 0, 0, 0, src.width, src.height,
+                     src.depth);
+  CheckGlError();
+
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool GlBlitter::blit(const GlBlitTexture& src, const GlBlitTexture& dst, bool flip, TexMagOp filter) {
+  BlitFormat format = blit_format(src.format);
+  if (format != blit_format(dst.format) || src.depth != dst.depth) return false;
+  // depth and stencil values can only be blit between equal formats.
+  if (!is_color(format) && src.format != dst.format) return false;
+
+  GLenum attachment = attachment_of(format);
+  GLenum buffer = is_color(format) ? GL_COLOR_ATTACHMENT0 : GL_NONE;
+
+  GlStateGuard guard(GlStateCategory::FRAMEBUFFER | GlStateCategory::SCISSOR);
+  guard.setScissorTest(false);
+  guard.bindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer(0));
+  guard.bindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer(1));
+  glReadBuffer(buffer);
+  glDrawBuffer(buffer);
+
+  bool complete = true;
+  for (uint32_t z = 0; z < src.depth && complete; ++z) {
+    attach_texture(GL_READ_FRAMEBUFFER, attachment, src, z);
+    attach_texture(GL_DRAW_FRAMEBUFFER, attachment, dst, z);
+
+    // not every format is renderable; then the copy is done by drawing.
+    if (z == 0) {
+      complete = (glCheckFramebufferStatus(GL_READ_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE) &&
+                 (glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+      if (!complete) break;
+    }
+
+    // swapped y-coordinates of the destination flip the rows.
+    glBlitFramebuffer(0, 0, src.width, src.height, 0, flip ? dst.height : 0, dst.width, flip ? 0 : dst.height,
+                      mask_of(format), static_cast<GLenum>(filter));
+  }
+
+  detach_texture(GL_READ_FRAMEBUFFER, attachment);
+  detach_texture(GL_DRAW_FRAMEBUFFER, attachment);
+
+  CheckGlError();
+
+  return complete;
+}
+
+void GlBlitter::draw(const GlBlitTexture& src, const GlBlitTexture& dst, const GlBlitConversion* conversion,
+                     bool flip, TexMagOp filter) {
+  BlitFormat srcFormat = blit_format(src.format);
+  BlitFormat dstFormat = blit_format(dst.format);
+  if (!is_color(srcFormat) || !is_color(dstFormat)) {
+    throw GlTextureError("Unable to copy depth or stencil values between textures of different size or format.");
+  }
+
+  const char* prefix[3] = {"", "i", "u"};
+  std::string sampler = prefix[static_cast<uint32_t>(srcFormat)];
+  switch (src.target) {
+    case GL_TEXTURE_1D:
+      sampler += "sampler1D";
+      break;
+    case GL_TEXTURE_3D:
+      sampler += "sampler3D";
+      break;
+    case GL_TEXTURE_2D_ARRAY:
+      sampler += "sampler2DArray";
+      break;
+    case GL_TEXTURE_RECTANGLE:
+      sampler += "sampler2DRect";
+      break;
+    default:
+      sampler += "sampler2D";
+  }
+  std::string output = std::string(prefix[static_cast<uint32_t>(dstFormat)]) + "vec4";
+
+  // all layers of dst are drawn by a single instanced draw, where the geometry shader selects gl_Layer.
+  bool layered = (dst.depth > 1);
+  bool linear = (filter == TexMagOp::LINEAR);
+  GlProgram& prog = program(sampler, output, src.target, conversion != nullptr, layered, linear);
+
+  GlStateGuard guard(GlStateCategory::VIEWPORT | GlStateCategory::DEPTH | GlStateCategory::BLEND |
+                     GlStateCategory::SCISSOR | GlStateCategory::FRAMEBUFFER | GlStateCategory::PROGRAM |
+                     GlStateCategory::TEXTURE_UNITS);
+
+  guard.bindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer(1));
+  glDrawBuffer(GL_COLOR_ATTACHMENT0);
+  if (layered) {
+    glFramebufferTexture(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, dst.id, 0);
+  } else {
+    attach_texture(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, dst, 0);
+  }
+  if (glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+    detach_texture(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0);
+    throw GlTextureError("Unable to copy: format of destination texture is not color-renderable.");
+  }
+
+  guard.setDepthTest(false);
+  guard.setBlend(false);
+  guard.setScissorTest(false);
+  guard.setViewport(0, 0, dst.width, dst.height);
+  guard.bindTexture(0, src.target, src.id);
+
+  // Important: Sampler is needed to complete texture specification, e.g., if mipmaps are missing.
+  if (sampler_ == nullptr) {
+    // Note: For GL_TEXTURE_RECTANGLE GL_REPEAT is not an option.
+    GlSamplerDesc desc =
+        GlSamplerDesc().withFilter(TexMinOp::NEAREST, TexMagOp::NEAREST).withWrap(TexWrapOp::CLAMP_TO_EDGE);
+    sampler_ = GlSamplerCache::getInstance().get(desc);
+  }
+  if (linear && linearSampler_ == nullptr) {
+    GlSamplerDesc desc =
+        GlSamplerDesc().withFilter(TexMinOp::LINEAR, TexMagOp::LINEAR).withWrap(TexWrapOp::CLAMP_TO_EDGE);
+    linearSampler_ = GlSamplerCache::getInstance().get(desc);
+  }
+  if (vao_ == nullptr) vao_ = std::make_shared<GlVertexArray>();
+
+  const GlSampler& texSampler = linear ? *linearSampler_ : *sampler_;
+  texSampler.bind(0);
+  prog.setUniform(GlUniform<vec2>("scale", vec2(float(src.width) / dst.width, float(src.height) / dst.height)));
+  prog.setUniform(GlUniform<int32_t>("flipHeight", flip ? src.height : 0));
+  if (conversion != nullptr) {
+    prog.setUniform(GlUniform<vec4>("swizzle", conversion->swizzle));
+    prog.setUniform(GlUniform<vec4>("valueScale", conversion->scale));
+    prog.setUniform(GlUniform<vec4>("valueBias", conversion->bias));
+  }
+  prog.bind();
+  GLuint old_vao = vao_->bindTransparently();
+
+  if (layered) {
+    prog.setUniform(GlUniform<int32_t>("srcDepth", src.depth));
+    prog.setUniform(GlUniform<int32_t>("dstDepth", dst.depth));
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 3, dst.depth);
+  } else {
+    // nearest slice of the source.
+    prog.setUniform(GlUniform<int32_t>("layer", src.depth / 2));
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+  }
+  GLOW_STATS_CALL(DRAW);
+
+  vao_->releaseTransparently(old_vao);
+  texSampler.release(0);
+  detach_texture(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0);
+
+  CheckGlError();
+}
+
+GLuint GlBlitter::framebuffer(uint32_t idx) {
+  if (framebuffers_ == nullptr) {
+    GLuint* ids = new GLuint[2];
+    glGenFramebuffers(2, ids);
+    GLOW_STATS_CREATED(FRAMEBUFFER);
+    GLOW_STATS_CREATED(FRAMEBUFFER);
+    framebuffers_ = std::shared_ptr<GLuint>(ids, [](GLuint* ptr) {
+      glDeleteFramebuffers(2, ptr);
+      GLOW_STATS_DESTROYED(FRAMEBUFFER);
+      GLOW_STATS_DESTROYED(FRAMEBUFFER);
+      delete[] ptr;
+    });
+  }
+
+  return framebuffers_.get()[idx];
+}
+
+GlProgram& GlBlitter::program(const std::string& sampler, const std::string& output, GLenum target, bool convert,
+                              bool layered, bool linear) {
+  std::string key = sampler + " " + output + (convert ? " convert" : "") + (layered ? " layered" : "") +
+                    (linear ? " linear" : "");
+  auto it = programs_.find(key);
+  if (it != programs_.end()) return it->second;
+
+  // full-screen triangle without any vertex attributes.
+  if (vertexShader_ == nullptr) {
+    std::string vert = "#version 330 core\nvoid main(){\n";
+    vert += "  vec2 p = vec2(float((gl_VertexID & 1) << 2), float((gl_VertexID & 2) << 1));\n";
+    vert += "  gl_Position = vec4(p - 1.0, 0.0, 1.0);\n}";
+    vertexShader_ = std::make_shared<GlShader>(ShaderType::VERTEX_SHADER, vert);
+  }
+
+  // the instance is the layer of the destination, which is selected by the geometry shader.
+  if (layered && layeredVertexShader_ == nullptr) {
+    std::string vert = "#version 330 core\nuniform int srcDepth;\nuniform int dstDepth;\n";
+    vert += "flat out int dstLayer;\nflat out int srcLayer;\nvoid main(){\n";
+    vert += "  vec2 p = vec2(float((gl_VertexID & 1) << 2), float((gl_VertexID & 2) << 1));\n";
+    vert += "  gl_Position = vec4(p - 1.0, 0.0, 1.0);\n";
+    vert += "  dstLayer = gl_InstanceID;\n";
+    vert += "  srcLayer = (2 * gl_InstanceID + 1) * srcDepth / (2 * dstDepth);\n}";
+    layeredVertexShader_ = std::make_shared<GlShader>(ShaderType::VERTEX_SHADER, vert);
+
+    std::string geom = "#version 330 core\nlayout(triangles) in;\nlayout(triangle_strip, max_vertices = 3) out;\n";
+    geom += "flat in int dstLayer[];\nflat in int srcLayer[];\nflat out int layer;\nvoid main(){\n";
+    geom += "  for (int i = 0; i < 3; ++i) {\n";
+    geom += "    gl_Position = gl_in[i].gl_Position;\n    gl_Layer = dstLayer[0];\n    layer = srcLayer[0];\n";
+    geom += "    EmitVertex();\n  }\n  EndPrimitive();\n}";
+    geometryShader_ = std::make_shared<GlShader>(ShaderType::GEOMETRY_SHADER, geom);
+  }
+
+  std::string fetch;
+  switch (target) {
+    case GL_TEXTURE_1D:
+      fetch = "texelFetch(tex, p.x, 0)";
+      break;
+    case GL_TEXTURE_3D:
+    case GL_TEXTURE_2D_ARRAY:
+      fetch = "texelFetch(tex, ivec3(p, layer), 0)";
+      break;
+    case GL_TEXTURE_RECTANGLE:
+      fetch = "texelFetch(tex, p)";
+      break;
+    default:
+      fetch = "texelFetch(tex, p, 0)";
+  }
+  if (linear) {
+    // q is the position in texels of the source; slices along the depth stay nearest.
+    switch (target) {
+      case GL_TEXTURE_1D:
+        fetch = "texture(tex, q.x / float(textureSize(tex, 0)))";
+        break;
+      case GL_TEXTURE_3D:
+        fetch = "texture(tex, vec3(q / vec2(textureSize(tex, 0).xy), ";
+        fetch += "(float(layer) + 0.5) / float(textureSize(tex, 0).z)))";
+        break;
+      case GL_TEXTURE_2D_ARRAY:
+        fetch = "texture(tex, vec3(q / vec2(textureSize(tex, 0).xy), layer))";
+        break;
+      case GL_TEXTURE_RECTANGLE:
+        fetch = "texture(tex, q)";
+        break;
+      default:
+        fetch = "texture(tex, q / vec2(textureSize(tex, 0)))";
+    }
+  }
+
+  std::string frag = "#version 330 core\n";
+  frag += "uniform " + sampler + " tex;\nuniform vec2 scale;\nuniform int flipHeight;\n";
+  frag += layered ? "flat in int layer;\n" : "uniform int layer;\n";
+  if (convert) frag += "uniform vec4 swizzle;\nuniform vec4 valueScale;\nuniform vec4 valueBias;\n";
+  frag += "out " + output + " color;\nvoid main(){\n";
+  if (linear) {
+    frag += "  vec2 q = gl_FragCoord.xy * scale;\n";
+    frag += "  if (flipHeight > 0) q.y = float(flipHeight) - q.y;\n";
+  } else {
+    frag += "  ivec2 p = ivec2(gl_FragCoord.xy * scale);\n";
+    frag += "  if (flipHeight > 0) p.y = flipHeight - 1 - p.y;\n";
+  }
+  if (convert) {
+    frag += "  vec4 v = vec4(" + fetch + ");\n";
+    frag += "  float c[6] = float[6](v.r, v.g, v.b, v.a, 0.0, 1.0);\n";
+    frag += "  v = vec4(c[int(swizzle.r)], c[int(swizzle.g)], c[int(swizzle.b)], c[int(swizzle.a)]);\n";
+    std::string value = "v * valueScale + valueBias";
+    if (output != "vec4") value = "round(" + value + ")";
+    frag += "  color = " + output + "(" + value + ");\n}";
+  } else {
+    frag += "  color = " + output + "(" + fetch + ");\n}";
+  }
+
+  GlProgram prog;
+  if (layered) {
+    prog.attach(*layeredVertexShader_);
+    prog.attach(*geometryShader_);
+  } else {
+    prog.attach(*vertexShader_);
+  }
+  prog.attach(GlShader(ShaderType::FRAGMENT_SHADER, frag));
+  prog.link();
+  prog.setUniform(GlUniform<int32_t>("tex", 0));
+
+  return programs_.insert(std::make_pair(key, prog)).first->second;
+}
+
+} /* namespace glow */
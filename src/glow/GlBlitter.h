@@ -0,0 +1,142 @@
+#ifndef INCLUDE_GLOW_GLBLITTER_H_
+#define INCLUDE_GLOW_GLBLITTER_H_
+
+#include <stdint.h>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "GlPixelFormat.h"
+#include "GlProgram.h"
+#include "GlSampler.h"
+#include "GlShader.h"
+#include "GlTexture.h"
+#include "GlVertexArray.h"
+#include "glutil.h"
+
+namespace glow {
+
+/** \brief level 0 of a texture as source or destination of GlBlitter::copy. **/
+struct GlBlitTexture {
+ public:
+  GLuint id;
+  GLenum target;                  // GL_TEXTURE_1D, GL_TEXTURE_2D, GL_TEXTURE_3D, GL_TEXTURE_RECTANGLE, ...
+  uint32_t width, height, depth;  // at least 1 in each dimension.
+  GLenum format;                  // internal format.
+};
+
+/** \brief transformation of every texel by GlBlitter::convert: dst = swizzle(src) * scale + bias. **/
+struct GlBlitConversion {
+ public:
+  vec4 swizzle{0, 1, 2, 3};  // source channel of every destination channel: 0-3 (r, g, b, a), 4 (zero), 5 (one).
+  vec4 scale{1, 1, 1, 1};
+  vec4 bias{0, 0, 0, 0};
+};
+
+/** \brief Copies texture contents with objects that are created once and then reused.
+ *
+ *  Depending on the textures, the cheapest available way is taken:
+ *
+ *  1. same size and same internal format: glCopyImageSubData (only with OpenGL 4.3).
+ *  2. same kind of format (float/normalized, signed, unsigned, depth): glBlitFramebuffer with
+ *     the filter of the copy on the cached read and draw framebuffers; 3D textures are blit slice by slice.
+ *  3. otherwise: draw of a full-screen triangle with a cached program per sampler and output type,
+ *     which fetches the NEAREST texel or samples the source LINEAR. This also converts between integer and
+ *     float formats and scales along the depth of 3D textures. All layers of 3D or 2D array textures are
+ *     drawn by a single instanced draw into the layered framebuffer.
+ *
+ *  None of the paths waits for the GPU; all changed state is restored afterwards. The cached objects
+ *  are created lazily with the first copy and belong to the current context. Since glow assumes a
+ *  single context (see GlShaderCache), call clear() before the context is destroyed. Copies are counted
+ *  in GlStats by the callers, which know the size of the texels; draws are counted by the blitter.
+ **/
+class GlBlitter {
+ public:
+  static GlBlitter& getInstance();
+
+  /** \brief copy contents of src to dst, where the values are scaled with the given filter.
+   *
+   *  TexMagOp::LINEAR interpolates along width and height; slices along the depth are taken NEAREST.
+   *
+   *  \throws GlTextureError if integer, depth or stencil values should be interpolated LINEAR.
+   **/
+  void copy(const GlBlitTexture& src, const GlBlitTexture& dst, TexMagOp filter = TexMagOp::NEAREST);
+
+  /** \brief copy region [0, width) x [0, height) x [0, depth) of src to the same region of dst without scaling. **/
+  void copy(const GlBlitTexture& src, const GlBlitTexture& dst, uint32_t width, uint32_t height, uint32_t depth);
+
+  /** \brief draw src into dst, where every texel is transformed by the given conversion.
+   *
+   *  The texels are fetched NEAREST like in copy(src, dst), but always converted to float before the
+   *  transformation. Integer destinations get the rounded values.
+   *
+   *  \throws GlTextureError if src or dst is a depth or stencil texture, or dst is not color-renderable.
+   **/
+  void convert(const GlBlitTexture& src, const GlBlitTexture& dst, const GlBlitConversion& conversion);
+
+  /** \brief copy src to dst upside down, i.e., row y of src becomes row height - 1 - y of dst.
+   *
+   *  Like copy(src, dst), but without glCopyImageSubData; thus, the rows are flipped by glBlitFramebuffer
+   *  or by the draw. Used to bring images with the first row at the top into the row order of OpenGL.
+   **/
+  void flip(const GlBlitTexture& src, const GlBlitTexture& dst);
+
+  /** \brief read region [x, x + width) x [y, y + height) of given mip level and layer of src into data.
+   *
+   *  The layer is the slice of 3D textures or the layer of 2D array textures and must be 0 otherwise. With
+   *  OpenGL 4.5, the region is read by glGetTextureSubImage; otherwise, the level and layer are attached to
+   *  the cached read framebuffer and read by glReadPixels. Only the bytes of the region are transferred.
+   *
+   *  If layout is given, the rows are written with this layout; otherwise, the current layout is used (see
+   *  PixelStore::current).
+   *
+   *  \throws GlTextureError if the level or layer is not renderable (only without OpenGL 4.5).
+   **/
+  void read(const GlBlitTexture& src, uint32_t level, uint32_t layer, uint32_t x, uint32_t y, uint32_t width,
+            uint32_t height, PixelFormat pixelfmt, PixelType type, void* data, const PixelStore* layout = nullptr);
+
+  /** \brief cached two-dimensional scratch texture of given format, e.g., for the rows flipped by flip().
+   *
+   *  Like the scratch textures of GlFormatConverter, there is one texture per format, which is only
+   *  allocated again if the size changes. The content is only valid until the next call with the format.
+   **/
+  GlTexture& scratch(uint32_t width, uint32_t height, TextureFormat format);
+
+  /** \brief release all cached programs, framebuffers, scratch textures, etc. **/
+  void clear();
+
+ protected:
+  GlBlitter();
+  GlBlitter(const GlBlitter&);
+  GlBlitter& operator=(const GlBlitter&);
+
+  bool copyImage(const GlBlitTexture& src, const GlBlitTexture& dst);
+  bool blit(const GlBlitTexture& src, const GlBlitTexture& dst, bool flip = false,
+            TexMagOp filter = TexMagOp::NEAREST);
+  void draw(const GlBlitTexture& src, const GlBlitTexture& dst, const GlBlitConversion* conversion = nullptr,
+            bool flip = false, TexMagOp filter = TexMagOp::NEAREST);
+
+  /** \brief get cached read (0) or draw (1) framebuffer. **/
+  GLuint framebuffer(uint32_t idx);
+  /** \brief get cached program for given sampler and output type, which optionally applies a conversion.
+   *
+   *  Layered programs draw instance i into gl_Layer i of a layered framebuffer. Linear programs sample the
+   *  source with normalized coordinates instead of fetching the nearest texel.
+   **/
+  GlProgram& program(const std::string& sampler, const std::string& output, GLenum target, bool convert,
+                     bool layered, bool linear = false);
+
+  std::shared_ptr<GLuint> framebuffers_;
+  std::shared_ptr<GlVertexArray> vao_;
+  std::shared_ptr<const GlSampler> sampler_;
+  std::shared_ptr<const GlSampler> linearSampler_;
+  std::shared_ptr<GlShader> vertexShader_;
+  std::shared_ptr<GlShader> layeredVertexShader_;
+  std::shared_ptr<GlShader> geometryShader_;
+  std::map<std::string, GlProgram> programs_;
+  std::map<TextureFormat, std::shared_ptr<GlTexture> > scratch_;
+};
+
+} /* namespace glow */
+
+#endif /* INCLUDE_GLOW_GLBLITTER_H_ */
@@ -19,14 +19,21 @@ class TransformFeedback;
  * ELEMENT_ARRAY_BUFFER Vertex array indices
  * TRANSFORM_FEEDBACK_BUFFER
  * TEXTURE_BUFFER
+ * DRAW_INDIRECT_BUFFER Draw commands of indirect draws (OpenGL 4.0)
+ * PARAMETER_BUFFER Draw count of indirect draws (OpenGL 4.6)
+ * COPY_READ_BUFFER, COPY_WRITE_BUFFER Source and destination of buffer copies
  */
 enum class BufferTarget {
   ARRAY_BUFFER = GL_ARRAY_BUFFER,
   ELEMENT_ARRAY_BUFFER = GL_ELEMENT_ARRAY_BUFFER,
   TRANSFORM_FEEDBACK_BUFFER = GL_TRANSFORM_FEEDBACK_BUFFER,
-  TEXTURE_BUFFER = GL_TEXTURE_BUFFER
+  TEXTURE_BUFFER = GL_TEXTURE_BUFFER,
+  DRAW_INDIRECT_BUFFER = GL_DRAW_INDIRECT_BUFFER,
+  PARAMETER_BUFFER = GL_PARAMETER_BUFFER,
+  COPY_READ_BUFFER = GL_COPY_READ_BUFFER,
+  COPY_WRITE_BUFFER = GL_COPY_WRITE_BUFFER
   // TODO: other buffer types.
-  // GL_ATOMIC_COUNTER_BUFFER, GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, GL_DRAW_INDIRECT_BUFFER,
+  // GL_ATOMIC_COUNTER_BUFFER,
   // GL_DISPATCH_INDIRECT_BUFFER,
   // GL_PIXEL_PACK_BUFFER, GL_PIXEL_UNPACK_BUFFER, GL_QUERY_BUFFER, GL_SHADER_STORAGE_BUFFER, GL_TEXTURE_BUFFER,
   // GL_TRANSFORM_FEEDBACK_BUFFER, or GL_UNIFORM_BUFFER
@@ -225,8 +232,10 @@ template <class T>
 GlBuffer<T>::GlBuffer(BufferTarget target, BufferUsage usage)
     : target_(static_cast<GLenum>(target)), usage_(static_cast<GLenum>(usage)) {
   glGenBuffers(1, &id_);
+  GLOW_STATS_CREATED(BUFFER);
   ptr_ = std::shared_ptr<GLuint>(new GLuint(id_), [](GLuint* ptr) {
     glDeleteBuffers(1, ptr);
+    GLOW_STATS_DESTROYED(BUFFER);
     delete ptr;
   });
 }
@@ -235,6 +244,7 @@ template <class T>
 void GlBuffer<T>::bind() {
   boundBufferObject_ = id_;
   glBindBuffer(target_, id_);
+  GLOW_STATS_CALL(BIND_BUFFER);
   // FIXME: remove explicit checks?!
   //  CheckGlError();
 }
@@ -243,6 +253,7 @@ template <class T>
 void GlBuffer<T>::release() {
   boundBufferObject_ = 0;
   glBindBuffer(target_, 0);
+  GLOW_STATS_CALL(BIND_BUFFER);
   //  CheckGlError();
 }
 
@@ -272,10 +283,12 @@ void GlBuffer<T>::assign(const T* data, const uint32_t n) {
   if (capacity_ < n)  // reallocation needed?
   {
     glBufferData(target_, dataSize_ * n, 0, usage_);
+    GLOW_STATS_CALL(STATE);
     capacity_ = n;
   }
 
   glBufferSubData(target_, 0, dataSize_ * n, data);
+  GLOW_STATS_UPLOADED(dataSize_ * n);
   size_ = n;
 
   releaseTransparently(old_buffer);
@@ -296,6 +309,7 @@ void GlBuffer<T>::replace(uint32_t offset, const T* data, const uint32_t n) {
   GLuint old_buffer = bindTransparently();
 
   glBufferSubData(target_, offset * dataSize_, dataSize_ * std::min(n, size_ - offset), data);
+  GLOW_STATS_UPLOADED(dataSize_ * std::min(n, size_ - offset));
 
   releaseTransparently(old_buffer);
 
@@ -321,6 +335,7 @@ void GlBuffer<T>::get(std::vector<T>& data, uint32_t start, uint32_t size) const
 
   GLuint old_buffer = bindTransparently();
   glGetBufferSubData(target_, start * dataSize_, size * dataSize_, &data[0]);
+  GLOW_STATS_DOWNLOADED(size * dataSize_);
   releaseTransparently(old_buffer);
 }
 
@@ -334,13 +349,16 @@ void GlBuffer<T>::reserve(uint32_t num_elements) {
   if (size_ > 0) {
     // FIXME: have copy buffer here, not download & upload again.
     glGetBufferSubData(target_, 0, dataSize_ * size_, &data[0]);
+    GLOW_STATS_DOWNLOADED(dataSize_ * size_);
   }
 
   // resize buffer.
   glBufferData(target_, dataSize_ * num_elements, nullptr, static_cast<GLenum>(usage_));
+  GLOW_STATS_CALL(STATE);
 
   if (size_ > 0) {
     glBufferSubData(target_, 0, dataSize_ * size_, &data[0]);
+    GLOW_STATS_UPLOADED(dataSize_ * size_);
   }
 
   capacity_ = num_elements;
@@ -358,6 +376,7 @@ void GlBuffer<T>::assign(const GlBuffer<T>& other) {
   glBindBuffer(GL_COPY_WRITE_BUFFER, id_);
 
   glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, dataSize_ * other.size_);
+  GLOW_STATS_COPIED(dataSize_ * other.size_);
 
   glBindBuffer(GL_COPY_READ_BUFFER, 0);
   glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
@@ -383,13 +402,17 @@ void GlBuffer<T>::resize(uint32_t new_size) {
 
 template <class T>
 GLuint GlBuffer<T>::bindTransparently() const {
-  if (boundBufferObject_ == id_) return id_;
+  if (boundBufferObject_ == id_) {
+    GLOW_STATS_REDUNDANT_BIND();
+    return id_;
+  }
 
   // FIXME: boundBufferObject currently does not distinguish between different buffer targets:
   // FIXME: Thus, it would be easier to have different subclasses with corresponding types
   //        or template arguments GlBuffer<int BufferType, typename T>?
 
   glBindBuffer(target_, id_);
+  GLOW_STATS_CALL(BIND_BUFFER);
 
   return boundBufferObject_;
 }
@@ -399,6 +422,7 @@ void GlBuffer<T>::releaseTransparently(GLuint old_buffer) const {
   if (old_buffer == id_) return;  // nothing changed.
 
   glBindBuffer(target_, old_buffer);
+  GLOW_STATS_CALL(BIND_BUFFER);
 }
 
 template <class T>
@@ -413,6 +437,7 @@ void GlBuffer<T>::copyTo(uint32_t offset, uint32_t size, GlBuffer<T>& other, uin
 
   glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, offset * dataSize_, other_offset * dataSize_,
                       size * dataSize_);
+  GLOW_STATS_COPIED(size * dataSize_);
 
   glBindBuffer(GL_COPY_READ_BUFFER, 0);
   glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
@@ -48,8 +48,8 @@ GlCapabilities::GlCapabilities() {
   // OpenGL 4.3: GL_MAX_FRAMEBUFFER_LAYERS
   // OpenGL 4.3: GL_MAX_FRAMEBUFFER_SAMPLES
   // OpenGL 4.3: GL_MAX_FRAMEBUFFER_WIDTH
-  // GL_MAX_INTEGER_SAMPLES
-  // GL_MAX_SAMPLES
+  initGlParameter<int>(GL_MAX_INTEGER_SAMPLES, 1);
+  initGlParameter<int>(GL_MAX_SAMPLES, 1);
 
   // Programs:
   initGlParameter<int>(GL_MAX_ATOMIC_COUNTER_BUFFER_SIZE, 1);
@@ -138,6 +138,8 @@ std::string GlCapabilities::stringify_name(GLenum name) const {
   switch (name) {
     CASE(GL_MAX_COLOR_ATTACHMENTS)
     CASE(GL_MAX_COLOR_TEXTURE_SAMPLES)
+    CASE(GL_MAX_INTEGER_SAMPLES)
+    CASE(GL_MAX_SAMPLES)
     CASE(GL_MAX_3D_TEXTURE_SIZE)
     CASE(GL_MAX_DRAW_BUFFERS)
     CASE(GL_MAX_ATOMIC_COUNTER_BUFFER_SIZE)
@@ -1,6 +1,7 @@
 #ifndef INCLUDE_RV_GLCAPABILITIES_H_
 #define INCLUDE_RV_GLCAPABILITIES_H_
 
+#include <map>
 #include <memory>
 
 #include "GlState.h"
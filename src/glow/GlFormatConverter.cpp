@@ -0,0 +1,168 @@
+#include "GlFormatConverter.h"
+
+#include <algorithm>
+
+#include "GlStateGuard.h"
+#include "GlStats.h"
+#include "glexception.h"
+
+namespace glow {
+
+/** \brief internal format of the scratch texture, which holds data of given format and type without conversion. **/
+inline GLenum scratch_format(PixelFormat pixelfmt, PixelType type) {
+  bool integer = false;
+  switch (pixelfmt) {
+    case PixelFormat::R_INTEGER:
+    case PixelFormat::RG_INTEGER:
+    case PixelFormat::RGB_INTEGER:
+    case PixelFormat::BGR_INTEGER:
+    case PixelFormat::RGBA_INTEGER:
+    case PixelFormat::BGRA_INTEGER:
+      integer = true;
+      break;
+    case PixelFormat::DEPTH:
+    case PixelFormat::DEPTH_STENCIL:
+    case PixelFormat::STENCIL:
+      throw GlTextureError("Unable to convert depth or stencil data; use an integer pixel format instead.");
+    default:
+      break;
+  }
+
+  // formats with 1, 2, 3, and 4 components.
+  static const GLenum unorm8[4] = {GL_R8, GL_RG8, GL_RGB8, GL_RGBA8};
+  static const GLenum snorm8[4] = {GL_R8_SNORM, GL_RG8_SNORM, GL_RGB8_SNORM, GL_RGBA8_SNORM};
+  static const GLenum unorm16[4] = {GL_R16, GL_RG16, GL_RGB16, GL_RGBA16};
+  static const GLenum snorm16[4] = {GL_R16_SNORM, GL_RG16_SNORM, GL_RGB16_SNORM, GL_RGBA16_SNORM};
+  static const GLenum float16[4] = {GL_R16F, GL_RG16F, GL_RGB16F, GL_RGBA16F};
+  static const GLenum float32[4] = {GL_R32F, GL_RG32F, GL_RGB32F, GL_RGBA32F};
+  static const GLenum uint8[4] = {GL_R8UI, GL_RG8UI, GL_RGB8UI, GL_RGBA8UI};
+  static const GLenum int8[4] = {GL_R8I, GL_RG8I, GL_RGB8I, GL_RGBA8I};
+  static const GLenum uint16[4] = {GL_R16UI, GL_RG16UI, GL_RGB16UI, GL_RGBA16UI};
+  static const GLenum int16[4] = {GL_R16I, GL_RG16I, GL_RGB16I, GL_RGBA16I};
+  static const GLenum uint32[4] = {GL_R32UI, GL_RG32UI, GL_RGB32UI, GL_RGBA32UI};
+  static const GLenum int32[4] = {GL_R32I, GL_RG32I, GL_RGB32I, GL_RGBA32I};
+
+  uint32_t idx = pixelComponents(pixelfmt) - 1;
+  switch (type) {
+    case PixelType::UNSIGNED_BYTE:
+      return integer ? uint8[idx] : unorm8[idx];
+    case PixelType::BYTE:
+      return integer ? int8[idx] : snorm8[idx];
+    case PixelType::UNSIGNED_SHORT:
+      return integer ? uint16[idx] : unorm16[idx];
+    case PixelType::SHORT:
+      return integer ? int16[idx] : snorm16[idx];
+    case PixelType::UNSIGNED_INT:
+      return integer ? uint32[idx] : float32[idx];
+    case PixelType::INT:
+      return integer ? int32[idx] : float32[idx];
+    case PixelType::HALF_FLOAT:
+      if (!integer) return float16[idx];
+      break;
+    case PixelType::FLOAT:
+      if (!integer) return float32[idx];
+      break;
+  }
+
+  throw GlTextureError("Unable to convert floating point data with an integer pixel format.");
+}
+
+/** \brief index of the swizzled channel in the conversion shader. **/
+inline float swizzle_index(TexSwizzle swizzle) {
+  switch (swizzle) {
+    case TexSwizzle::R:
+      return 0;
+    case TexSwizzle::G:
+      return 1;
+    case TexSwizzle::B:
+      return 2;
+    case TexSwizzle::A:
+      return 3;
+    case TexSwizzle::ZERO:
+      return 4;
+    case TexSwizzle::ONE:
+      return 5;
+  }
+
+  return 0;
+}
+
+GlFormatConverter::GlFormatConverter() {}
+
+void GlFormatConverter::setSwizzle(TexSwizzle red, TexSwizzle green, TexSwizzle blue, TexSwizzle alpha) {
+  conversion_.swizzle = vec4(swizzle_index(red), swizzle_index(green), swizzle_index(blue), swizzle_index(alpha));
+}
+
+void GlFormatConverter::setScale(const vec4& scale) {
+  conversion_.scale = scale;
+}
+
+void GlFormatConverter::setBias(const vec4& bias) {
+  conversion_.bias = bias;
+}
+
+void GlFormatConverter::convert(GlTexture& dst, PixelFormat pixelfmt, PixelType type, const void* data,
+                                const PixelStore& layout) {
+  if (dst.depth() > 0) throw GlTextureError("Unable to convert into 3D textures.");
+
+  GLenum format = scratch_format(pixelfmt, type);
+  uint32_t width = dst.width(), height = std::max<uint32_t>(dst.height(), 1);
+
+  Scratch& scratch = scratch_[format];
+  {
+    GlStateGuard guard(GlStateCategory::TEXTURE_UNITS);
+
+    if (scratch.ptr == nullptr) {
+      GLuint id = 0;
+      glGenTextures(1, &id);
+      GLOW_STATS_CREATED(TEXTURE);
+      scratch.ptr = std::shared_ptr<GLuint>(new GLuint(id), [](GLuint* ptr) {
+        glDeleteTextures(1, ptr);
+        GLOW_STATS_DESTROYED(TEXTURE);
+        delete ptr;
+      });
+
+      guard.bindTexture(0, GL_TEXTURE_2D, id);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+      GLOW_STATS_CALL(STATE);
+    } else {
+      guard.bindTexture(0, GL_TEXTURE_2D, *scratch.ptr);
+    }
+
+    // the storage is only allocated again, if the size changes.
+    PixelStore previous = layout.apply(false);
+    if (scratch.width != width || scratch.height != height) {
+      glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, static_cast<GLenum>(pixelfmt),
+                   static_cast<GLenum>(type), data);
+      scratch.width = width;
+      scratch.height = height;
+    } else {
+      glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, static_cast<GLenum>(pixelfmt),
+                      static_cast<GLenum>(type), data);
+    }
+    GLOW_STATS_UPLOADED(static_cast<uint64_t>(width) * height * pixelComponents(pixelfmt) * pixelTypeSize(type));
+    previous.apply(false);
+  }
+
+  GlBlitTexture src;
+  src.id = *scratch.ptr;
+  src.target = GL_TEXTURE_2D;
+  src.width = width;
+  src.height = height;
+  src.depth = 1;
+  src.format = format;
+
+  GlBlitter::getInstance().convert(src, dst.blitTexture(), conversion_);
+}
+
+void GlFormatConverter::convert(const GlTexture& src, GlTexture& dst) {
+  GlBlitter::getInstance().convert(src.blitTexture(), dst.blitTexture(), conversion_);
+}
+
+void GlFormatConverter::clear() {
+  scratch_.clear();
+}
+
+} /* namespace glow */
@@ -0,0 +1,70 @@
+#ifndef INCLUDE_GLOW_GLFORMATCONVERTER_H_
+#define INCLUDE_GLOW_GLFORMATCONVERTER_H_
+
+#include <stdint.h>
+#include <map>
+#include <memory>
+
+#include "GlBlitter.h"
+#include "GlPixelFormat.h"
+#include "GlTexture.h"
+
+namespace glow {
+
+/** \brief Conversion of host images in their compact native format into textures of another format on the GPU.
+ *
+ *  Uploading, e.g., an 8-bit BGR camera image into a TextureFormat::RGB_FLOAT texture needs either a
+ *  conversion on the CPU or in the driver. The converter instead uploads the image as it is into a
+ *  scratch texture of matching format and draws it into the destination texture, where every texel is
+ *  transformed by
+ *
+ *    dst = swizzle(src) * scale + bias.
+ *
+ *  The scratch texture is chosen by pixel format and type: normalized formats (PixelFormat::RGB, ...)
+ *  give values in [0, 1] (or [-1, 1] for signed types); integer formats (PixelFormat::R_INTEGER, ...)
+ *  keep the values. Thus, a 16-bit depth image in millimeters is converted to meters by
+ *
+ *    converter.setScale(vec4(0.001f, 0.001f, 0.001f, 1.0f));
+ *    converter.convert(depth, PixelFormat::R_INTEGER, PixelType::UNSIGNED_SHORT, data);
+ *
+ *  The channel order of BGR(A) images is already resolved by the upload. Scratch textures are reused
+ *  for subsequent images of the same format and only reallocated if the size changes.
+ **/
+class GlFormatConverter {
+ public:
+  GlFormatConverter();
+
+  /** \brief source channel of every destination channel, e.g., (R, R, R, ONE) for gray values. **/
+  void setSwizzle(TexSwizzle red, TexSwizzle green, TexSwizzle blue, TexSwizzle alpha);
+  /** \brief scale of every destination channel (applied after swizzle). **/
+  void setScale(const vec4& scale);
+  /** \brief bias of every destination channel (applied after scale). **/
+  void setBias(const vec4& bias);
+
+  /** \brief upload data of the size of dst into the scratch texture and convert it into dst.
+   *
+   *  \throws GlTextureError if dst is a 3D texture, or pixel format and type have no scratch format.
+   **/
+  void convert(GlTexture& dst, PixelFormat pixelfmt, PixelType type, const void* data,
+               const PixelStore& layout = PixelStore());
+
+  /** \brief convert the texture src into dst, which are scaled by the NEAREST texel. **/
+  void convert(const GlTexture& src, GlTexture& dst);
+
+  /** \brief release all scratch textures. **/
+  void clear();
+
+ protected:
+  struct Scratch {
+   public:
+    std::shared_ptr<GLuint> ptr;
+    uint32_t width{0}, height{0};
+  };
+
+  GlBlitConversion conversion_;
+  std::map<GLenum, Scratch> scratch_;  // scratch texture per internal format.
+};
+
+} /* namespace glow */
+
+#endif /* INCLUDE_GLOW_GLFORMATCONVERTER_H_ */
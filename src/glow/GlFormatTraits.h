@@ -0,0 +1,305 @@
+#ifndef INCLUDE_GLOW_GLFORMATTRAITS_H_
+#define INCLUDE_GLOW_GLFORMATTRAITS_H_
+
+#include <stdint.h>
+
+#include "GlPixelFormat.h"
+#include "GlTextureFormat.h"
+#include "glutil.h"
+
+namespace glow {
+
+/** \brief pixel format for the given number of components (1-4) of normalized/float or integer data. **/
+constexpr PixelFormat pixelFormatOf(uint32_t components, bool integer) {
+  return integer ? ((components == 1) ? PixelFormat::R_INTEGER
+                                      : (components == 2) ? PixelFormat::RG_INTEGER
+                                                          : (components == 3) ? PixelFormat::RGB_INTEGER
+                                                                              : PixelFormat::RGBA_INTEGER)
+                 : ((components == 1) ? PixelFormat::R
+                                      : (components == 2) ? PixelFormat::RG
+                                                          : (components == 3) ? PixelFormat::RGB : PixelFormat::RGBA);
+}
+
+template <uint32_t C, GLenum PF, GLenum PT, GLenum SF, bool I>
+struct TextureFormatTraitsBase {
+ public:
+  static constexpr uint32_t components = C;
+  static constexpr GLenum pixelFormat = PF;  // pixel format of host data matching the internal format.
+  static constexpr GLenum pixelType = PT;    // pixel type of host data matching the internal format.
+  static constexpr GLenum sizedFormat = SF;  // sized internal format, e.g., for immutable storage.
+  static constexpr bool integer = I;         // unnormalized integer format?
+};
+
+template <uint32_t C, GLenum PF, GLenum PT, GLenum SF, bool I>
+constexpr uint32_t TextureFormatTraitsBase<C, PF, PT, SF, I>::components;
+template <uint32_t C, GLenum PF, GLenum PT, GLenum SF, bool I>
+constexpr GLenum TextureFormatTraitsBase<C, PF, PT, SF, I>::pixelFormat;
+template <uint32_t C, GLenum PF, GLenum PT, GLenum SF, bool I>
+constexpr GLenum TextureFormatTraitsBase<C, PF, PT, SF, I>::pixelType;
+template <uint32_t C, GLenum PF, GLenum PT, GLenum SF, bool I>
+constexpr GLenum TextureFormatTraitsBase<C, PF, PT, SF, I>::sizedFormat;
+template <uint32_t C, GLenum PF, GLenum PT, GLenum SF, bool I>
+constexpr bool TextureFormatTraitsBase<C, PF, PT, SF, I>::integer;
+
+/** \brief compile-time properties of a texture format.
+ *
+ *  This is the only place, where texture formats are mapped to components, pixel formats, etc.
+ *  Formats without specialization cannot be used with the traits. The pixel type of the sized formats
+ *  matches the precision of the format, e.g., GL_HALF_FLOAT for R16F, and avoids conversions on upload.
+ **/
+template <TextureFormat F>
+struct TextureFormatTraits;
+
+// clang-format off
+template <> struct TextureFormatTraits<TextureFormat::R> : TextureFormatTraitsBase<1, GL_RED, GL_UNSIGNED_BYTE, GL_R8, false> {};
+template <> struct TextureFormatTraits<TextureFormat::RG> : TextureFormatTraitsBase<2, GL_RG, GL_UNSIGNED_BYTE, GL_RG8, false> {};
+template <> struct TextureFormatTraits<TextureFormat::RGB> : TextureFormatTraitsBase<3, GL_RGB, GL_UNSIGNED_BYTE, GL_RGB8, false> {};
+template <> struct TextureFormatTraits<TextureFormat::RGBA> : TextureFormatTraitsBase<4, GL_RGBA, GL_UNSIGNED_BYTE, GL_RGBA8, false> {};
+template <> struct TextureFormatTraits<TextureFormat::R_INTEGER> : TextureFormatTraitsBase<1, GL_RED_INTEGER, GL_INT, GL_R32I, true> {};
+template <> struct TextureFormatTraits<TextureFormat::RG_INTEGER> : TextureFormatTraitsBase<2, GL_RG_INTEGER, GL_INT, GL_RG32I, true> {};
+template <> struct TextureFormatTraits<TextureFormat::RGB_INTEGER> : TextureFormatTraitsBase<3, GL_RGB_INTEGER, GL_INT, GL_RGB32I, true> {};
+template <> struct TextureFormatTraits<TextureFormat::RGBA_INTEGER> : TextureFormatTraitsBase<4, GL_RGBA_INTEGER, GL_INT, GL_RGBA32I, true> {};
+template <> struct TextureFormatTraits<TextureFormat::R_FLOAT> : TextureFormatTraitsBase<1, GL_RED, GL_FLOAT, GL_R32F, false> {};
+template <> struct TextureFormatTraits<TextureFormat::RG_FLOAT> : TextureFormatTraitsBase<2, GL_RG, GL_FLOAT, GL_RG32F, false> {};
+template <> struct TextureFormatTraits<TextureFormat::RGB_FLOAT> : TextureFormatTraitsBase<3, GL_RGB, GL_FLOAT, GL_RGB32F, false> {};
+template <> struct TextureFormatTraits<TextureFormat::RGBA_FLOAT> : TextureFormatTraitsBase<4, GL_RGBA, GL_FLOAT, GL_RGBA32F, false> {};
+template <> struct TextureFormatTraits<TextureFormat::DEPTH> : TextureFormatTraitsBase<1, GL_DEPTH_COMPONENT, GL_FLOAT, GL_DEPTH_COMPONENT24, false> {};
+template <> struct TextureFormatTraits<TextureFormat::DEPTH_STENCIL> : TextureFormatTraitsBase<2, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, GL_DEPTH24_STENCIL8, false> {};
+template <> struct TextureFormatTraits<TextureFormat::GRAY> : TextureFormatTraitsBase<1, GL_RED, GL_UNSIGNED_BYTE, GL_R8, false> {};
+template <> struct TextureFormatTraits<TextureFormat::R8> : TextureFormatTraitsBase<1, GL_RED, GL_UNSIGNED_BYTE, GL_R8, false> {};
+template <> struct TextureFormatTraits<TextureFormat::RG8> : TextureFormatTraitsBase<2, GL_RG, GL_UNSIGNED_BYTE, GL_RG8, false> {};
+template <> struct TextureFormatTraits<TextureFormat::RGB8> : TextureFormatTraitsBase<3, GL_RGB, GL_UNSIGNED_BYTE, GL_RGB8, false> {};
+template <> struct TextureFormatTraits<TextureFormat::RGBA8> : TextureFormatTraitsBase<4, GL_RGBA, GL_UNSIGNED_BYTE, GL_RGBA8, false> {};
+template <> struct TextureFormatTraits<TextureFormat::R8_SNORM> : TextureFormatTraitsBase<1, GL_RED, GL_BYTE, GL_R8_SNORM, false> {};
+template <> struct TextureFormatTraits<TextureFormat::RG8_SNORM> : TextureFormatTraitsBase<2, GL_RG, GL_BYTE, GL_RG8_SNORM, false> {};
+template <> struct TextureFormatTraits<TextureFormat::RGBA8_SNORM> : TextureFormatTraitsBase<4, GL_RGBA, GL_BYTE, GL_RGBA8_SNORM, false> {};
+template <> struct TextureFormatTraits<TextureFormat::R8UI> : TextureFormatTraitsBase<1, GL_RED_INTEGER, GL_UNSIGNED_BYTE, GL_R8UI, true> {};
+template <> struct TextureFormatTraits<TextureFormat::RG8UI> : TextureFormatTraitsBase<2, GL_RG_INTEGER, GL_UNSIGNED_BYTE, GL_RG8UI, true> {};
+template <> struct TextureFormatTraits<TextureFormat::RGBA8UI> : TextureFormatTraitsBase<4, GL_RGBA_INTEGER, GL_UNSIGNED_BYTE, GL_RGBA8UI, true> {};
+template <> struct TextureFormatTraits<TextureFormat::R8I> : TextureFormatTraitsBase<1, GL_RED_INTEGER, GL_BYTE, GL_R8I, true> {};
+template <> struct TextureFormatTraits<TextureFormat::RG8I> : TextureFormatTraitsBase<2, GL_RG_INTEGER, GL_BYTE, GL_RG8I, true> {};
+template <> struct TextureFormatTraits<TextureFormat::RGBA8I> : TextureFormatTraitsBase<4, GL_RGBA_INTEGER, GL_BYTE, GL_RGBA8I, true> {};
+template <> struct TextureFormatTraits<TextureFormat::R16> : TextureFormatTraitsBase<1, GL_RED, GL_UNSIGNED_SHORT, GL_R16, false> {};
+template <> struct TextureFormatTraits<TextureFormat::RG16> : TextureFormatTraitsBase<2, GL_RG, GL_UNSIGNED_SHORT, GL_RG16, false> {};
+template <> struct TextureFormatTraits<TextureFormat::RGB16> : TextureFormatTraitsBase<3, GL_RGB, GL_UNSIGNED_SHORT, GL_RGB16, false> {};
+template <> struct TextureFormatTraits<TextureFormat::RGBA16> : TextureFormatTraitsBase<4, GL_RGBA, GL_UNSIGNED_SHORT, GL_RGBA16, false> {};
+template <> struct TextureFormatTraits<TextureFormat::R16_SNORM> : TextureFormatTraitsBase<1, GL_RED, GL_SHORT, GL_R16_SNORM, false> {};
+template <> struct TextureFormatTraits<TextureFormat::RG16_SNORM> : TextureFormatTraitsBase<2, GL_RG, GL_SHORT, GL_RG16_SNORM, false> {};
+template <> struct TextureFormatTraits<TextureFormat::RGBA16_SNORM> : TextureFormatTraitsBase<4, GL_RGBA, GL_SHORT, GL_RGBA16_SNORM, false> {};
+template <> struct TextureFormatTraits<TextureFormat::R16UI> : TextureFormatTraitsBase<1, GL_RED_INTEGER, GL_UNSIGNED_SHORT, GL_R16UI, true> {};
+template <> struct TextureFormatTraits<TextureFormat::RG16UI> : TextureFormatTraitsBase<2, GL_RG_INTEGER, GL_UNSIGNED_SHORT, GL_RG16UI, true> {};
+template <> struct TextureFormatTraits<TextureFormat::RGBA16UI> : TextureFormatTraitsBase<4, GL_RGBA_INTEGER, GL_UNSIGNED_SHORT, GL_RGBA16UI, true> {};
+template <> struct TextureFormatTraits<TextureFormat::R16I> : TextureFormatTraitsBase<1, GL_RED_INTEGER, GL_SHORT, GL_R16I, true> {};
+template <> struct TextureFormatTraits<TextureFormat::RG16I> : TextureFormatTraitsBase<2, GL_RG_INTEGER, GL_SHORT, GL_RG16I, true> {};
+template <> struct TextureFormatTraits<TextureFormat::RGBA16I> : TextureFormatTraitsBase<4, GL_RGBA_INTEGER, GL_SHORT, GL_RGBA16I, true> {};
+template <> struct TextureFormatTraits<TextureFormat::R16F> : TextureFormatTraitsBase<1, GL_RED, GL_HALF_FLOAT, GL_R16F, false> {};
+template <> struct TextureFormatTraits<TextureFormat::RG16F> : TextureFormatTraitsBase<2, GL_RG, GL_HALF_FLOAT, GL_RG16F, false> {};
+template <> struct TextureFormatTraits<TextureFormat::RGB16F> : TextureFormatTraitsBase<3, GL_RGB, GL_HALF_FLOAT, GL_RGB16F, false> {};
+template <> struct TextureFormatTraits<TextureFormat::RGBA16F> : TextureFormatTraitsBase<4, GL_RGBA, GL_HALF_FLOAT, GL_RGBA16F, false> {};
+template <> struct TextureFormatTraits<TextureFormat::DEPTH16> : TextureFormatTraitsBase<1, GL_DEPTH_COMPONENT, GL_UNSIGNED_SHORT, GL_DEPTH_COMPONENT16, false> {};
+template <> struct TextureFormatTraits<TextureFormat::DEPTH24> : TextureFormatTraitsBase<1, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, GL_DEPTH_COMPONENT24, false> {};
+template <> struct TextureFormatTraits<TextureFormat::DEPTH32F> : TextureFormatTraitsBase<1, GL_DEPTH_COMPONENT, GL_FLOAT, GL_DEPTH_COMPONENT32F, false> {};
+// clang-format on
+
+/** \brief properties of a texture format, which is only known at runtime. **/
+struct TextureFormatInfo {
+ public:
+  uint32_t components;
+  GLenum pixelFormat;
+  GLenum pixelType;
+  GLenum sizedFormat;
+  bool integer;
+};
+
+/** \brief pixel format of host data with given number of components for a texture with given properties.
+ *
+ *  In contrast to color formats, depth values can only be transferred with PixelFormat::DEPTH.
+ **/
+inline PixelFormat pixelFormatOf(const TextureFormatInfo& info, uint32_t components) {
+  if (info.pixelFormat == GL_DEPTH_COMPONENT || info.pixelFormat == GL_DEPTH_STENCIL) {
+    return static_cast<PixelFormat>(info.pixelFormat);
+  }
+
+  return pixelFormatOf(components, info.integer);
+}
+
+/** \brief bytes of a texel in the host data of the texture format, i.e., components times size of the pixel type. **/
+inline uint32_t texelSize(const TextureFormatInfo& info) {
+  // depth and stencil values are packed into a single 32-bit value.
+  if (info.pixelType == GL_UNSIGNED_INT_24_8) return 4;
+
+  return info.components * pixelTypeSize(static_cast<PixelType>(info.pixelType));
+}
+
+template <TextureFormat F>
+constexpr TextureFormatInfo textureFormatInfo() {
+  typedef TextureFormatTraits<F> Traits;
+  return TextureFormatInfo{Traits::components, Traits::pixelFormat, Traits::pixelType, Traits::sizedFormat,
+                           Traits::integer};
+}
+
+/** \brief look up the properties of a texture format given at runtime. **/
+inline TextureFormatInfo textureFormatInfo(TextureFormat format) {
+  switch (format) {
+    case TextureFormat::R:
+      return textureFormatInfo<TextureFormat::R>();
+    case TextureFormat::RG:
+      return textureFormatInfo<TextureFormat::RG>();
+    case TextureFormat::RGB:
+      return textureFormatInfo<TextureFormat::RGB>();
+    case TextureFormat::RGBA:
+      return textureFormatInfo<TextureFormat::RGBA>();
+    case TextureFormat::R_INTEGER:
+      return textureFormatInfo<TextureFormat::R_INTEGER>();
+    case TextureFormat::RG_INTEGER:
+      return textureFormatInfo<TextureFormat::RG_INTEGER>();
+    case TextureFormat::RGB_INTEGER:
+      return textureFormatInfo<TextureFormat::RGB_INTEGER>();
+    case TextureFormat::RGBA_INTEGER:
+      return textureFormatInfo<TextureFormat::RGBA_INTEGER>();
+    case TextureFormat::R_FLOAT:
+      return textureFormatInfo<TextureFormat::R_FLOAT>();
+    case TextureFormat::RG_FLOAT:
+      return textureFormatInfo<TextureFormat::RG_FLOAT>();
+    case TextureFormat::RGB_FLOAT:
+      return textureFormatInfo<TextureFormat::RGB_FLOAT>();
+    case TextureFormat::RGBA_FLOAT:
+      return textureFormatInfo<TextureFormat::RGBA_FLOAT>();
+    case TextureFormat::DEPTH:
+      return textureFormatInfo<TextureFormat::DEPTH>();
+    case TextureFormat::DEPTH_STENCIL:
+      return textureFormatInfo<TextureFormat::DEPTH_STENCIL>();
+    case TextureFormat::GRAY:
+      return textureFormatInfo<TextureFormat::GRAY>();
+    case TextureFormat::R8:
+      return textureFormatInfo<TextureFormat::R8>();
+    case TextureFormat::RG8:
+      return textureFormatInfo<TextureFormat::RG8>();
+    case TextureFormat::RGB8:
+      return textureFormatInfo<TextureFormat::RGB8>();
+    case TextureFormat::RGBA8:
+      return textureFormatInfo<TextureFormat::RGBA8>();
+    case TextureFormat::R8_SNORM:
+      return textureFormatInfo<TextureFormat::R8_SNORM>();
+    case TextureFormat::RG8_SNORM:
+      return textureFormatInfo<TextureFormat::RG8_SNORM>();
+    case TextureFormat::RGBA8_SNORM:
+      return textureFormatInfo<TextureFormat::RGBA8_SNORM>();
+    case TextureFormat::R8UI:
+      return textureFormatInfo<TextureFormat::R8UI>();
+    case TextureFormat::RG8UI:
+      return textureFormatInfo<TextureFormat::RG8UI>();
+    case TextureFormat::RGBA8UI:
+      return textureFormatInfo<TextureFormat::RGBA8UI>();
+    case TextureFormat::R8I:
+      return textureFormatInfo<TextureFormat::R8I>();
+    case TextureFormat::RG8I:
+      return textureFormatInfo<TextureFormat::RG8I>();
+    case TextureFormat::RGBA8I:
+      return textureFormatInfo<TextureFormat::RGBA8I>();
+    case TextureFormat::R16:
+      return textureFormatInfo<TextureFormat::R16>();
+    case TextureFormat::RG16:
+      return textureFormatInfo<TextureFormat::RG16>();
+    case TextureFormat::RGB16:
+      return textureFormatInfo<TextureFormat::RGB16>();
+    case TextureFormat::RGBA16:
+      return textureFormatInfo<TextureFormat::RGBA16>();
+    case TextureFormat::R16_SNORM:
+      return textureFormatInfo<TextureFormat::R16_SNORM>();
+    case TextureFormat::RG16_SNORM:
+      return textureFormatInfo<TextureFormat::RG16_SNORM>();
+    case TextureFormat::RGBA16_SNORM:
+      return textureFormatInfo<TextureFormat::RGBA16_SNORM>();
+    case TextureFormat::R16UI:
+      return textureFormatInfo<TextureFormat::R16UI>();
+    case TextureFormat::RG16UI:
+      return textureFormatInfo<TextureFormat::RG16UI>();
+    case TextureFormat::RGBA16UI:
+      return textureFormatInfo<TextureFormat::RGBA16UI>();
+    case TextureFormat::R16I:
+      return textureFormatInfo<TextureFormat::R16I>();
+    case TextureFormat::RG16I:
+      return textureFormatInfo<TextureFormat::RG16I>();
+    case TextureFormat::RGBA16I:
+      return textureFormatInfo<TextureFormat::RGBA16I>();
+    case TextureFormat::R16F:
+      return textureFormatInfo<TextureFormat::R16F>();
+    case TextureFormat::RG16F:
+      return textureFormatInfo<TextureFormat::RG16F>();
+    case TextureFormat::RGB16F:
+      return textureFormatInfo<TextureFormat::RGB16F>();
+    case TextureFormat::RGBA16F:
+      return textureFormatInfo<TextureFormat::RGBA16F>();
+    case TextureFormat::DEPTH16:
+      return textureFormatInfo<TextureFormat::DEPTH16>();
+    case TextureFormat::DEPTH24:
+      return textureFormatInfo<TextureFormat::DEPTH24>();
+    case TextureFormat::DEPTH32F:
+      return textureFormatInfo<TextureFormat::DEPTH32F>();
+  }
+
+  return textureFormatInfo<TextureFormat::RGBA>();
+}
+
+template <PixelType P, uint32_t C>
+struct PixelTypeOfBase {
+ public:
+  static constexpr PixelType type = P;
+  static constexpr uint32_t components = C;  // components of a single element.
+};
+
+template <PixelType P, uint32_t C>
+constexpr PixelType PixelTypeOfBase<P, C>::type;
+template <PixelType P, uint32_t C>
+constexpr uint32_t PixelTypeOfBase<P, C>::components;
+
+/** \brief pixel type and components of host data with elements of type T.
+ *
+ *  Element types without specialization do not compile, e.g., download(PixelFormat::R, double_ptr).
+ **/
+template <typename T>
+struct PixelTypeOf;
+
+template <typename T>
+struct PixelTypeOf<const T> : PixelTypeOf<T> {};
+
+// clang-format off
+template <> struct PixelTypeOf<uint8_t> : PixelTypeOfBase<PixelType::UNSIGNED_BYTE, 1> {};
+template <> struct PixelTypeOf<int8_t> : PixelTypeOfBase<PixelType::BYTE, 1> {};
+template <> struct PixelTypeOf<uint16_t> : PixelTypeOfBase<PixelType::UNSIGNED_SHORT, 1> {};
+template <> struct PixelTypeOf<int16_t> : PixelTypeOfBase<PixelType::SHORT, 1> {};
+template <> struct PixelTypeOf<uint32_t> : PixelTypeOfBase<PixelType::UNSIGNED_INT, 1> {};
+template <> struct PixelTypeOf<int32_t> : PixelTypeOfBase<PixelType::INT, 1> {};
+template <> struct PixelTypeOf<float> : PixelTypeOfBase<PixelType::FLOAT, 1> {};
+template <> struct PixelTypeOf<vec2> : PixelTypeOfBase<PixelType::FLOAT, 2> {};
+template <> struct PixelTypeOf<vec3> : PixelTypeOfBase<PixelType::FLOAT, 3> {};
+template <> struct PixelTypeOf<vec4> : PixelTypeOfBase<PixelType::FLOAT, 4> {};
+template <> struct PixelTypeOf<Eigen::Vector2f> : PixelTypeOfBase<PixelType::FLOAT, 2> {};
+template <> struct PixelTypeOf<Eigen::Vector3f> : PixelTypeOfBase<PixelType::FLOAT, 3> {};
+template <> struct PixelTypeOf<Eigen::Vector4f> : PixelTypeOfBase<PixelType::FLOAT, 4> {};
+// clang-format on
+
+/** \brief check if host data with elements of type T can be transferred with given pixel type.
+ *
+ *  Untyped data (void) matches every pixel type; 16-bit values can also be half floats.
+ **/
+template <typename T>
+inline bool pixelTypeMatches(PixelType type) {
+  return PixelTypeOf<T>::type == type ||
+         (PixelTypeOf<T>::type == PixelType::UNSIGNED_SHORT && type == PixelType::HALF_FLOAT);
+}
+
+template <>
+inline bool pixelTypeMatches<void>(PixelType) {
+  return true;
+}
+
+template <>
+inline bool pixelTypeMatches<const void>(PixelType) {
+  return true;
+}
+
+} /* namespace glow */
+
+#endif /* INCLUDE_GLOW_GLFORMATTRAITS_H_ */
@@ -6,8 +6,10 @@
  */
 
 #include "GlFramebuffer.h"
+#include "GlStateGuard.h"
 #include "glexception.h"
 
+#include <set>
 #include <sstream>
 
 namespace glow {
@@ -17,8 +19,10 @@ GLuint GlFramebuffer::boundFramebuffer_ = 0;
 GlFramebuffer::GlFramebuffer(uint32_t width, uint32_t height, FramebufferTarget target)
     : target_(static_cast<GLenum>(target)), width_(width), height_(height) {
   glGenFramebuffers(1, &id_);
+  GLOW_STATS_CREATED(FRAMEBUFFER);
   ptr_ = std::shared_ptr<GLuint>(new GLuint(id_), [](GLuint* ptr) {
     glDeleteFramebuffers(1, ptr);
+    GLOW_STATS_DESTROYED(FRAMEBUFFER);
     delete ptr;
   });
 
@@ -51,7 +55,8 @@ inline std::string error_string(GLint id) {
 }
 
 void GlFramebuffer::bind() {
-  if (!valid_) {
+  reattach();
+  if (!valid()) {
     std::stringstream reason;
     reason << "Invalid framebuffer object. Code ";
     glBindFramebuffer(target_, id_);
@@ -63,52 +68,51 @@ void GlFramebuffer::bind() {
 
   boundFramebuffer_ = id_;
   glBindFramebuffer(target_, id_);
+  GLOW_STATS_CALL(BIND_FRAMEBUFFER);
 }
 
 void GlFramebuffer::release() {
   boundFramebuffer_ = 0;
   glBindFramebuffer(target_, 0);
+  GLOW_STATS_CALL(BIND_FRAMEBUFFER);
 }
 
-GLuint GlFramebuffer::bindTransparently() {
+GLuint GlFramebuffer::bindTransparently() const {
   glBindFramebuffer(target_, id_);
+  GLOW_STATS_CALL(BIND_FRAMEBUFFER);
 
   return boundFramebuffer_;
 }
 
-void GlFramebuffer::releaseTransparently(GLuint old_id) {
+void GlFramebuffer::releaseTransparently(GLuint old_id) const {
   glBindFramebuffer(target_, old_id);
+  GLOW_STATS_CALL(BIND_FRAMEBUFFER);
 }
 
 void GlFramebuffer::attach(FramebufferAttachment target, GlTexture& texture) {
-  if (texture.target_ != GL_TEXTURE_2D) throw GlFramebufferError("Expected two-dimensional texture");
-  if (texture.width() < width_) {
-    std::stringstream error;
-    error << "Texture's width should be at least " << width_;
-    throw GlFramebufferError(error.str());
+  if (texture.target_ != GL_TEXTURE_2D && texture.target_ != GL_TEXTURE_RECTANGLE &&
+      texture.target_ != GL_TEXTURE_2D_MULTISAMPLE) {
+    throw GlFramebufferError("Expected two-dimensional texture");
   }
+  attachTexture(target, texture, false, 0);
+}
 
-  if (texture.height() < height_) {
+void GlFramebuffer::attachLayered(FramebufferAttachment target, GlTexture& texture) {
+  if (texture.depth() == 0) throw GlFramebufferError("Expected 2D array or three-dimensional texture");
+  attachTexture(target, texture, true, 0);
+}
+
+void GlFramebuffer::attachLayer(FramebufferAttachment target, GlTexture& texture, uint32_t layer) {
+  if (texture.depth() == 0) throw GlFramebufferError("Expected 2D array or three-dimensional texture");
+  if (layer >= texture.depth()) {
     std::stringstream error;
-    error << "Texture's height should be at least " << height_;
+    error << "Layer " << layer << " exceeds the " << texture.depth() << " layers of the texture";
     throw GlFramebufferError(error.str());
   }
-
-  GLuint old_buffer = bindTransparently();
-
-  glFramebufferTexture2D(target_, static_cast<GLenum>(target), texture.target_, texture.id(), 0);
-
-  attachments_[target] = texture.ptr_;  // get pointer to prevent deallocation before framebuffer is deallocated.
-  valid_ = (glCheckFramebufferStatus(target_) == GL_FRAMEBUFFER_COMPLETE);
-
-  releaseTransparently(old_buffer);
+  attachTexture(target, texture, false, layer);
 }
 
-/** \brief attach rectangular texture to given target.
- *
- *  The texture must have at least the width and height of the framebuffer object.
- **/
-void GlFramebuffer::attach(FramebufferAttachment target, GlTextureRectangle& texture) {
+void GlFramebuffer::attachTexture(FramebufferAttachment target, GlTexture& texture, bool layered, uint32_t layer) {
   if (texture.width() < width_) {
     std::stringstream error;
     error << "Texture's width should be at least " << width_;
@@ -123,10 +127,21 @@ void GlFramebuffer::attach(FramebufferAttachment target, GlTextureRectangle& tex
 
   GLuint old_buffer = bindTransparently();
 
-  glFramebufferTexture2D(target_, static_cast<GLenum>(target), GL_TEXTURE_RECTANGLE, texture.id(), 0);
-
-  attachments_[target] = texture.ptr_;  // get pointer to prevent deallocation before framebuffer is deallocated.
-  valid_ = (glCheckFramebufferStatus(target_) == GL_FRAMEBUFFER_COMPLETE);
+  Attachment attachment;
+  // a copy shares the texture object; thus, the texture is not deleted before the framebuffer. Attachments
+  // of the same texture share the copy, which is therefore resized only once.
+  for (auto& entry : attachments_) {
+    if (entry.second.texture != nullptr && entry.second.texture->id() == texture.id()) {
+      *entry.second.texture = texture;
+      attachment.texture = entry.second.texture;
+    }
+  }
+  if (attachment.texture == nullptr) attachment.texture = std::make_shared<GlTexture>(texture);
+  attachment.layered = layered;
+  attachment.layer = layer;
+  attachTexture(static_cast<GLenum>(target), attachment);
+  attachments_[target] = attachment;
+  checked_ = false;  // completeness is checked once with the next valid() or bind().
 
   releaseTransparently(old_buffer);
 }
@@ -148,16 +163,143 @@ void GlFramebuffer::attach(FramebufferAttachment target, GlRenderbuffer& buffer)
 
   glFramebufferRenderbuffer(target_, static_cast<GLenum>(target), GL_RENDERBUFFER, buffer.id());
 
-  attachments_[target] = buffer.ptr_;  // get pointer to prevent deallocation before framebuffer is deallocated.
-  valid_ = (glCheckFramebufferStatus(target_) == GL_FRAMEBUFFER_COMPLETE);
+  Attachment attachment;
+  attachment.renderbuffer = std::make_shared<GlRenderbuffer>(buffer);
+  attachments_[target] = attachment;
+  checked_ = false;  // completeness is checked once with the next valid() or bind().
 
   releaseTransparently(old_buffer);
 }
 
+void GlFramebuffer::attachTexture(GLenum target, Attachment& attachment) {
+  const GlTexture& texture = *attachment.texture;
+  if (attachment.layered) {
+    glFramebufferTexture(target_, target, texture.id(), 0);
+  } else if (texture.depth() > 0) {
+    glFramebufferTextureLayer(target_, target, texture.id(), 0, attachment.layer);
+  } else {
+    glFramebufferTexture2D(target_, target, texture.target_, texture.id(), 0);
+  }
+  attachment.id = texture.id();
+}
+
+void GlFramebuffer::reattach() {
+  GLuint old_buffer = 0;
+  bool bound = false;
+  for (auto& entry : attachments_) {
+    Attachment& attachment = entry.second;
+    if (attachment.texture == nullptr || attachment.texture->id() == attachment.id) continue;
+
+    if (!bound) old_buffer = bindTransparently();
+    bound = true;
+    attachTexture(static_cast<GLenum>(entry.first), attachment);
+    GLOW_STATS_CALL(STATE);
+    checked_ = false;
+  }
+  if (bound) releaseTransparently(old_buffer);
+}
+
+void GlFramebuffer::resolveTo(GlFramebuffer& dst, GLbitfield mask, TexMagOp filter) {
+  if (!valid() || !dst.valid()) throw GlFramebufferError("Unable to resolve: invalid framebuffer object.");
+  if (filter == TexMagOp::LINEAR && (mask & (GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT)) != 0) {
+    throw GlFramebufferError("Unable to resolve: depth and stencil values must be copied with NEAREST filter.");
+  }
+
+  // the scissor test also applies to glBlitFramebuffer.
+  GlStateGuard guard(GlStateCategory::FRAMEBUFFER | GlStateCategory::SCISSOR);
+  guard.setScissorTest(false);
+  guard.bindFramebuffer(GL_READ_FRAMEBUFFER, id_);
+  guard.bindFramebuffer(GL_DRAW_FRAMEBUFFER, dst.id_);
+
+  glBlitFramebuffer(0, 0, width_, height_, 0, 0, dst.width_, dst.height_, mask, static_cast<GLenum>(filter));
+  GLOW_STATS_CALL(COPY);
+
+  CheckGlError();
+}
+
 bool GlFramebuffer::valid() const {
+  if (!checked_) {
+    GLuint old_buffer = bindTransparently();
+    valid_ = (glCheckFramebufferStatus(target_) == GL_FRAMEBUFFER_COMPLETE);
+    GLOW_STATS_CALL(STATE);
+    releaseTransparently(old_buffer);
+    checked_ = true;
+  }
+
   return valid_;
 }
 
+void GlFramebuffer::setDrawBuffers(const std::vector<FramebufferAttachment>& buffers) {
+  std::vector<GLenum> ids(buffers.size());
+  for (uint32_t i = 0; i < buffers.size(); ++i) ids[i] = static_cast<GLenum>(buffers[i]);
+
+  // the draw buffers are state of the framebuffer object; thus, they are only set once.
+  GLuint old_buffer = bindTransparently();
+  glDrawBuffers(ids.size(), ids.data());
+  GLOW_STATS_CALL(STATE);
+  releaseTransparently(old_buffer);
+  checked_ = false;
+
+  CheckGlError();
+}
+
+void GlFramebuffer::invalidate(const std::vector<FramebufferAttachment>& attachments) {
+#if __GL_VERSION >= 430L
+  std::vector<GLenum> ids(attachments.size());
+  for (uint32_t i = 0; i < attachments.size(); ++i) ids[i] = static_cast<GLenum>(attachments[i]);
+
+  GLuint old_buffer = bindTransparently();
+  glInvalidateFramebuffer(target_, ids.size(), ids.data());
+  GLOW_STATS_CALL(STATE);
+  releaseTransparently(old_buffer);
+
+  CheckGlError();
+#endif
+}
+
+void GlFramebuffer::clearColor(uint32_t drawBuffer, const vec4& color) {
+  const GLfloat values[] = {color.x, color.y, color.z, color.w};
+  GLuint old_buffer = bindTransparently();
+  glClearBufferfv(GL_COLOR, drawBuffer, values);
+  GLOW_STATS_CALL(DRAW);
+  releaseTransparently(old_buffer);
+}
+
+void GlFramebuffer::clearColor(uint32_t drawBuffer, const int32_t color[4]) {
+  GLuint old_buffer = bindTransparently();
+  glClearBufferiv(GL_COLOR, drawBuffer, color);
+  GLOW_STATS_CALL(DRAW);
+  releaseTransparently(old_buffer);
+}
+
+void GlFramebuffer::clearColor(uint32_t drawBuffer, const uint32_t color[4]) {
+  GLuint old_buffer = bindTransparently();
+  glClearBufferuiv(GL_COLOR, drawBuffer, color);
+  GLOW_STATS_CALL(DRAW);
+  releaseTransparently(old_buffer);
+}
+
+void GlFramebuffer::clearDepth(float depth) {
+  GLuint old_buffer = bindTransparently();
+  glClearBufferfv(GL_DEPTH, 0, &depth);
+  GLOW_STATS_CALL(DRAW);
+  releaseTransparently(old_buffer);
+}
+
+void GlFramebuffer::clearStencil(int32_t stencil) {
+  GLuint old_buffer = bindTransparently();
+  glClearBufferiv(GL_STENCIL, 0, &stencil);
+  GLOW_STATS_CALL(DRAW);
+  releaseTransparently(old_buffer);
+}
+
+void GlFramebuffer::clearDepthStencil(float depth, int32_t stencil) {
+  GLuint old_buffer = bindTransparently();
+  glClearBufferfi(GL_DEPTH_STENCIL, 0, depth, stencil);
+  GLOW_STATS_CALL(DRAW);
+  releaseTransparently(old_buffer);
+}
+
 uint32_t GlFramebuffer::width() const {
   return width_;
 }
@@ -166,10 +308,73 @@ uint32_t GlFramebuffer::height() const {
   return height_;
 }
 
-void GlFramebuffer::resize(uint32_t width, uint32_t height) {
-  valid_ = false;
+void GlFramebuffer::resize(uint32_t width, uint32_t height, TexResizeMode mode) {
+  if (cached_) throw GlFramebufferError("Cached framebuffer cannot be resized; get one of the new size instead.");
+
   width_ = width;
   height_ = height;
+
+  // resize first, since copies of preserved content might change the bound framebuffer.
+  std::set<const GlTexture*> resized;  // textures attached to multiple attachment points.
+  for (auto& entry : attachments_) {
+    Attachment& attachment = entry.second;
+    if (attachment.texture != nullptr && resized.insert(attachment.texture.get()).second) {
+      // textures with layers keep their number of layers.
+      if (attachment.texture->depth() > 0) {
+        attachment.texture->resize(width, height, attachment.texture->depth(), mode);
+      } else {
+        attachment.texture->resize(width, height, mode);
+      }
+    }
+    if (attachment.renderbuffer != nullptr) attachment.renderbuffer->resize(width, height);
+  }
+
+  GLuint old_buffer = bindTransparently();
+
+  for (auto& entry : attachments_) {
+    GLenum target = static_cast<GLenum>(entry.first);
+    Attachment& attachment = entry.second;
+
+    if (attachment.texture != nullptr) {
+      attachTexture(target, attachment);
+    } else if (attachment.renderbuffer != nullptr) {
+      glFramebufferRenderbuffer(target_, target, GL_RENDERBUFFER, attachment.renderbuffer->id());
+    }
+    GLOW_STATS_CALL(STATE);
+  }
+
+  checked_ = false;
+
+  releaseTransparently(old_buffer);
+}
+
+bool GlFramebuffer::orphaned() const {
+  for (const auto& entry : attachments_) {
+    const Attachment& attachment = entry.second;
+    if (attachment.texture != nullptr && attachment.texture->storage_.unique()) return true;
+    if (attachment.texture != nullptr && attachment.texture->id() != attachment.id) return true;
+    if (attachment.renderbuffer != nullptr && attachment.renderbuffer->storage_.unique()) return true;
+  }
+
+  return false;
+}
+
+GlTexture GlFramebuffer::texture(FramebufferAttachment target) const {
+  auto it = attachments_.find(target);
+  if (it == attachments_.end() || it->second.texture == nullptr) {
+    throw GlFramebufferError("No texture attached to the attachment point.");
+  }
+
+  return *it->second.texture;
+}
+
+GlRenderbuffer GlFramebuffer::renderbuffer(FramebufferAttachment target) const {
+  auto it = attachments_.find(target);
+  if (it == attachments_.end() || it->second.renderbuffer == nullptr) {
+    throw GlFramebufferError("No renderbuffer attached to the attachment point.");
+  }
+
+  return *it->second.renderbuffer;
 }
 
 } /* namespace rv */
@@ -2,9 +2,11 @@
 #define INCLUDE_RV_GLFRAMEBUFFER_H_
 
 #include <map>
+#include <vector>
 #include "GlTexture.h"
 #include "GlTextureRectangle.h"
 #include "GlRenderbuffer.h"
+#include "glutil.h"
 
 namespace glow {
 
@@ -18,10 +20,11 @@ enum class FramebufferAttachment {
   COLOR4 = GL_COLOR_ATTACHMENT4,
   COLOR5 = GL_COLOR_ATTACHMENT5,
   COLOR6 = GL_COLOR_ATTACHMENT6,
-  // TODO: remaining color attachments,
+  COLOR7 = GL_COLOR_ATTACHMENT7,  // at least 8 color attachments are supported.
   DEPTH = GL_DEPTH_ATTACHMENT,
   STENCIL = GL_STENCIL_ATTACHMENT,
-  DEPTH_STENCIL = GL_DEPTH_STENCIL_ATTACHMENT
+  DEPTH_STENCIL = GL_DEPTH_STENCIL_ATTACHMENT,
+  NONE = GL_NONE  // disabled draw buffer (see GlFramebuffer::setDrawBuffers).
 };
 
 /** \brief Representation of an OpenGL's framebuffer object
@@ -32,13 +35,19 @@ enum class FramebufferAttachment {
  *  a GlRenderbuffer or a Texture must be made. You can check with the valid method if everything needed is
  *  present.
  *
- *  TODO: integrate glDrawBuffers: attach automatically enables the buffers?
- *  different mapping or deactivating buffers must be set explicitly? map(), enable()?
+ *  The completeness of the framebuffer is only checked once after the attachments changed, i.e., by the
+ *  next call of valid() or bind(). For rendering into multiple color attachments, the draw buffers
+ *  must be set explicitly by setDrawBuffers(); by default, only COLOR0 is written.
+ *
+ *  \see GlFramebufferCache
  *
  *  \author behley
  */
 class GlFramebuffer : public GlObject {
  public:
+  friend class GlStateGuard;
+  friend class GlFramebufferCache;
+
   /** \brief initialize an empty framebuffer object with given size (width x height) without any attachments. **/
   GlFramebuffer(uint32_t width, uint32_t height, FramebufferTarget target = FramebufferTarget::BOTH);
 
@@ -60,15 +69,49 @@ class GlFramebuffer : public GlObject {
 
   /** \brief attach texture to given target.
    *
-   *  The texture must have at least the width and height of the framebuffer object.
+   *  The texture must be two-dimensional, rectangular, or a multisample texture (see GlTexture::multisample2D)
+   *  and have at least the width and height of the framebuffer object.
+   *
+   *  \throws GlFramebufferError if the texture has another target or is too small.
    **/
   void attach(FramebufferAttachment target, GlTexture& texture);
 
-  /** \brief attach rectangular texture to given target.
+  /** \brief attach a GlTexture2D or GlTextureRectangle to given target.
+   *
+   *  In contrast to attach(target, GlTexture&), the target of the texture is checked at compile time, i.e.,
+   *  a GlTexture1D, GlTexture3D, or GlTexture2DArray cannot be attached as a whole.
+   **/
+  template <GLenum Target>
+  void attach(FramebufferAttachment target, GlTypedTexture<Target>& texture) {
+    static_assert(TextureTargetTraits<Target>::dimensions == 2,
+                  "Only two-dimensional textures can be attached; use attachLayer or attachLayered instead.");
+    attachTexture(target, texture, false, 0);
+  }
+
+  /** \brief attach all layers of a 2D array texture (or all slices of a 3D texture) to given target.
    *
-   *  The texture must have at least the width and height of the framebuffer object.
+   *  Rendering into a layered framebuffer needs a geometry shader, which selects the layer of every
+   *  primitive by gl_Layer; primitives without gl_Layer are rendered into layer 0. Thus, N images can be
+   *  processed by a single (instanced) draw call. All attachments must be layered.
    **/
-  void attach(FramebufferAttachment target, GlTextureRectangle& texture);
+  void attachLayered(FramebufferAttachment target, GlTexture& texture);
+
+  /** \brief attach all layers of a GlTexture3D or GlTexture2DArray, where the target is checked at compile time. **/
+  template <GLenum Target>
+  void attachLayered(FramebufferAttachment target, GlTypedTexture<Target>& texture) {
+    static_assert(TextureTargetTraits<Target>::dimensions == 3, "Only textures with layers can be attached layered.");
+    attachTexture(target, texture, true, 0);
+  }
+
+  /** \brief attach a single layer of a 2D array texture (or slice of a 3D texture) to given target. **/
+  void attachLayer(FramebufferAttachment target, GlTexture& texture, uint32_t layer);
+
+  /** \brief attach a single layer of a GlTexture3D or GlTexture2DArray; the target is checked at compile time. **/
+  template <GLenum Target>
+  void attachLayer(FramebufferAttachment target, GlTypedTexture<Target>& texture, uint32_t layer) {
+    static_assert(TextureTargetTraits<Target>::dimensions == 3, "Only textures with layers have single layers.");
+    attachLayer(target, static_cast<GlTexture&>(texture), layer);
+  }
 
   /** \brief attach renderbuffer object to given target.
    *
@@ -76,33 +119,121 @@ class GlFramebuffer : public GlObject {
    */
   void attach(FramebufferAttachment target, GlRenderbuffer& buffer);
 
+  /** \brief copy the buffers given by mask to the framebuffer dst by glBlitFramebuffer.
+   *
+   *  Resolves multisample attachments, i.e., the samples of every pixel are averaged. For a resolve,
+   *  both framebuffers must have the same size; otherwise, the content is scaled with the given filter.
+   *  Depth and stencil values can only be copied with TexMagOp::NEAREST. The copy does not wait for the GPU
+   *  and the bound framebuffers are restored afterwards.
+   *
+   *  \param mask    bitwise or of GL_COLOR_BUFFER_BIT, GL_DEPTH_BUFFER_BIT, and GL_STENCIL_BUFFER_BIT.
+   *  \throws GlFramebufferError if one of the framebuffers is invalid or depth/stencil is filtered linearly.
+   **/
+  void resolveTo(GlFramebuffer& dst, GLbitfield mask = GL_COLOR_BUFFER_BIT, TexMagOp filter = TexMagOp::NEAREST);
+
   /** \brief is Framebuffer object valid?
    *
-   * Check if all needed targets are attached.
+   * Check if all needed targets are attached. The completeness is only checked again, if the attachments
+   * changed since the last check.
    * \return false if something is missing; true, otherwise.
    */
   bool valid() const;
 
+  /** \brief set the color attachments written by fragment shader outputs 0, 1, ... (glDrawBuffers).
+   *
+   *  The draw buffers are state of the framebuffer object and must be set only once, e.g., COLOR0 and
+   *  COLOR1 for a shader with two outputs. Unused outputs can be disabled by NONE.
+   **/
+  void setDrawBuffers(const std::vector<FramebufferAttachment>& buffers);
+
+  /** \brief hint that the content of the given attachments is not needed anymore (OpenGL 4.3).
+   *
+   *  At the end of a pass, e.g., transient depth buffers do not have to be written back to memory.
+   *  Without OpenGL 4.3, nothing happens.
+   **/
+  void invalidate(const std::vector<FramebufferAttachment>& attachments);
+
+  /** \brief clear the attachment of the given draw buffer (see setDrawBuffers) with float values.
+   *
+   *  In contrast to glClear, only a single attachment is cleared and integer attachments are cleared
+   *  with integer values. The clear respects scissor test and write masks.
+   **/
+  void clearColor(uint32_t drawBuffer, const vec4& color);
+  /** \brief clear the signed integer attachment of the given draw buffer. **/
+  void clearColor(uint32_t drawBuffer, const int32_t color[4]);
+  /** \brief clear the unsigned integer attachment of the given draw buffer. **/
+  void clearColor(uint32_t drawBuffer, const uint32_t color[4]);
+  /** \brief clear the depth attachment. **/
+  void clearDepth(float depth = 1.0f);
+  /** \brief clear the stencil attachment. **/
+  void clearStencil(int32_t stencil = 0);
+  /** \brief clear the depth and stencil attachment. **/
+  void clearDepthStencil(float depth = 1.0f, int32_t stencil = 0);
+
   /** \brief get framebuffer width **/
   uint32_t width() const;
 
   /** \brief get framebuffer height **/
   uint32_t height() const;
 
-  /** \brief resize the framebuffer and invalidate. **/
-  void resize(uint32_t width, uint32_t height);
+  /** \brief resize the framebuffer and all its attachments.
+   *
+   *  The framebuffer keeps its own copies of the attached GlTexture and GlRenderbuffer objects, which share
+   *  the texture and renderbuffer objects. Thus, the attached objects may be destroyed after attach().
+   *  The copies are reallocated with the new size and attached again; afterwards, the framebuffer is
+   *  validated again. Since all copies share size and texture object, the attached objects of the caller
+   *  get the new size as well, i.e., they can be used directly after resize().
+   *
+   *  \param mode  content of textures after resize; renderbuffers always lose their content.
+   *  \throws GlFramebufferError if the framebuffer is owned by a GlFramebufferCache.
+   **/
+  void resize(uint32_t width, uint32_t height, TexResizeMode mode = TexResizeMode::DISCARD);
+
+  /** \brief texture attached to the given attachment point, e.g., after resize().
+   *
+   *  \throws GlFramebufferError if no texture is attached to the attachment point.
+   **/
+  GlTexture texture(FramebufferAttachment target) const;
+
+  /** \brief renderbuffer attached to the given attachment point, e.g., after resize().
+   *
+   *  \throws GlFramebufferError if no renderbuffer is attached to the attachment point.
+   **/
+  GlRenderbuffer renderbuffer(FramebufferAttachment target) const;
 
  protected:
-  GLuint bindTransparently();
-  void releaseTransparently(GLuint old_id);
+  GLuint bindTransparently() const;
+  void releaseTransparently(GLuint old_id) const;
 
   static GLuint boundFramebuffer_;
 
   GLenum target_;
-  bool valid_{false};
+  mutable bool valid_{false};
+  mutable bool checked_{true};  // is valid_ up to date?
+  bool cached_{false};           // owned by a GlFramebufferCache, whose key contains the size?
   uint32_t width_, height_;
-  // hold pointers to ensure that resources are not deleted.
-  std::map<FramebufferAttachment, std::shared_ptr<GLuint> > attachments_;
+
+  struct Attachment {
+   public:
+    // copies of the attached objects, which keep the resources alive and are resized by resize().
+    std::shared_ptr<GlTexture> texture;
+    std::shared_ptr<GlRenderbuffer> renderbuffer;
+    bool layered{false};  // all layers of the texture attached?
+    uint32_t layer{0};    // attached layer of a texture with layers, if not layered.
+    GLuint id{0};         // attached texture object, which is replaced by a resize of immutable storage.
+  };
+
+  /** \brief check size of texture and attach it, where the texture must be bound. **/
+  void attachTexture(FramebufferAttachment target, GlTexture& texture, bool layered, uint32_t layer);
+  /** \brief attach texture of the attachment again, e.g., after resize. **/
+  void attachTexture(GLenum target, Attachment& attachment);
+  /** \brief attach textures again, whose texture object was replaced by a resize of another copy. **/
+  void reattach();
+
+  /** \brief is an attached object only referenced by this framebuffer anymore or replaced by a resize? **/
+  bool orphaned() const;
+
+  std::map<FramebufferAttachment, Attachment> attachments_;
 };
 
 } /* namespace rv */
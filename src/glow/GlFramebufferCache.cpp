@@ -0,0 +1,115 @@
+#include "GlFramebufferCache.h"
+
+#include <algorithm>
+
+#include "glexception.h"
+
+namespace glow {
+
+GlFramebufferCache::Attachment::Attachment(FramebufferAttachment target, GlTexture& texture)
+    : target(target), texture(&texture) {}
+
+GlFramebufferCache::Attachment::Attachment(FramebufferAttachment target, GlTexture& texture, uint32_t layer)
+    : target(target), texture(&texture), layer(layer) {}
+
+GlFramebufferCache::Attachment::Attachment(FramebufferAttachment target, GlRenderbuffer& buffer)
+    : target(target), renderbuffer(&buffer) {}
+
+GlFramebufferCache::GlFramebufferCache(uint32_t maxFramebuffers) : maxFramebuffers_(maxFramebuffers) {}
+
+/** \brief is the attachment point a color attachment? **/
+inline bool is_color(FramebufferAttachment target) {
+  return target != FramebufferAttachment::DEPTH && target != FramebufferAttachment::STENCIL &&
+         target != FramebufferAttachment::DEPTH_STENCIL;
+}
+
+GlFramebuffer& GlFramebufferCache::get(uint32_t width, uint32_t height, const std::vector<Attachment>& attachments) {
+  // texture objects are kept alive by the cached framebuffer; thus, their ids identify the attachments.
+  std::vector<GLuint> key{width, height};
+  for (const Attachment& attachment : attachments) {
+    key.push_back(static_cast<GLuint>(attachment.target));
+    if (attachment.texture != nullptr) {
+      key.push_back(0);
+      key.push_back(attachment.texture->id());
+    } else {
+      key.push_back(1);
+      key.push_back(attachment.renderbuffer->id());
+    }
+    key.push_back(static_cast<GLuint>(attachment.layer));
+  }
+
+  auto it = framebuffers_.find(key);
+  if (it != framebuffers_.end()) {
+    it->second.lastUse = ++uses_;
+    return *it->second.framebuffer;
+  }
+
+  // new attachments, e.g., of a resized texture, might replace attachments of cached framebuffers.
+  purge();
+
+  std::unique_ptr<GlFramebuffer> framebuffer(new GlFramebuffer(width, height));
+  std::vector<FramebufferAttachment> drawBuffers;
+  for (const Attachment& attachment : attachments) {
+    if (attachment.texture != nullptr && attachment.layer >= 0) {
+      framebuffer->attachLayer(attachment.target, *attachment.texture, attachment.layer);
+    } else if (attachment.texture != nullptr) {
+      framebuffer->attach(attachment.target, *attachment.texture);
+    } else {
+      framebuffer->attach(attachment.target, *attachment.renderbuffer);
+    }
+
+    if (is_color(attachment.target)) drawBuffers.push_back(attachment.target);
+  }
+  // framebuffers without color attachments need no draw buffer to be complete.
+  if (drawBuffers.empty()) drawBuffers.push_back(FramebufferAttachment::NONE);
+  framebuffer->setDrawBuffers(drawBuffers);
+
+  if (!framebuffer->valid()) throw GlFramebufferError("Framebuffer with given attachments is not complete.");
+  framebuffer->cached_ = true;
+
+  trim(std::max<uint32_t>(maxFramebuffers_, 1) - 1);
+
+  Entry& entry = framebuffers_[key];
+  entry.framebuffer = std::move(framebuffer);
+  entry.lastUse = ++uses_;
+
+  return *entry.framebuffer;
+}
+
+void GlFramebufferCache::setMaxFramebuffers(uint32_t maxFramebuffers) {
+  maxFramebuffers_ = maxFramebuffers;
+  trim(maxFramebuffers_);
+}
+
+uint32_t GlFramebufferCache::maxFramebuffers() const {
+  return maxFramebuffers_;
+}
+
+uint32_t GlFramebufferCache::size() const {
+  return framebuffers_.size();
+}
+
+void GlFramebufferCache::clear() {
+  framebuffers_.clear();
+}
+
+void GlFramebufferCache::purge() {
+  for (auto it = framebuffers_.begin(); it != framebuffers_.end();) {
+    if (it->second.framebuffer->orphaned())
+      it = framebuffers_.erase(it);
+    else
+      ++it;
+  }
+}
+
+void GlFramebufferCache::trim(uint32_t maxFramebuffers) {
+  while (framebuffers_.size() > maxFramebuffers) {
+    auto lru = framebuffers_.begin();
+    for (auto it = framebuffers_.begin(); it != framebuffers_.end(); ++it) {
+      if (it->second.lastUse < lru->second.lastUse) lru = it;
+    }
+    framebuffers_.erase(lru);
+  }
+}
+
+} /* namespace glow */
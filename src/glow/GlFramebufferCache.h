@@ -0,0 +1,100 @@
+#ifndef INCLUDE_GLOW_GLFRAMEBUFFERCACHE_H_
+#define INCLUDE_GLOW_GLFRAMEBUFFERCACHE_H_
+
+#include <stdint.h>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "GlFramebuffer.h"
+
+namespace glow {
+
+/** \brief Cache of complete framebuffer objects for given sets of attachments.
+ *
+ *  Instead of re-attaching the output textures of a pass to a single framebuffer, which lets the driver
+ *  validate the framebuffer again and again, every set of attachments gets its own framebuffer object:
+ *
+ *    GlFramebuffer& fbo = cache.get(width, height, {{FramebufferAttachment::COLOR0, normals},
+ *                                                   {FramebufferAttachment::COLOR1, labels},
+ *                                                   {FramebufferAttachment::DEPTH, depth}});
+ *    fbo.bind();
+ *
+ *  The framebuffer is created and checked for completeness only at the first get with these attachments;
+ *  subsequent calls only look up the framebuffer. The color attachments are enabled as draw buffers in
+ *  the given order, i.e., fragment shader output i is written to the i-th color attachment.
+ *
+ *  Cached framebuffers hold copies of their attachments; thus, textures attached to a cached framebuffer are
+ *  not deleted (or recycled by a GlTexturePool) until the framebuffer is removed from the cache. If more than
+ *  maxFramebuffers() are cached, the least recently used framebuffer is removed. Framebuffers with
+ *  attachments, which are not referenced outside of the cache anymore or which got a new texture object by
+ *  a resize of immutable storage, are removed by the next get() of a new set of attachments.
+ *
+ *  Cached framebuffers cannot be resized, since their size is part of the key (GlFramebuffer::resize
+ *  throws); a resized texture simply gets a new framebuffer by get() with the new size.
+ **/
+class GlFramebufferCache {
+ public:
+  /** \brief texture, layer of a texture, or renderbuffer for a given attachment point.
+   *
+   *  Only refers to the objects of the caller during get(); the cached framebuffer keeps its own copies.
+   **/
+  struct Attachment {
+   public:
+    Attachment(FramebufferAttachment target, GlTexture& texture);
+    /** \brief single layer of a 2D array texture or slice of a 3D texture. **/
+    Attachment(FramebufferAttachment target, GlTexture& texture, uint32_t layer);
+    Attachment(FramebufferAttachment target, GlRenderbuffer& buffer);
+
+    FramebufferAttachment target;
+    GlTexture* texture{nullptr};
+    GlRenderbuffer* renderbuffer{nullptr};
+    int32_t layer{-1};  // -1, if the whole texture is attached.
+  };
+
+  explicit GlFramebufferCache(uint32_t maxFramebuffers = 32);
+
+  GlFramebufferCache(const GlFramebufferCache&) = delete;
+  GlFramebufferCache& operator=(const GlFramebufferCache&) = delete;
+
+  /** \brief get complete framebuffer of size width x height with given attachments.
+   *
+   *  The reference stays valid until the framebuffer is removed from the cache, i.e., at least until
+   *  the next get().
+   *
+   *  \throws GlFramebufferError if the framebuffer with these attachments is not complete.
+   **/
+  GlFramebuffer& get(uint32_t width, uint32_t height, const std::vector<Attachment>& attachments);
+
+  /** \brief set maximal number of cached framebuffers. **/
+  void setMaxFramebuffers(uint32_t maxFramebuffers);
+  uint32_t maxFramebuffers() const;
+
+  /** \brief number of cached framebuffers. **/
+  uint32_t size() const;
+
+  /** \brief remove all cached framebuffers. **/
+  void clear();
+
+ protected:
+  struct Entry {
+   public:
+    std::unique_ptr<GlFramebuffer> framebuffer;
+    uint64_t lastUse;
+  };
+
+  /** \brief remove framebuffers, whose attachments are only referenced by the cache. **/
+  void purge();
+
+  /** \brief remove least recently used framebuffers until at most maxFramebuffers are cached. **/
+  void trim(uint32_t maxFramebuffers);
+
+  uint32_t maxFramebuffers_;
+  uint64_t uses_{0};
+  // key: size and (attachment point, kind, object, layer) of every attachment.
+  std::map<std::vector<GLuint>, Entry> framebuffers_;
+};
+
+} /* namespace glow */
+
+#endif /* INCLUDE_GLOW_GLFRAMEBUFFERCACHE_H_ */
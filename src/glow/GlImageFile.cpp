@@ -0,0 +1,207 @@
+#include "GlImageFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cctype>
+#include <cstdlib>
+
+#include "GlFormatTraits.h"
+#include "glexception.h"
+
+namespace glow {
+
+/** \brief is the machine little-endian? **/
+inline bool little_endian() {
+  const uint16_t one = 1;
+  return *reinterpret_cast<const uint8_t*>(&one) == 1;
+}
+
+/** \brief parse positive integer of a header. **/
+inline uint32_t parse_dimension(const std::string& token, const std::string& filename) {
+  char* end = nullptr;
+  long value = std::strtol(token.c_str(), &end, 10);
+  if (token.empty() || *end != '\0' || value <= 0) {
+    throw GlTextureError("Invalid header of image file '" + filename + "'.");
+  }
+
+  return static_cast<uint32_t>(value);
+}
+
+GlImageFile::GlImageFile(const std::string& filename) : filename_(filename) {
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) throw GlTextureError("Unable to open image file '" + filename + "'.");
+
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size == 0) {
+    close(fd);
+    throw GlTextureError("Unable to read image file '" + filename + "'.");
+  }
+  size_ = info.st_size;
+
+  int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+  // read the whole file now, i.e., on the thread opening the file, and not at the upload.
+  flags |= MAP_POPULATE;
+#endif
+  void* ptr = mmap(nullptr, size_, PROT_READ, flags, fd, 0);
+  // the mapping stays valid after closing the descriptor.
+  close(fd);
+  if (ptr == MAP_FAILED) throw GlTextureError("Unable to map image file '" + filename + "'.");
+  data_ = static_cast<const uint8_t*>(ptr);
+
+  try {
+    size_t offset = 0;
+    std::string magic = token(offset);
+    if (magic == "P5" || magic == "P6") {
+      parsePnm(magic == "P5", offset);
+    } else if (magic == "Pf" || magic == "PF") {
+      parsePfm(magic == "Pf", offset);
+    } else if (magic == "GLOWRAW") {
+      parseRaw(offset);
+    } else {
+      throw GlTextureError("Unsupported type of image file '" + filename + "'.");
+    }
+
+    // exactly one whitespace character separates header and pixels.
+    pixels_ = offset + 1;
+
+    TextureFormatInfo format = textureFormatInfo(textureFormat_);
+    pixelFormat_ = static_cast<PixelFormat>(format.pixelFormat);
+    pixelType_ = static_cast<PixelType>(format.pixelType);
+
+    size_t bytes = static_cast<size_t>(width_) * height_ * format.components * pixelTypeSize(pixelType_);
+    if (pixels_ + bytes > size_) throw GlTextureError("Image file '" + filename + "' is truncated.");
+  } catch (...) {
+    munmap(const_cast<uint8_t*>(data_), size_);
+    throw;
+  }
+}
+
+GlImageFile::~GlImageFile() {
+  munmap(const_cast<uint8_t*>(data_), size_);
+}
+
+const std::string& GlImageFile::filename() const {
+  return filename_;
+}
+
+uint32_t GlImageFile::width() const {
+  return width_;
+}
+
+uint32_t GlImageFile::height() const {
+  return height_;
+}
+
+PixelFormat GlImageFile::pixelFormat() const {
+  return pixelFormat_;
+}
+
+PixelType GlImageFile::pixelType() const {
+  return pixelType_;
+}
+
+TextureFormat GlImageFile::textureFormat() const {
+  return textureFormat_;
+}
+
+bool GlImageFile::bottomUp() const {
+  return bottomUp_;
+}
+
+PixelStore GlImageFile::layout() const {
+  // rows of the supported files are never padded.
+  PixelStore layout = PixelStore::tight();
+  layout.swapBytes = swapBytes_;
+
+  return layout;
+}
+
+const void* GlImageFile::pixels() const {
+  return data_ + pixels_;
+}
+
+void GlImageFile::parsePnm(bool gray, size_t& offset) {
+  width_ = parse_dimension(token(offset), filename_);
+  height_ = parse_dimension(token(offset), filename_);
+  uint32_t maxval = parse_dimension(token(offset), filename_);
+  if (maxval > 65535) throw GlTextureError("Invalid maximal value in image file '" + filename_ + "'.");
+
+  // values are not rescaled, i.e., only maxval 255 or 65535 use the whole range of the texture.
+  if (maxval < 256) {
+    textureFormat_ = gray ? TextureFormat::R8 : TextureFormat::RGB8;
+  } else {
+    textureFormat_ = gray ? TextureFormat::R16 : TextureFormat::RGB16;
+    swapBytes_ = little_endian();  // 16 bit values are stored big-endian.
+  }
+  bottomUp_ = false;
+}
+
+void GlImageFile::parsePfm(bool gray, size_t& offset) {
+  width_ = parse_dimension(token(offset), filename_);
+  height_ = parse_dimension(token(offset), filename_);
+
+  std::string scale = token(offset);
+  char* end = nullptr;
+  double value = std::strtod(scale.c_str(), &end);
+  if (scale.empty() || *end != '\0' || value == 0.0) {
+    throw GlTextureError("Invalid header of image file '" + filename_ + "'.");
+  }
+
+  textureFormat_ = gray ? TextureFormat::R_FLOAT : TextureFormat::RGB_FLOAT;
+  // negative scale: little-endian values; positive scale: big-endian values.
+  swapBytes_ = ((value < 0.0) != little_endian());
+  bottomUp_ = true;
+}
+
+void GlImageFile::parseRaw(size_t& offset) {
+  width_ = parse_dimension(token(offset), filename_);
+  height_ = parse_dimension(token(offset), filename_);
+  uint32_t components = parse_dimension(token(offset), filename_);
+  std::string type = token(offset);
+  if (components > 4) throw GlTextureError("Invalid number of components in image file '" + filename_ + "'.");
+
+  static const TextureFormat u8[4] = {TextureFormat::R8, TextureFormat::RG8, TextureFormat::RGB8,
+                                      TextureFormat::RGBA8};
+  static const TextureFormat u16[4] = {TextureFormat::R16, TextureFormat::RG16, TextureFormat::RGB16,
+                                       TextureFormat::RGBA16};
+  static const TextureFormat f16[4] = {TextureFormat::R16F, TextureFormat::RG16F, TextureFormat::RGB16F,
+                                       TextureFormat::RGBA16F};
+  static const TextureFormat f32[4] = {TextureFormat::R_FLOAT, TextureFormat::RG_FLOAT, TextureFormat::RGB_FLOAT,
+                                       TextureFormat::RGBA_FLOAT};
+
+  if (type == "u8") {
+    textureFormat_ = u8[components - 1];
+  } else if (type == "u16") {
+    textureFormat_ = u16[components - 1];
+  } else if (type == "f16") {
+    textureFormat_ = f16[components - 1];
+  } else if (type == "f32") {
+    textureFormat_ = f32[components - 1];
+  } else {
+    throw GlTextureError("Invalid pixel type '" + type + "' in image file '" + filename_ + "'.");
+  }
+  bottomUp_ = true;
+}
+
+std::string GlImageFile::token(size_t& offset) const {
+  while (offset < size_) {
+    if (data_[offset] == '#') {
+      while (offset < size_ && data_[offset] != '\n') ++offset;
+    } else if (std::isspace(data_[offset])) {
+      ++offset;
+    } else {
+      break;
+    }
+  }
+
+  size_t start = offset;
+  while (offset < size_ && !std::isspace(data_[offset])) ++offset;
+  if (offset == size_) throw GlTextureError("Invalid header of image file '" + filename_ + "'.");
+
+  return std::string(reinterpret_cast<const char*>(data_ + start), offset - start);
+}
+
+} /* namespace glow */
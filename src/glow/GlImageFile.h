@@ -0,0 +1,89 @@
+#ifndef INCLUDE_GLOW_GLIMAGEFILE_H_
+#define INCLUDE_GLOW_GLIMAGEFILE_H_
+
+#include <stdint.h>
+#include <string>
+
+#include "GlPixelFormat.h"
+#include "GlTextureFormat.h"
+
+namespace glow {
+
+/** \brief Memory-mapped image file, whose pixels are uploaded to textures directly from the mapping.
+ *
+ *  Supported file types (recognized by their header, not by the extension of the filename):
+ *
+ *  - binary PGM (P5) and PPM (P6) with 8 bit (maxval < 256) or 16 bit (maxval < 65536) per component,
+ *  - PFM with gray (Pf) or RGB (PF) float values,
+ *  - raw files, i.e., a header line "GLOWRAW <width> <height> <components> <type>" followed by the
+ *    tightly packed pixels in the byte order of the machine, where the type is u8, u16, f16, or f32.
+ *
+ *  The pixels are never copied or converted on the host. Big-endian components of PGM/PPM files (and of
+ *  big-endian PFM files) are swapped by GL_UNPACK_SWAP_BYTES, see layout(). Rows of PGM/PPM files are
+ *  stored from the top to the bottom, but rows of textures from the bottom to the top (see GlTexture::save);
+ *  thus, such files are uploaded into a cached scratch texture (see GlBlitter::scratch), which is flipped
+ *  by GlBlitter::flip on the GPU.
+ *  Rows of PFM and raw files are stored from the bottom to the top and need no flip.
+ *
+ *  Opening the file only maps it and parses the header; thus, files can be opened on a worker thread
+ *  (see GlImageLoader), while only the upload must happen on the GL thread.
+ **/
+class GlImageFile {
+ public:
+  /** \brief map and parse the given file.
+   *
+   *  \throws GlTextureError if the file cannot be opened or is no supported image file.
+   **/
+  explicit GlImageFile(const std::string& filename);
+  ~GlImageFile();
+
+  GlImageFile(const GlImageFile&) = delete;
+  GlImageFile& operator=(const GlImageFile&) = delete;
+
+  const std::string& filename() const;
+
+  uint32_t width() const;
+  uint32_t height() const;
+
+  /** \brief pixel format and type of the pixels in the file. **/
+  PixelFormat pixelFormat() const;
+  PixelType pixelType() const;
+  /** \brief sized texture format, which holds the pixels without loss. **/
+  TextureFormat textureFormat() const;
+
+  /** \brief are the rows stored from the bottom to the top, i.e., like the rows of a texture? **/
+  bool bottomUp() const;
+
+  /** \brief layout of the pixels for uploads, i.e., unaligned rows and swapped bytes if needed. **/
+  PixelStore layout() const;
+
+  /** \brief pointer to the first pixel inside the mapping. **/
+  const void* pixels() const;
+
+ protected:
+  /** \brief parse header of PGM (gray) or PPM file. **/
+  void parsePnm(bool gray, size_t& offset);
+  /** \brief parse header of gray or RGB PFM file. **/
+  void parsePfm(bool gray, size_t& offset);
+  /** \brief parse header of raw file. **/
+  void parseRaw(size_t& offset);
+
+  /** \brief next whitespace-separated token of the header starting at offset; skips comments. **/
+  std::string token(size_t& offset) const;
+
+  std::string filename_;
+  const uint8_t* data_{nullptr};
+  size_t size_{0};
+
+  uint32_t width_{0}, height_{0};
+  PixelFormat pixelFormat_{PixelFormat::RGB};
+  PixelType pixelType_{PixelType::UNSIGNED_BYTE};
+  TextureFormat textureFormat_{TextureFormat::RGB8};
+  bool bottomUp_{true};
+  bool swapBytes_{false};
+  size_t pixels_{0};  // offset of the first pixel.
+};
+
+} /* namespace glow */
+
+#endif /* INCLUDE_GLOW_GLIMAGEFILE_H_ */
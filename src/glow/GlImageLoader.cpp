@@ -0,0 +1,111 @@
+#include "GlImageLoader.h"
+
+#include "glexception.h"
+
+namespace glow {
+
+GlImageLoader::GlImageLoader() {}
+
+GlImageLoader::~GlImageLoader() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cond_.notify_all();
+  if (worker_.joinable()) worker_.join();
+}
+
+void GlImageLoader::submit(const std::string& filename) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.push_back(Job());
+    jobs_.back().filename = filename;
+    if (!running_) {
+      running_ = true;
+      worker_ = std::thread(&GlImageLoader::run, this);
+    }
+  }
+  cond_.notify_all();
+}
+
+std::unique_ptr<GlImageFile> GlImageLoader::fetch(bool wait) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (wait) cond_.wait(lock, [this] { return jobs_.empty() || jobs_.front().done; });
+  if (jobs_.empty() || !jobs_.front().done) return nullptr;
+
+  Job job = std::move(jobs_.front());
+  jobs_.pop_front();
+  lock.unlock();
+
+  if (job.image == nullptr) throw GlTextureError(job.error);
+
+  return std::move(job.image);
+}
+
+std::vector<GlTexture> GlImageLoader::load(const std::vector<std::string>& filenames) {
+  if (pending() > 0) throw GlTextureError("Image loader has still pending files.");
+
+  for (const std::string& filename : filenames) submit(filename);
+
+  std::vector<GlTexture> textures;
+  textures.reserve(filenames.size());
+  try {
+    // the upload of file i overlaps with the reading of the following files.
+    for (uint32_t i = 0; i < filenames.size(); ++i) textures.push_back(GlTexture::loadTexture(*fetch(true)));
+  } catch (...) {
+    // drop remaining files, so that the loader can be used again; the worker still refers to unfinished jobs.
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this] {
+      for (const Job& job : jobs_) {
+        if (!job.done) return false;
+      }
+      return true;
+    });
+    jobs_.clear();
+    throw;
+  }
+
+  return textures;
+}
+
+uint32_t GlImageLoader::pending() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return jobs_.size();
+}
+
+void GlImageLoader::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  while (true) {
+    auto next = [this] {
+      for (auto it = jobs_.begin(); it != jobs_.end(); ++it) {
+        if (!it->done) return it;
+      }
+      return jobs_.end();
+    };
+    cond_.wait(lock, [this, &next] { return stop_ || next() != jobs_.end(); });
+    if (stop_) return;
+
+    std::string filename = next()->filename;
+
+    // map and read the file without holding the lock.
+    lock.unlock();
+    std::unique_ptr<GlImageFile> image;
+    std::string error;
+    try {
+      image.reset(new GlImageFile(filename));
+    } catch (const GlTextureError& e) {
+      error = e.what();
+    }
+    lock.lock();
+
+    // the job is still the first not done, since only the worker marks jobs as done.
+    Job& job = *next();
+    job.image = std::move(image);
+    job.error = error;
+    job.done = true;
+    cond_.notify_all();
+  }
+}
+
+} /* namespace glow */
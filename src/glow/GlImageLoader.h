@@ -0,0 +1,78 @@
+#ifndef INCLUDE_GLOW_GLIMAGELOADER_H_
+#define INCLUDE_GLOW_GLIMAGELOADER_H_
+
+#include <stdint.h>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "GlImageFile.h"
+#include "GlTexture.h"
+
+namespace glow {
+
+/** \brief Opens and reads image files on a worker thread, while the GL thread only uploads them.
+ *
+ *  Mapping a file and reading its pages from the disk is the expensive part of loading an image; with
+ *  the loader, this happens on the worker thread for the next files, while the GL thread uploads the
+ *  current one:
+ *
+ *    for (const std::string& filename : filenames) loader.submit(filename);  // any thread.
+ *    ...
+ *    std::unique_ptr<GlImageFile> image = loader.fetch();  // GL thread, e.g., every frame.
+ *    if (image != nullptr) texture.assign(*image);
+ *
+ *  Files are fetched in the order of submission. The loader itself makes no OpenGL calls.
+ **/
+class GlImageLoader {
+ public:
+  GlImageLoader();
+  ~GlImageLoader();
+
+  GlImageLoader(const GlImageLoader&) = delete;
+  GlImageLoader& operator=(const GlImageLoader&) = delete;
+
+  /** \brief open the file on the worker thread. The worker is started with the first submit. **/
+  void submit(const std::string& filename);
+
+  /** \brief get next submitted file, if already opened; nullptr otherwise.
+   *
+   *  If wait is true, waits until the next file is opened; without pending files, nullptr is returned.
+   *  \throws GlTextureError if the next file could not be opened (see GlImageFile).
+   **/
+  std::unique_ptr<GlImageFile> fetch(bool wait = false);
+
+  /** \brief load all files into textures (see GlTexture::loadTexture) with the worker thread.
+   *
+   *  Must be called on the GL thread and without pending files.
+   **/
+  std::vector<GlTexture> load(const std::vector<std::string>& filenames);
+
+  /** \brief number of submitted files, which are not yet fetched. **/
+  uint32_t pending() const;
+
+ protected:
+  struct Job {
+   public:
+    std::string filename;
+    std::unique_ptr<GlImageFile> image;
+    std::string error;
+    bool done{false};
+  };
+
+  void run();
+
+  mutable std::mutex mutex_;
+  std::condition_variable cond_;
+  std::thread worker_;
+  bool running_{false}, stop_{false};
+  std::deque<Job> jobs_;  // in order of submission; the worker opens the first job not done.
+};
+
+} /* namespace glow */
+
+#endif /* INCLUDE_GLOW_GLIMAGELOADER_H_ */
@@ -2,6 +2,7 @@
 #define SRC_OPENGL_GLOBJECT_H_
 
 #include "glbase.h"
+#include "GlStats.h"
 #include <memory>
 
 namespace glow {
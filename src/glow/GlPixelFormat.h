@@ -16,18 +16,19 @@ enum class PixelFormat {
   R = GL_RED,
   RG = GL_RG,
   RGB = GL_RGB,
-  BRG = GL_BGR,
+  BGR = GL_BGR,
+  BRG = GL_BGR,  // deprecated: misspelled BGR.
   RGBA = GL_RGBA,
   BGRA = GL_BGRA,
   // pixels colors are stored in range [0,2^B-1], where B corresponds to the number of bits.
   R_INTEGER = GL_RED_INTEGER,
   RG_INTEGER = GL_RG_INTEGER,
   RGB_INTEGER = GL_RGB_INTEGER,
-  BGR_INTEGER = GL_BGRA_INTEGER,
+  BGR_INTEGER = GL_BGR_INTEGER,
   RGBA_INTEGER = GL_RGBA_INTEGER,
   BGRA_INTEGER = GL_BGRA_INTEGER,
   DEPTH = GL_DEPTH_COMPONENT,
-  DEPTH_STENCIL = GL_DEPTH24_STENCIL8,
+  DEPTH_STENCIL = GL_DEPTH_STENCIL,
   STENCIL = GL_STENCIL_INDEX,
 
 };
@@ -44,6 +45,158 @@ enum class PixelType {
   // TODO: add packed formats, ...
 };
 
+/** \brief number of components of a pixel in given format. **/
+inline uint32_t pixelComponents(PixelFormat format) {
+  switch (static_cast<GLenum>(format)) {
+    case GL_RED:
+    case GL_RED_INTEGER:
+    case GL_DEPTH_COMPONENT:
+    case GL_STENCIL_INDEX:
+      return 1;
+    case GL_RG:
+    case GL_RG_INTEGER:
+    case GL_DEPTH_STENCIL:
+      return 2;
+    case GL_RGB:
+    case GL_BGR:
+    case GL_RGB_INTEGER:
+    case GL_BGR_INTEGER:
+      return 3;
+    default:
+      return 4;
+  }
+}
+
+/** \brief size of a single component of given pixel type in bytes. **/
+inline uint32_t pixelTypeSize(PixelType type) {
+  switch (type) {
+    case PixelType::UNSIGNED_BYTE:
+    case PixelType::BYTE:
+      return 1;
+    case PixelType::UNSIGNED_SHORT:
+    case PixelType::SHORT:
+    case PixelType::HALF_FLOAT:
+      return 2;
+    case PixelType::UNSIGNED_INT:
+    case PixelType::INT:
+    case PixelType::FLOAT:
+      return 4;
+  }
+
+  return 4;
+}
+
+/** \brief layout of the rows of a host image for uploads to and downloads from textures.
+ *
+ *  The default values correspond to the default pixel store state of OpenGL, i.e., tightly packed rows
+ *  aligned to 4 bytes. With rowLength and alignment, images with padded rows, e.g., a cv::Mat, are
+ *  transferred directly; skipPixels and skipRows select the first pixel of a region of the host image.
+ *  With swapBytes, data in the byte order of another machine is converted by the transfer itself.
+ *
+ *  Like the bindings of glow objects, the pixel store state of OpenGL is tracked: apply only sets the fields
+ *  that differ from the current layout and returns the previous layout, which is applied again after the
+ *  transfer. Thus, a layout of the caller must also be set by apply and not directly by glPixelStorei.
+ **/
+struct PixelStore {
+ public:
+  uint32_t rowLength{0};   // pixels per row of the host image; 0: width of the transferred region.
+  uint32_t alignment{4};   // alignment of the rows in bytes: 1, 2, 4, or 8.
+  uint32_t skipPixels{0};  // pixels skipped at the start of every row.
+  uint32_t skipRows{0};    // rows skipped at the start of the image.
+  bool swapBytes{false};   // swap the bytes of multi-byte components, e.g., of big-endian files.
+
+  /** \brief layout of an image with rows of stride bytes, e.g., cv::Mat::step.
+   *
+   *  \throws GlTextureError if the stride cannot be expressed by row length and alignment.
+   **/
+  static PixelStore fromStride(size_t stride, PixelFormat pixelfmt, PixelType type);
+
+  /** \brief layout of tightly packed rows without any padding, i.e., an alignment of 1. **/
+  static PixelStore tight();
+
+  /** \brief bytes spanned by a region of width x height pixels in the host image. **/
+  size_t size(uint32_t width, uint32_t height, PixelFormat pixelfmt, PixelType type) const;
+
+  /** \brief set layout as GL_PACK_* (for downloads) or GL_UNPACK_* (for uploads) state; returns previous layout. **/
+  PixelStore apply(bool pack) const;
+
+  /** \brief layout of the GL_PACK_* or GL_UNPACK_* state set by apply. **/
+  static const PixelStore& current(bool pack);
+
+ protected:
+  static PixelStore& tracked(bool pack);
+};
+
+inline PixelStore PixelStore::fromStride(size_t stride, PixelFormat pixelfmt, PixelType type) {
+  size_t pixelSize = pixelComponents(pixelfmt) * pixelTypeSize(type);
+
+  PixelStore layout;
+  layout.rowLength = stride / pixelSize;
+  for (uint32_t alignment = 1; alignment <= 8; alignment *= 2) {
+    if ((layout.rowLength * pixelSize + alignment - 1) / alignment * alignment == stride) {
+      layout.alignment = alignment;
+      return layout;
+    }
+  }
+
+  throw GlTextureError("Row stride cannot be expressed by row length and alignment.");
+}
+
+inline PixelStore PixelStore::tight() {
+  PixelStore layout;
+  layout.alignment = 1;
+  return layout;
+}
+
+inline size_t PixelStore::size(uint32_t width, uint32_t height, PixelFormat pixelfmt, PixelType type) const {
+  if (width == 0 || height == 0) return 0;
+
+  size_t pixelSize = pixelComponents(pixelfmt) * pixelTypeSize(type);
+  size_t stride = ((rowLength > 0) ? rowLength : width) * pixelSize;
+  stride = (stride + alignment - 1) / alignment * alignment;
+
+  return (skipRows + height - 1) * stride + (skipPixels + width) * pixelSize;
+}
+
+inline PixelStore PixelStore::apply(bool pack) const {
+  PixelStore& state = tracked(pack);
+  PixelStore previous = state;
+
+  if (rowLength != state.rowLength) {
+    glPixelStorei(pack ? GL_PACK_ROW_LENGTH : GL_UNPACK_ROW_LENGTH, rowLength);
+    GLOW_STATS_CALL(STATE);
+  }
+  if (alignment != state.alignment) {
+    glPixelStorei(pack ? GL_PACK_ALIGNMENT : GL_UNPACK_ALIGNMENT, alignment);
+    GLOW_STATS_CALL(STATE);
+  }
+  if (skipPixels != state.skipPixels) {
+    glPixelStorei(pack ? GL_PACK_SKIP_PIXELS : GL_UNPACK_SKIP_PIXELS, skipPixels);
+    GLOW_STATS_CALL(STATE);
+  }
+  if (skipRows != state.skipRows) {
+    glPixelStorei(pack ? GL_PACK_SKIP_ROWS : GL_UNPACK_SKIP_ROWS, skipRows);
+    GLOW_STATS_CALL(STATE);
+  }
+  if (swapBytes != state.swapBytes) {
+    glPixelStorei(pack ? GL_PACK_SWAP_BYTES : GL_UNPACK_SWAP_BYTES, swapBytes ? GL_TRUE : GL_FALSE);
+    GLOW_STATS_CALL(STATE);
+  }
+  state = *this;
+
+  return previous;
+}
+
+inline const PixelStore& PixelStore::current(bool pack) {
+  return tracked(pack);
+}
+
+inline PixelStore& PixelStore::tracked(bool pack) {
+  // initially, the default state of OpenGL.
+  static PixelStore layouts[2];
+  return layouts[pack ? 1 : 0];
+}
+
 } /* namespace rv */
 
 #endif
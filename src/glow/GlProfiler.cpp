@@ -0,0 +1,227 @@
+#include "GlProfiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+namespace glow {
+
+GlProfiler::Scope::Scope(GlProfiler& profiler, const std::string& name) : profiler_(profiler) {
+  profiler_.begin(name);
+  frame_ = profiler_.frameCount_;
+  depth_ = profiler_.stack_.size();
+  index_ = profiler_.stack_.back();
+}
+
+GlProfiler::Scope::~Scope() {
+  // end() throws without open scope; destructors must not throw.
+  if (!profiler_.active_ || profiler_.frameCount_ != frame_) return;
+  if (profiler_.stack_.size() < depth_ || profiler_.stack_[depth_ - 1] != index_) return;
+  while (profiler_.stack_.size() >= depth_) profiler_.end();  // also closes nested scopes left open.
+}
+
+GlProfiler::GlProfiler(uint32_t latency, uint32_t window)
+    : latency_(std::max<uint32_t>(latency, 1)), window_(std::max<uint32_t>(window, 1)), frames_(latency_) {
+  start_ = clock::now();
+}
+
+uint64_t GlProfiler::now() const {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start_).count();
+}
+
+void GlProfiler::beginFrame() {
+  if (active_) throw GlQueryError("GlProfiler: endFrame() missing.");
+
+  if (!gpuOffsetValid_) {
+    // relate GPU timestamps to the CPU clock once, needed for a common time line in the trace.
+    GLint64 gpu_time = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpu_time);
+    gpuOffset_ = static_cast<int64_t>(gpu_time) - static_cast<int64_t>(now());
+    gpuOffsetValid_ = true;
+  }
+
+  frameCount_ += 1;
+  current_ = (current_ + 1) % latency_;
+  Frame& frame = frames_[current_];
+  if (frame.pending) collect(frame, false);
+
+  frame.pending = true;
+  frame.numQueries = 0;
+  frame.scopes.clear();
+  stack_.clear();
+  active_ = true;
+}
+
+void GlProfiler::endFrame() {
+  if (!active_) throw GlQueryError("GlProfiler: beginFrame() missing.");
+  while (!stack_.empty()) end();  // close scopes, which were not closed explicitly.
+
+  active_ = false;
+}
+
+uint32_t GlProfiler::timestamp(Frame& frame) {
+  if (frame.numQueries == frame.queries.size()) frame.queries.push_back(GlQuery(QueryTarget::TIMESTAMP));
+
+  frame.queries[frame.numQueries].timestamp();
+
+  return frame.numQueries++;
+}
+
+void GlProfiler::begin(const std::string& name) {
+  if (!active_) throw GlQueryError("GlProfiler: scopes must be inside beginFrame() and endFrame().");
+
+  Frame& frame = frames_[current_];
+
+  ScopeRecord scope;
+  scope.path = (stack_.empty() ? "" : frame.scopes[stack_.back()].path + "/") + name;
+  scope.depth = stack_.size();
+
+#if __GL_VERSION >= 430L
+  glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, name.c_str());
+#endif
+
+  scope.queryBegin = timestamp(frame);
+  scope.cpuBegin = now();
+
+  stack_.push_back(frame.scopes.size());
+  frame.scopes.push_back(scope);
+}
+
+void GlProfiler::end() {
+  if (stack_.empty()) throw GlQueryError("GlProfiler: end() without matching begin().");
+
+  Frame& frame = frames_[current_];
+  ScopeRecord& scope = frame.scopes[stack_.back()];
+  stack_.pop_back();
+
+  scope.cpuEnd = now();
+  scope.queryEnd = timestamp(frame);
+
+#if __GL_VERSION >= 430L
+  glPopDebugGroup();
+#endif
+}
+
+void GlProfiler::flush() {
+  if (active_) endFrame();
+
+  // collect in order of submission, starting with the oldest frame.
+  for (uint32_t i = 1; i <= latency_; ++i) {
+    Frame& frame = frames_[(current_ + i) % latency_];
+    if (frame.pending) collect(frame, true);
+  }
+}
+
+void GlProfiler::addSample(std::vector<double>& samples, uint32_t& next, double value) {
+  if (samples.size() < window_)
+    samples.push_back(value);
+  else
+    samples[next] = value;
+
+  next = (next + 1) % window_;
+}
+
+void GlProfiler::collect(Frame& frame, bool wait) {
+  frame.pending = false;
+
+  // timestamps are processed in order: if the last one is available, all other results are available.
+  bool available = (frame.numQueries > 0) && (wait || frame.queries[frame.numQueries - 1].ready());
+  if (!available && frame.numQueries > 0) droppedFrames_ += 1;
+
+  std::vector<uint64_t> timestamps(frame.numQueries, 0);
+  if (available) {
+    for (uint32_t i = 0; i < frame.numQueries; ++i) frame.queries[i].value(timestamps[i]);
+  }
+
+  for (const ScopeRecord& scope : frame.scopes) {
+    History& history = history_[scope.path];
+    addSample(history.cpu, history.nextCpu, 1e-6 * (scope.cpuEnd - scope.cpuBegin));
+    trace_.push_back(TraceEvent{scope.path, false, scope.cpuBegin, scope.cpuEnd - scope.cpuBegin});
+
+    if (!available) continue;
+
+    uint64_t gpu_begin = timestamps[scope.queryBegin];
+    uint64_t gpu_end = std::max(gpu_begin, timestamps[scope.queryEnd]);
+
+    addSample(history.gpu, history.nextGpu, 1e-6 * (gpu_end - gpu_begin));
+    int64_t begin = std::max<int64_t>(0, static_cast<int64_t>(gpu_begin) - gpuOffset_);
+    trace_.push_back(TraceEvent{scope.path, true, static_cast<uint64_t>(begin), gpu_end - gpu_begin});
+  }
+
+  while (trace_.size() > maxTraceEvents_) trace_.pop_front();
+}
+
+std::map<std::string, GlProfiler::Statistics> GlProfiler::statistics() const {
+  std::map<std::string, Statistics> stats;
+
+  for (auto it = history_.begin(); it != history_.end(); ++it) {
+    Statistics& s = stats[it->first];
+    const History& h = it->second;
+
+    s.count = h.cpu.size();
+    if (!h.cpu.empty()) {
+      s.cpuMin = *std::min_element(h.cpu.begin(), h.cpu.end());
+      s.cpuMax = *std::max_element(h.cpu.begin(), h.cpu.end());
+      for (double v : h.cpu) s.cpuMean += v;
+      s.cpuMean /= h.cpu.size();
+    }
+
+    if (!h.gpu.empty()) {
+      s.gpuMin = *std::min_element(h.gpu.begin(), h.gpu.end());
+      s.gpuMax = *std::max_element(h.gpu.begin(), h.gpu.end());
+      for (double v : h.gpu) s.gpuMean += v;
+      s.gpuMean /= h.gpu.size();
+    }
+  }
+
+  return stats;
+}
+
+inline std::string json_escape(const std::string& str) {
+  std::string escaped;
+  for (char c : str) {
+    if (c == '"' || c == '\\') escaped += '\\';
+    if (c == '\n') {
+      escaped += "\\n";
+      continue;
+    }
+    escaped += c;
+  }
+
+  return escaped;
+}
+
+void GlProfiler::writeChromeTrace(std::ostream& out) const {
+  // microseconds with nanosecond resolution; the default precision would round large timestamps.
+  std::ios::fmtflags flags = out.flags();
+  std::streamsize precision = out.precision(3);
+  out.setf(std::ios::fixed, std::ios::floatfield);
+
+  out << "{\"traceEvents\":[";
+  for (uint32_t i = 0; i < trace_.size(); ++i) {
+    const TraceEvent& e = trace_[i];
+    std::string::size_type idx = e.name.rfind("/");
+    std::string name = (idx == std::string::npos) ? e.name : e.name.substr(idx + 1);
+
+    out << ((i > 0) ? ",\n" : "\n");
+    out << "{\"name\":\"" << json_escape(name) << "\",\"cat\":\"" << (e.gpu ? "gpu" : "cpu") << "\",\"ph\":\"X\",";
+    out << "\"ts\":" << 1e-3 * e.begin << ",\"dur\":" << 1e-3 * e.duration << ",";
+    out << "\"pid\":0,\"tid\":" << (e.gpu ? 1 : 0) << ",\"args\":{\"path\":\"" << json_escape(e.name) << "\"}}";
+  }
+  out << "\n],\n\"displayTimeUnit\":\"ms\"}" << std::endl;
+
+  out.flags(flags);
+  out.precision(precision);
+}
+
+bool GlProfiler::saveChromeTrace(const std::string& filename) const {
+  std::ofstream out(filename.c_str());
+  if (!out.is_open()) return false;
+
+  writeChromeTrace(out);
+  out.close();
+
+  return true;
+}
+
+} /* namespace glow */
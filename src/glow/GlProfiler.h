@@ -0,0 +1,167 @@
+#ifndef INCLUDE_GLOW_GLPROFILER_H_
+#define INCLUDE_GLOW_GLPROFILER_H_
+
+#include <chrono>
+#include <deque>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "GlQuery.h"
+
+namespace glow {
+
+/** \brief Hierarchical frame profiler measuring CPU and GPU times of named scopes.
+ *
+ *  Each scope records a pair of GL_TIMESTAMP queries and the CPU time of the scope. Scopes can
+ *  be nested and are identified by their path, i.e., the names of all enclosing scopes joined
+ *  by '/'. The timestamp queries of a frame are kept in a ring of \a latency frames and only read
+ *  back when the frame is reused, i.e., several frames later. If the results are then still not
+ *  available, the GPU times of that frame are dropped instead of stalling the pipeline.
+ *
+ *  Example:
+ *    GlProfiler profiler;
+ *
+ *    while (running) {
+ *      profiler.beginFrame();
+ *      {
+ *        GlProfiler::Scope scope(profiler, "convolution");
+ *        // ... draw calls ...
+ *      }
+ *      profiler.endFrame();
+ *    }
+ *
+ *    std::cout << profiler.statistics().at("convolution").gpuMean << " ms" << std::endl;
+ *    profiler.saveChromeTrace("trace.json");  // open with chrome://tracing.
+ *
+ *  With OpenGL 4.3+, every scope additionally emits a debug group (glPushDebugGroup), which
+ *  makes the scopes visible in frame debuggers.
+ *
+ *  Note: Queries can only be recorded while a frame is active, i.e., between beginFrame() and endFrame().
+ */
+class GlProfiler {
+ public:
+  /** \brief rolling statistics of a scope over the last frames. All times in milliseconds. **/
+  struct Statistics {
+   public:
+    uint32_t count{0};
+    double cpuMean{0.0}, cpuMin{0.0}, cpuMax{0.0};
+    double gpuMean{0.0}, gpuMin{0.0}, gpuMax{0.0};
+  };
+
+  /** \brief automatic begin and end of a named scope.
+   *
+   *  If the scope was already closed, e.g., by endFrame(), the destructor does nothing.
+   **/
+  class Scope {
+   public:
+    Scope(GlProfiler& profiler, const std::string& name);
+    ~Scope();
+
+   protected:
+    GlProfiler& profiler_;
+    uint64_t frame_;  // frame, depth on the stack of open scopes, and index of the scope in the frame.
+    uint32_t depth_, index_;
+  };
+
+  /** \brief initialize profiler.
+   *
+   *  \param latency number of frames until the results of a frame are read back.
+   *  \param window  number of frames used for the rolling statistics.
+   **/
+  GlProfiler(uint32_t latency = 4, uint32_t window = 60);
+
+  /** \brief start a new frame and collect the results of the frame issued \a latency frames before. **/
+  void beginFrame();
+  /** \brief end the current frame. **/
+  void endFrame();
+
+  /** \brief begin a named scope inside the current frame or scope. **/
+  void begin(const std::string& name);
+  /** \brief end the innermost scope. **/
+  void end();
+
+  /** \brief wait for all pending results and collect them.
+   *
+   *  Blocks until all queries are available. Only intended for the end of a measurement or for
+   *  tools that render only a single frame.
+   **/
+  void flush();
+
+  /** \brief rolling statistics for every scope path. **/
+  std::map<std::string, Statistics> statistics() const;
+
+  /** \brief write collected scopes in the Chrome trace event format (JSON). **/
+  void writeChromeTrace(std::ostream& out) const;
+  /** \brief save collected scopes in the Chrome trace event format to the given file.
+   *
+   *  \return true, if file could be written; false, otherwise.
+   **/
+  bool saveChromeTrace(const std::string& filename) const;
+
+  /** \brief number of frames whose GPU times were dropped, since results were not available in time. **/
+  uint32_t droppedFrames() const { return droppedFrames_; }
+
+  /** \brief maximum number of trace events kept for the chrome trace. **/
+  void setMaxTraceEvents(uint32_t num) { maxTraceEvents_ = num; }
+
+ protected:
+  typedef std::chrono::steady_clock clock;
+
+  struct ScopeRecord {
+   public:
+    std::string path;
+    uint32_t depth{0};
+    uint64_t cpuBegin{0}, cpuEnd{0};  // nanoseconds since start of the profiler.
+    uint32_t queryBegin{0}, queryEnd{0};
+  };
+
+  struct Frame {
+   public:
+    bool pending{false};
+    uint32_t numQueries{0};
+    std::vector<GlQuery> queries;
+    std::vector<ScopeRecord> scopes;
+  };
+
+  struct History {
+   public:
+    std::vector<double> cpu, gpu;  // ring buffers with at most window_ entries.
+    uint32_t nextCpu{0}, nextGpu{0};
+  };
+
+  struct TraceEvent {
+   public:
+    std::string name;
+    bool gpu;
+    uint64_t begin, duration;  // nanoseconds since start of the profiler.
+  };
+
+  uint64_t now() const;
+  uint32_t timestamp(Frame& frame);
+  /** \brief collect results of given frame; if wait is false and results are not available, the frame is dropped. **/
+  void collect(Frame& frame, bool wait);
+  void addSample(std::vector<double>& samples, uint32_t& next, double value);
+
+  uint32_t latency_, window_;
+  uint32_t current_{0};
+  bool active_{false};
+  uint64_t frameCount_{0};  // number of frames started by beginFrame().
+
+  std::vector<Frame> frames_;
+  std::vector<uint32_t> stack_;  // indexes of open scopes in current frame.
+
+  clock::time_point start_;
+  int64_t gpuOffset_{0};  // offset between GPU timestamps and CPU clock in nanoseconds.
+  bool gpuOffsetValid_{false};
+
+  std::map<std::string, History> history_;
+  std::deque<TraceEvent> trace_;
+  uint32_t maxTraceEvents_{100000};
+  uint32_t droppedFrames_{0};
+};
+
+} /* namespace glow */
+
+#endif /* INCLUDE_GLOW_GLPROFILER_H_ */
@@ -10,8 +10,10 @@ GLuint GlProgram::boundProgram_ = 0;
 
 GlProgram::GlProgram() {
   id_ = glCreateProgram();
+  GLOW_STATS_CREATED(PROGRAM);
   ptr_ = std::shared_ptr<GLuint>(new GLuint(id_), [](GLuint* ptr) {
     glDeleteProgram(*ptr);
+    GLOW_STATS_DESTROYED(PROGRAM);
     delete ptr;
   });
 }
@@ -97,11 +99,13 @@ void GlProgram::link() {
 void GlProgram::bind() {
   assert(linked_ && "GlProgram should be linked with link() before usage!");
   glUseProgram(id_);
+  GLOW_STATS_CALL(BIND_PROGRAM);
   boundProgram_ = id_;
 }
 
 void GlProgram::release() {
   glUseProgram(0);
+  GLOW_STATS_CALL(BIND_PROGRAM);
   boundProgram_ = 0;
 }
 
@@ -109,14 +113,19 @@ void GlProgram::setUniform(const GlAbstractUniform& uniform) {
   if (!linked_) throw GlProgramError("Unable to set Uniform: program not linked!");
   GLuint id = bindTransparently();
   uniform.bind(id_);
+  GLOW_STATS_CALL(UNIFORM);
   releaseTransparently(id);
 }
 
 GLuint GlProgram::bindTransparently() {
   assert(linked_ && "GlProgram should be linked with link() before usage!");
-  if (boundProgram_ == id_) return id_;
+  if (boundProgram_ == id_) {
+    GLOW_STATS_REDUNDANT_BIND();
+    return id_;
+  }
 
   glUseProgram(id_);
+  GLOW_STATS_CALL(BIND_PROGRAM);
   return boundProgram_;
 }
 
@@ -124,6 +133,7 @@ void GlProgram::releaseTransparently(GLuint oldProgram) {
   if (oldProgram == id_) return;
 
   glUseProgram(oldProgram);
+  GLOW_STATS_CALL(BIND_PROGRAM);
 }
 
 } /* namespace rv */
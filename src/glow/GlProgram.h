@@ -30,6 +30,8 @@ namespace glow {
  */
 class GlProgram : public GlObject {
  public:
+  friend class GlStateGuard;
+
   /** \brief Create empty program object. **/
   GlProgram();
 
@@ -17,10 +17,19 @@ void GlQuery::value<uint32_t>(uint32_t& value) const {
   value = params;
 }
 
+template <>
+void GlQuery::value<int64_t>(int64_t& value) const {
+  GLint64 params;
+  glGetQueryObjecti64v(id_, GL_QUERY_RESULT, &params);
+  value = params;
+}
+
 GlQuery::GlQuery(QueryTarget target) : target_(static_cast<GLenum>(target)) {
   glGenQueries(1, &id_);
+  GLOW_STATS_CREATED(QUERY);
   ptr_ = std::shared_ptr<GLuint>(new GLuint(id_), [](GLuint* ptr) {
     glDeleteQueries(1, ptr);
+    GLOW_STATS_DESTROYED(QUERY);
     delete ptr;
   });
 }
@@ -46,6 +55,7 @@ GlQuery::operator int32_t() {
  **/
 void GlQuery::begin(uint32_t index) {
   if (started_) throw GlQueryError("Query object already active.");
+  if (target_ == GL_TIMESTAMP) throw GlQueryError("Timestamp queries must be recorded with timestamp().");
 
 // if VERSION < GL_4_0 => only glBeginQuery(target_, id_); is available.
 #if __GL_VERSION >= 400L
@@ -57,6 +67,7 @@ void GlQuery::begin(uint32_t index) {
   index_ = 0;
 #endif
 
+  GLOW_STATS_CALL(QUERY);
   started_ = true;
 }
 
@@ -66,9 +77,16 @@ void GlQuery::end() {
 #else
   glEndQuery(target_);
 #endif
+  GLOW_STATS_CALL(QUERY);
   started_ = false;
 }
 
+void GlQuery::timestamp() {
+  if (target_ != GL_TIMESTAMP) throw GlQueryError("Only timestamp queries can record a timestamp.");
+  glQueryCounter(id_, GL_TIMESTAMP);
+  GLOW_STATS_CALL(QUERY);
+}
+
 /** \brief retrieve if query result is available. **/
 bool GlQuery::ready() const {
   GLint params;
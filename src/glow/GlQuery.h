@@ -11,13 +11,20 @@ enum class QueryTarget {
   ANY_SAMPLES_PASSED_CONSERVATIVE = GL_ANY_SAMPLES_PASSED_CONSERVATIVE,
   PRIMITIVES_GENERATED = GL_PRIMITIVES_GENERATED,
   TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN = GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN,
-  TIME_ELAPSED = GL_TIME_ELAPSED
+  TIME_ELAPSED = GL_TIME_ELAPSED,
+  TIMESTAMP = GL_TIMESTAMP
 };
 
 /** \brief representation of OpenGL's query object.
  *
  *  A query object can be used to query information about OpenGL context.
  *
+ *  Queries with target TIMESTAMP are not enclosed by begin() and end(), but record the
+ *  GPU time (in nanoseconds) when all previous commands have been completed with timestamp().
+ *
+ *  Retrieving the value of a query blocks until the result is available. Use ready() to check
+ *  if the value can be retrieved without stalling the pipeline.
+ *
  *  \author behley.
  */
 class GlQuery : public GlObject {
@@ -35,10 +42,16 @@ class GlQuery : public GlObject {
   void begin(uint32_t index = 0);
   void end();
 
+  /** \brief record the current GPU time, when all previous commands are processed.
+   *
+   *  Only valid for queries with target TIMESTAMP.
+   **/
+  void timestamp();
+
   /** \brief retrieve if query result is available. **/
   bool ready() const;
 
-  /** \brief get the value of the query with specified type. **/
+  /** \brief get the value of the query with specified type. Blocks until the result is available. **/
   template <class T>
   void value(T& value) const;
 
@@ -51,12 +64,22 @@ class GlQuery : public GlObject {
   GLuint index_{0};
 };
 
+template <>
+void GlQuery::value<int32_t>(int32_t& value) const;
+
+template <>
+void GlQuery::value<uint32_t>(uint32_t& value) const;
+
+template <>
+void GlQuery::value<int64_t>(int64_t& value) const;
+
 template <class T>
 void GlQuery::value(T& value) const {
-  GLint params;
-  glGetQueryObjectiv(id_, GL_QUERY_RESULT, &params);
+  // 64-bit results are needed for TIMESTAMP and TIME_ELAPSED, which easily overflow 32-bit.
+  GLuint64 params = 0;
+  glGetQueryObjectui64v(id_, GL_QUERY_RESULT, &params);
 
-  return T(params);
+  value = T(params);
 }
 
 } /* namespace rv */
@@ -1,37 +1,82 @@
 #include "GlRenderbuffer.h"
 
+#include <sstream>
+
+#include "GlCapabilities.h"
+#include "glexception.h"
+
 namespace glow {
 
-GlRenderbuffer::GlRenderbuffer(uint32_t width, uint32_t height, RenderbufferFormat fmt)
-    : format_(static_cast<GLenum>(fmt)), width_(width), height_(height) {
-  glGenRenderbuffers(1, &id_);
-  ptr_ = std::shared_ptr<GLuint>(new GLuint(id_), [](GLuint* ptr) {
-    glDeleteRenderbuffers(1, ptr);
-    delete ptr;
-  });
-
-  // allocate storage.
-  glBindRenderbuffer(GL_RENDERBUFFER, id_);
-  glRenderbufferStorage(GL_RENDERBUFFER, static_cast<GLenum>(fmt), width_, height_);
-  glBindRenderbuffer(GL_RENDERBUFFER, 0);
+GlRenderbuffer::GlRenderbuffer(uint32_t width, uint32_t height, RenderbufferFormat fmt, uint32_t samples)
+    : format_(static_cast<GLenum>(fmt)), samples_(samples) {
+  if (samples > 0) {
+    uint32_t maxSamples = GlCapabilities::getInstance().get<int32_t>(GL_MAX_SAMPLES);
+    if (samples > maxSamples) {
+      std::stringstream error;
+      error << "Number of samples " << samples << " exceeds GL_MAX_SAMPLES (" << maxSamples << ").";
+      throw GlFramebufferError(error.str());
+    }
+  }
 
-  CheckGlError();
+  storage_->width = width;
+  storage_->height = height;
+  glGenRenderbuffers(1, &storage_->id);
+  GLOW_STATS_CREATED(RENDERBUFFER);
+
+  allocateMemory();
+}
+
+GlRenderbuffer::Storage::~Storage() {
+  if (id == 0) return;
+
+  glDeleteRenderbuffers(1, &id);
+  GLOW_STATS_DESTROYED(RENDERBUFFER);
 }
 
 void GlRenderbuffer::bind() {
-  glBindRenderbuffer(GL_RENDERBUFFER, id_);
+  glBindRenderbuffer(GL_RENDERBUFFER, storage_->id);
+  GLOW_STATS_CALL(BIND_RENDERBUFFER);
 }
 
 void GlRenderbuffer::release() {
   glBindRenderbuffer(GL_RENDERBUFFER, 0);
+  GLOW_STATS_CALL(BIND_RENDERBUFFER);
+}
+
+GLuint GlRenderbuffer::id() const {
+  return storage_->id;
 }
 
 uint32_t GlRenderbuffer::width() const {
-  return width_;
+  return storage_->width;
 }
 
 uint32_t GlRenderbuffer::height() const {
-  return height_;
+  return storage_->height;
+}
+
+uint32_t GlRenderbuffer::samples() const {
+  return samples_;
+}
+
+void GlRenderbuffer::resize(uint32_t width, uint32_t height) {
+  storage_->width = width;
+  storage_->height = height;
+
+  allocateMemory();
+}
+
+void GlRenderbuffer::allocateMemory() {
+  glBindRenderbuffer(GL_RENDERBUFFER, storage_->id);
+  if (samples_ > 0) {
+    glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples_, format_, storage_->width, storage_->height);
+  } else {
+    glRenderbufferStorage(GL_RENDERBUFFER, format_, storage_->width, storage_->height);
+  }
+  GLOW_STATS_CALL(STATE);
+  glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+  CheckGlError();
 }
 
 } /* namespace rv */
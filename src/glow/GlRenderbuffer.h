@@ -8,13 +8,47 @@ namespace glow {
 // forward declarations.
 class GlFramebuffer;
 
+/** \brief renderbuffer formats; only sized formats are required to be color-, depth-, or stencil-renderable. **/
 enum class RenderbufferFormat {
   RGBA = GL_RGBA,
   RGB = GL_RGB,
   RG = GL_RG,
-  R = GL_R,
-  DEPTH = GL_DEPTH,
-  DEPTH_STENCIL = GL_DEPTH24_STENCIL8
+  R = GL_RED,
+  DEPTH = GL_DEPTH_COMPONENT,
+  DEPTH_STENCIL = GL_DEPTH24_STENCIL8,
+
+  R8 = GL_R8,
+  RG8 = GL_RG8,
+  RGBA8 = GL_RGBA8,
+  R16 = GL_R16,
+  RG16 = GL_RG16,
+  RGBA16 = GL_RGBA16,
+  R8UI = GL_R8UI,
+  RG8UI = GL_RG8UI,
+  RGBA8UI = GL_RGBA8UI,
+  R8I = GL_R8I,
+  RG8I = GL_RG8I,
+  RGBA8I = GL_RGBA8I,
+  R16UI = GL_R16UI,
+  RG16UI = GL_RG16UI,
+  RGBA16UI = GL_RGBA16UI,
+  R16I = GL_R16I,
+  RG16I = GL_RG16I,
+  RGBA16I = GL_RGBA16I,
+  R16F = GL_R16F,
+  RG16F = GL_RG16F,
+  RGBA16F = GL_RGBA16F,
+  R32F = GL_R32F,
+  RG32F = GL_RG32F,
+  RGBA32F = GL_RGBA32F,
+  R32I = GL_R32I,
+  RG32I = GL_RG32I,
+  RGBA32I = GL_RGBA32I,
+
+  DEPTH16 = GL_DEPTH_COMPONENT16,
+  DEPTH24 = GL_DEPTH_COMPONENT24,
+  DEPTH32F = GL_DEPTH_COMPONENT32F,
+  DEPTH32F_STENCIL8 = GL_DEPTH32F_STENCIL8
 };
 
 /**
@@ -33,17 +67,48 @@ class GlRenderbuffer : public GlObject {
  public:
   friend class GlFramebuffer;
 
-  GlRenderbuffer(uint32_t width, uint32_t height, RenderbufferFormat fmt = RenderbufferFormat::RGB);
+  /** \brief create renderbuffer with given number of samples per pixel; 0 means no multisampling.
+   *
+   *  Multisample renderbuffers cannot be read directly, but must be resolved with GlFramebuffer::resolveTo.
+   *
+   *  \throws GlFramebufferError if samples exceeds GL_MAX_SAMPLES.
+   **/
+  GlRenderbuffer(uint32_t width, uint32_t height, RenderbufferFormat fmt = RenderbufferFormat::RGB,
+                 uint32_t samples = 0);
 
   void bind() override;
   void release() override;
 
   uint32_t width() const;
   uint32_t height() const;
+  /** \brief number of samples per pixel; 0 without multisampling. **/
+  uint32_t samples() const;
+
+  /** \brief renderbuffer object shared by all copies. **/
+  GLuint id() const override;
+
+  /** \brief reallocate the storage with given dimensions; the content is lost. All copies get the new size. **/
+  void resize(uint32_t width, uint32_t height);
 
  protected:
+  void allocateMemory();
+
+  /** \brief renderbuffer object and its size, which are shared by all copies of the renderbuffer.
+   *
+   *  Thus, a resize of any copy, e.g., by GlFramebuffer::resize, is seen by all copies. The renderbuffer
+   *  object is deleted with the last copy; ptr_ is therefore not used by renderbuffers.
+   **/
+  struct Storage {
+   public:
+    ~Storage();
+
+    GLuint id{0};
+    uint32_t width{0}, height{0};
+  };
+
+  std::shared_ptr<Storage> storage_{std::make_shared<Storage>()};
   GLenum format_;
-  uint32_t width_, height_;
+  uint32_t samples_;
 };
 
 } /* namespace rv */
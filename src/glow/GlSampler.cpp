@@ -1,23 +1,137 @@
 #include "GlSampler.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+
 namespace glow {
 
+GlSamplerDesc GlSamplerDesc::withFilter(TexMinOp minifyingOperation, TexMagOp magnifyingOperation) const {
+  GlSamplerDesc desc(*this);
+  desc.minify_ = minifyingOperation;
+  desc.magnify_ = magnifyingOperation;
+
+  return desc;
+}
+
+GlSamplerDesc GlSamplerDesc::withWrap(TexWrapOp wrap) const {
+  return withWrap(wrap, wrap, wrap);
+}
+
+GlSamplerDesc GlSamplerDesc::withWrap(TexWrapOp wrap_s, TexWrapOp wrap_t, TexWrapOp wrap_r) const {
+  GlSamplerDesc desc(*this);
+  desc.wrap_[0] = wrap_s;
+  desc.wrap_[1] = wrap_t;
+  desc.wrap_[2] = wrap_r;
+
+  return desc;
+}
+
+GlSamplerDesc GlSamplerDesc::withCompare(GLenum func) const {
+  GlSamplerDesc desc(*this);
+  desc.compare_ = func;
+
+  return desc;
+}
+
+GlSamplerDesc GlSamplerDesc::withLod(float minLod, float maxLod) const {
+  GlSamplerDesc desc(*this);
+  desc.minLod_ = minLod;
+  desc.maxLod_ = maxLod;
+
+  return desc;
+}
+
+bool GlSamplerDesc::operator==(const GlSamplerDesc& other) const {
+  return minify_ == other.minify_ && magnify_ == other.magnify_ && wrap_[0] == other.wrap_[0] &&
+         wrap_[1] == other.wrap_[1] && wrap_[2] == other.wrap_[2] && compare_ == other.compare_ &&
+         minLod_ == other.minLod_ && maxLod_ == other.maxLod_;
+}
+
+bool GlSamplerDesc::operator!=(const GlSamplerDesc& other) const {
+  return !(*this == other);
+}
+
+size_t GlSamplerDesc::hash() const {
+  GLenum values[] = {static_cast<GLenum>(minify_),  static_cast<GLenum>(magnify_), static_cast<GLenum>(wrap_[0]),
+                     static_cast<GLenum>(wrap_[1]), static_cast<GLenum>(wrap_[2]), compare_};
+
+  size_t h = 0;
+  for (GLenum value : values) h = h * 31 + value;
+  h = h * 31 + std::hash<float>()(minLod_);
+  h = h * 31 + std::hash<float>()(maxLod_);
+
+  return h;
+}
+
+std::vector<GLuint> GlSampler::boundSamplers_;
+
 GlSampler::GlSampler() {
   glGenSamplers(1, &id_);
+  GLOW_STATS_CREATED(SAMPLER);
   ptr_ = std::shared_ptr<GLuint>(new GLuint(id_), [](GLuint* ptr) {
+    // deleted samplers are unbound; thus, a new sampler with the same id must be bound again.
+    std::replace(boundSamplers_.begin(), boundSamplers_.end(), *ptr, 0u);
     glDeleteSamplers(1, ptr);
+    GLOW_STATS_DESTROYED(SAMPLER);
     delete ptr;
   });
 }
 
+GlSampler::GlSampler(const GlSamplerDesc& desc) : GlSampler() {
+  setMinifyingOperation(desc.minifyingOperation());
+  setMagnifyingOperation(desc.magnifyingOperation());
+  setWrapOperation(desc.wrapS(), desc.wrapT(), desc.wrapR());
+
+  GLenum mode = (desc.compareFunc() == GL_NONE) ? GL_NONE : GL_COMPARE_REF_TO_TEXTURE;
+  glSamplerParameteri(id_, GL_TEXTURE_COMPARE_MODE, mode);
+  GLOW_STATS_CALL(STATE);
+  if (mode != GL_NONE) {
+    glSamplerParameteri(id_, GL_TEXTURE_COMPARE_FUNC, desc.compareFunc());
+    GLOW_STATS_CALL(STATE);
+  }
+  glSamplerParameterf(id_, GL_TEXTURE_MIN_LOD, desc.minLod());
+  GLOW_STATS_CALL(STATE);
+  glSamplerParameterf(id_, GL_TEXTURE_MAX_LOD, desc.maxLod());
+  GLOW_STATS_CALL(STATE);
+}
+
 /** \brief use sampler for specific texture unit identified by its index (0, 1, ...). **/
-void GlSampler::bind(uint32_t textureUnitId) {
+void GlSampler::bind(uint32_t textureUnitId) const {
+  if (textureUnitId < boundSamplers_.size() && boundSamplers_[textureUnitId] == id_) {
+    GLOW_STATS_REDUNDANT_BIND();
+    return;
+  }
+  if (textureUnitId >= boundSamplers_.size()) boundSamplers_.resize(textureUnitId + 1, 0);
+
   glBindSampler(static_cast<GLuint>(textureUnitId), id_);
+  GLOW_STATS_CALL(BIND_SAMPLER);
+  boundSamplers_[textureUnitId] = id_;
+}
+
+void GlSampler::bind(uint32_t first, uint32_t count) const {
+  if (first + count > boundSamplers_.size()) boundSamplers_.resize(first + count, 0);
+  if (std::count(boundSamplers_.begin() + first, boundSamplers_.begin() + first + count, id_) ==
+      static_cast<std::ptrdiff_t>(count)) {
+    GLOW_STATS_REDUNDANT_BIND();
+    return;
+  }
+
+#if __GL_VERSION >= 440L
+  std::vector<GLuint> ids(count, id_);
+  glBindSamplers(first, count, &ids[0]);
+  GLOW_STATS_CALL(BIND_SAMPLER);
+  std::fill(boundSamplers_.begin() + first, boundSamplers_.begin() + first + count, id_);
+#else
+  for (uint32_t unit = first; unit < first + count; ++unit) bind(unit);
+#endif
 }
 
 /** \brief "unuse" sampler for given texture unit.  **/
-void GlSampler::release(uint32_t textureUnitId) {
+void GlSampler::release(uint32_t textureUnitId) const {
   glBindSampler(static_cast<GLuint>(textureUnitId), 0);
+  GLOW_STATS_CALL(BIND_SAMPLER);
+  if (textureUnitId < boundSamplers_.size()) boundSamplers_[textureUnitId] = 0;
 }
 
 void GlSampler::bind() {
@@ -28,25 +142,33 @@ void GlSampler::release() {
 
 void GlSampler::setMinifyingOperation(TexMinOp minifyingOperation) {
   glSamplerParameteri(id_, GL_TEXTURE_MIN_FILTER, static_cast<GLenum>(minifyingOperation));
+  GLOW_STATS_CALL(STATE);
 }
 
 void GlSampler::setMagnifyingOperation(TexMagOp magnifyingOperation) {
   glSamplerParameteri(id_, GL_TEXTURE_MAG_FILTER, static_cast<GLenum>(magnifyingOperation));
+  GLOW_STATS_CALL(STATE);
 }
 
 void GlSampler::setWrapOperation(TexWrapOp wrap_s) {
   glSamplerParameteri(id_, GL_TEXTURE_WRAP_S, static_cast<GLenum>(wrap_s));
+  GLOW_STATS_CALL(STATE);
 }
 
 void GlSampler::setWrapOperation(TexWrapOp wrap_s, TexWrapOp wrap_t) {
   glSamplerParameteri(id_, GL_TEXTURE_WRAP_S, static_cast<GLenum>(wrap_s));
+  GLOW_STATS_CALL(STATE);
   glSamplerParameteri(id_, GL_TEXTURE_WRAP_T, static_cast<GLenum>(wrap_t));
+  GLOW_STATS_CALL(STATE);
 }
 
 void GlSampler::setWrapOperation(TexWrapOp wrap_s, TexWrapOp wrap_t, TexWrapOp wrap_r) {
   glSamplerParameteri(id_, GL_TEXTURE_WRAP_S, static_cast<GLenum>(wrap_s));
+  GLOW_STATS_CALL(STATE);
   glSamplerParameteri(id_, GL_TEXTURE_WRAP_T, static_cast<GLenum>(wrap_t));
+  GLOW_STATS_CALL(STATE);
   glSamplerParameteri(id_, GL_TEXTURE_WRAP_R, static_cast<GLenum>(wrap_r));
+  GLOW_STATS_CALL(STATE);
 }
 
 } /* namespace rv */
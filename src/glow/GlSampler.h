@@ -1,19 +1,76 @@
 #ifndef INCLUDE_RV_GLSAMPLER_H_
 #define INCLUDE_RV_GLSAMPLER_H_
 
+#include <stddef.h>
+#include <vector>
+
 #include "GlObject.h"
 #include "GlTexture.h"
 
 namespace glow {
 
+/** \brief immutable description of the sampling state of a sampler object.
+ *
+ *  Descriptions are compared and hashed by value, e.g., by the GlSamplerCache. Instead of setters, the
+ *  with* functions return a modified copy:
+ *
+ *    GlSamplerDesc desc = GlSamplerDesc().withFilter(TexMinOp::NEAREST, TexMagOp::NEAREST);
+ *
+ *  The default description has the sampling state of a newly created GlTexture, i.e., LINEAR filtering and
+ *  REPEAT wrapping, and no depth comparison.
+ **/
+class GlSamplerDesc {
+ public:
+  /** \brief hash of the description for unordered containers. **/
+  struct Hash {
+   public:
+    size_t operator()(const GlSamplerDesc& desc) const {
+      return desc.hash();
+    }
+  };
+
+  GlSamplerDesc withFilter(TexMinOp minifyingOperation, TexMagOp magnifyingOperation) const;
+  /** \brief same wrapping function for all coordinates. **/
+  GlSamplerDesc withWrap(TexWrapOp wrap) const;
+  GlSamplerDesc withWrap(TexWrapOp wrap_s, TexWrapOp wrap_t, TexWrapOp wrap_r) const;
+  /** \brief compare depth values with the reference value by func, e.g., GL_LEQUAL; GL_NONE disables comparison. **/
+  GlSamplerDesc withCompare(GLenum func) const;
+  /** \brief clamp the level of detail to [minLod, maxLod]. **/
+  GlSamplerDesc withLod(float minLod, float maxLod) const;
+
+  TexMinOp minifyingOperation() const { return minify_; }
+  TexMagOp magnifyingOperation() const { return magnify_; }
+  TexWrapOp wrapS() const { return wrap_[0]; }
+  TexWrapOp wrapT() const { return wrap_[1]; }
+  TexWrapOp wrapR() const { return wrap_[2]; }
+  GLenum compareFunc() const { return compare_; }
+  float minLod() const { return minLod_; }
+  float maxLod() const { return maxLod_; }
+
+  bool operator==(const GlSamplerDesc& other) const;
+  bool operator!=(const GlSamplerDesc& other) const;
+
+  size_t hash() const;
+
+ protected:
+  TexMinOp minify_{TexMinOp::LINEAR};
+  TexMagOp magnify_{TexMagOp::LINEAR};
+  TexWrapOp wrap_[3]{TexWrapOp::REPEAT, TexWrapOp::REPEAT, TexWrapOp::REPEAT};
+  GLenum compare_{GL_NONE};
+  float minLod_{-1000.0f}, maxLod_{1000.0f};  // defaults of OpenGL.
+};
+
 /** \brief Representation of OpenGL's sampler object for texture sampling options.
  *
  *  Usually, you can specify the texture sampling options right with the texture itself. However,
  *  sometimes it would be nice to have sampling parameters in one place or different sampling
  *  parameters for the same texture. This is exactly the use case of sampler objects: if a sampler
- *  object is bound to a specified texture unit,
+ *  object is bound to a specified texture unit, its parameters are used instead of the parameters of the
+ *  texture bound to that unit.
+ *
+ *  Samplers with the same parameters should be shared; use the GlSamplerCache to get a sampler for a
+ *  GlSamplerDesc. Binding a sampler to a unit, where it is already bound, is skipped.
  *
- *  TODO: have bind with multiple texture units. (glBindSamplers?)
  *  TODO: Ensure consistent setting of sampler for TEXTURE_RECTANGLE?
  *
  *  \author behley
@@ -21,12 +78,17 @@ namespace glow {
 class GlSampler : public GlObject {
  public:
   GlSampler();
+  /** \brief sampler with the sampling state of the given description. **/
+  explicit GlSampler(const GlSamplerDesc& desc);
 
   /** \brief use sampler for specific texture unit identified by its index (0, 1, ...). **/
-  void bind(uint32_t textureUnitId);
+  void bind(uint32_t textureUnitId) const;
+
+  /** \brief use sampler for count texture units starting with first (glBindSamplers with OpenGL 4.4). **/
+  void bind(uint32_t first, uint32_t count) const;
 
   /** \brief "unuse" sampler for given texture unit.  **/
-  void release(uint32_t textureUnitId);
+  void release(uint32_t textureUnitId) const;
 
   /** \brief set the filtering operation if texture is projected on smaller elements (squashed). **/
   void setMinifyingOperation(TexMinOp minifyingOperation);
@@ -45,6 +107,9 @@ class GlSampler : public GlObject {
   void release() override;
 
   uint32_t boundUnit_{0};
+
+  // sampler bound to each texture unit by a GlSampler.
+  static std::vector<GLuint> boundSamplers_;
 };
 }
 /* namespace rv */
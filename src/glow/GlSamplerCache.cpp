@@ -0,0 +1,32 @@
+#include "GlSamplerCache.h"
+
+namespace glow {
+
+GlSamplerCache::GlSamplerCache() {}
+
+GlSamplerCache& GlSamplerCache::getInstance() {
+  static std::unique_ptr<GlSamplerCache> instance(new GlSamplerCache());
+
+  return *instance;
+}
+
+std::shared_ptr<const GlSampler> GlSamplerCache::get(const GlSamplerDesc& desc) {
+  std::shared_ptr<const GlSampler>& sampler = samplers_[desc];
+  if (sampler == nullptr) sampler = std::make_shared<GlSampler>(desc);
+
+  return sampler;
+}
+
+void GlSamplerCache::bind(uint32_t unit, const GlSamplerDesc& desc) {
+  get(desc)->bind(unit);
+}
+
+uint32_t GlSamplerCache::size() const {
+  return samplers_.size();
+}
+
+void GlSamplerCache::clear() {
+  samplers_.clear();
+}
+
+} /* namespace glow */
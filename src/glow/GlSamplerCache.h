@@ -0,0 +1,54 @@
+#ifndef INCLUDE_GLOW_GLSAMPLERCACHE_H_
+#define INCLUDE_GLOW_GLSAMPLERCACHE_H_
+
+#include <stdint.h>
+#include <memory>
+#include <unordered_map>
+
+#include "GlSampler.h"
+
+namespace glow {
+
+/** \brief Cache of sampler objects, where every distinct sampling state has exactly one sampler.
+ *
+ *  Instead of creating and configuring an own GlSampler, e.g., for every helper pass, the sampler for a
+ *  GlSamplerDesc is requested from the cache:
+ *
+ *    GlSamplerCache::getInstance().bind(0, GlSamplerDesc().withFilter(TexMinOp::NEAREST, TexMagOp::NEAREST));
+ *
+ *  The sampler is created with the first request and then shared by all users of the same description. Since
+ *  it is the same sampler object, a bind to a unit, where it is already bound, is skipped (see GlSampler).
+ *  Cached samplers are const, since changing the state of a shared sampler would change it for all users;
+ *  a different state needs a different description.
+ *
+ *  The cache is a singleton and therefore can be only accessed via the getInstance() method. As the cached
+ *  samplers belong to the current OpenGL context, the cache must be cleared before the context is destroyed.
+ **/
+class GlSamplerCache {
+ public:
+  /** \brief get cache instance. **/
+  static GlSamplerCache& getInstance();
+
+  /** \brief get sampler with the sampling state of the given description; created by the first request. **/
+  std::shared_ptr<const GlSampler> get(const GlSamplerDesc& desc);
+
+  /** \brief bind sampler of the given description to the texture unit. **/
+  void bind(uint32_t unit, const GlSamplerDesc& desc);
+
+  /** \brief number of cached samplers. **/
+  uint32_t size() const;
+
+  /** \brief remove all cached samplers; samplers still used elsewhere stay valid. **/
+  void clear();
+
+ protected:
+  GlSamplerCache();
+  GlSamplerCache(const GlSamplerCache&);
+  GlSamplerCache& operator=(const GlSamplerCache&);
+
+  std::unordered_map<GlSamplerDesc, std::shared_ptr<const GlSampler>, GlSamplerDesc::Hash> samplers_;
+};
+
+} /* namespace glow */
+
+#endif /* INCLUDE_GLOW_GLSAMPLERCACHE_H_ */
@@ -33,8 +33,10 @@ GlShader::GlShader(const ShaderType& type, const std::string& source, bool useCa
     throw GlShaderError(std::string(&error_string[0], log_size));
   }
 
+  GLOW_STATS_CREATED(SHADER);
   ptr_ = std::shared_ptr<GLuint>(new GLuint(id_), [](GLuint* ptr) {
     glDeleteShader(*ptr);
+    GLOW_STATS_DESTROYED(SHADER);
     delete ptr;
   });
 }
@@ -0,0 +1,351 @@
+#include "GlSnapshotWriter.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#include "GlStats.h"
+#include "glexception.h"
+#include "glutil.h"
+
+namespace glow {
+
+/** \brief is the machine little-endian? **/
+inline bool little_endian() {
+  const uint16_t one = 1;
+  return *reinterpret_cast<const uint8_t*>(&one) == 1;
+}
+
+/** \brief append 16 bit value in little-endian byte order. **/
+inline void append_uint16(std::vector<uint8_t>& data, uint32_t value) {
+  data.push_back(value & 0xff);
+  data.push_back((value >> 8) & 0xff);
+}
+
+/** \brief run-length encode a row of pixels with pixelSize bytes into TGA packets. **/
+inline void encode_tga_row(const uint8_t* row, uint32_t width, uint32_t pixelSize, std::vector<uint8_t>& packets) {
+  auto same = [row, pixelSize](uint32_t a, uint32_t b) {
+    return std::memcmp(row + a * pixelSize, row + b * pixelSize, pixelSize) == 0;
+  };
+
+  uint32_t x = 0;
+  while (x < width) {
+    uint32_t run = 1;
+    while (x + run < width && run < 128 && same(x, x + run)) ++run;
+
+    if (run > 1) {
+      packets.push_back(0x80 | (run - 1));
+      packets.insert(packets.end(), row + x * pixelSize, row + (x + 1) * pixelSize);
+    } else {
+      // raw packet up to the start of the next run.
+      run = 1;
+      while (x + run < width && run < 128 && !(x + run + 1 < width && same(x + run, x + run + 1))) ++run;
+      packets.push_back(run - 1);
+      packets.insert(packets.end(), row + x * pixelSize, row + (x + run) * pixelSize);
+    }
+    x += run;
+  }
+}
+
+GlSnapshotWriter::GlSnapshotWriter(uint32_t numThreads, uint32_t maxQueued) : slots_(maxQueued), maxQueued_(maxQueued) {
+  if (numThreads == 0 || maxQueued == 0) {
+    throw GlTextureError("Snapshot writer needs at least one thread and one queued snapshot.");
+  }
+
+  for (Slot& slot : slots_) {
+    glGenBuffers(1, &slot.buffer);
+    GLOW_STATS_CREATED(BUFFER);
+  }
+
+  for (uint32_t i = 0; i < numThreads; ++i) workers_.push_back(std::thread(&GlSnapshotWriter::run, this));
+}
+
+GlSnapshotWriter::~GlSnapshotWriter() {
+  finish();
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cond_.notify_all();
+  for (std::thread& worker : workers_) worker.join();
+
+  for (Slot& slot : slots_) {
+    if (slot.fence != 0) glDeleteSync(slot.fence);
+    glDeleteBuffers(1, &slot.buffer);
+    GLOW_STATS_DESTROYED(BUFFER);
+  }
+}
+
+bool GlSnapshotWriter::write(const GlTexture& texture, const std::string& filename) {
+  PixelFormat pixelfmt;
+  PixelType type;
+  if (!fileFormat(filename, texture.format_, pixelfmt, type)) {
+    throw GlTextureError("Unable to write texture to file '" + filename + "': unsupported file type or format.");
+  }
+  if (texture.target_ != GL_TEXTURE_1D && texture.target_ != GL_TEXTURE_2D &&
+      texture.target_ != GL_TEXTURE_RECTANGLE) {
+    throw GlTextureError("Only 1D, 2D, and rectangle textures can be written to files.");
+  }
+
+  update();
+
+  Slot* slot = nullptr;
+  for (Slot& s : slots_) {
+    if (s.fence == 0) {
+      slot = &s;
+      break;
+    }
+  }
+  if (slot == nullptr) {
+    dropped_ += 1;
+    return false;
+  }
+
+  uint32_t width = texture.width();
+  uint32_t height = std::max<uint32_t>(texture.height(), 1);
+  size_t size = static_cast<size_t>(width) * height * pixelComponents(pixelfmt) * pixelTypeSize(type);
+
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, slot->buffer);
+  if (size > slot->capacity) {
+    glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+    slot->capacity = size;
+  }
+
+  // with a bound pack buffer, the download only starts the transfer into the buffer.
+  try {
+    texture.download(pixelfmt, type, nullptr, PixelStore::tight());
+  } catch (...) {
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    throw;
+  }
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  slot->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+  slot->snapshot.filename = filename;
+  slot->snapshot.width = width;
+  slot->snapshot.height = height;
+  slot->snapshot.pixelfmt = pixelfmt;
+  slot->snapshot.type = type;
+
+  return true;
+}
+
+void GlSnapshotWriter::update() {
+  for (Slot& slot : slots_) collect(slot, false);
+}
+
+void GlSnapshotWriter::finish() {
+  for (Slot& slot : slots_) collect(slot, true);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  cond_.wait(lock, [this] { return jobs_.empty() && encoding_ == 0; });
+}
+
+uint32_t GlSnapshotWriter::pending() const {
+  uint32_t count = 0;
+  for (const Slot& slot : slots_) {
+    if (slot.fence != 0) count += 1;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  return count + jobs_.size() + encoding_;
+}
+
+uint32_t GlSnapshotWriter::dropped() const {
+  return dropped_;
+}
+
+uint32_t GlSnapshotWriter::failed() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return failed_;
+}
+
+bool GlSnapshotWriter::fileFormat(const std::string& filename, TextureFormat format, PixelFormat& pixelfmt,
+                                  PixelType& type) {
+  TextureFormatInfo info = textureFormatInfo(format);
+  // integer values have no meaningful image representation; stencil values cannot be read as color.
+  if (info.integer || info.pixelFormat == GL_DEPTH_STENCIL) return false;
+
+  bool depth = (info.pixelFormat == GL_DEPTH_COMPONENT);
+  PixelFormat gray = depth ? PixelFormat::DEPTH : PixelFormat::R;
+
+  std::string ext = glow::extension(filename);
+  if (ext == ".ppm" && !depth) {
+    pixelfmt = PixelFormat::RGB;
+    type = PixelType::UNSIGNED_BYTE;
+  } else if (ext == ".pgm") {
+    pixelfmt = gray;
+    type = PixelType::UNSIGNED_BYTE;
+  } else if (ext == ".pfm") {
+    pixelfmt = (depth || info.components == 1) ? gray : PixelFormat::RGB;
+    type = PixelType::FLOAT;
+  } else if (ext == ".tga") {
+    pixelfmt = (depth || info.components == 1) ? gray : (info.components == 4) ? PixelFormat::BGRA : PixelFormat::BGR;
+    type = PixelType::UNSIGNED_BYTE;
+  } else if (ext == ".raw") {
+    pixelfmt = pixelFormatOf(info, info.components);
+    switch (info.pixelType) {
+      case GL_UNSIGNED_BYTE:
+      case GL_UNSIGNED_SHORT:
+      case GL_HALF_FLOAT:
+        type = static_cast<PixelType>(info.pixelType);
+        break;
+      default:
+        type = PixelType::FLOAT;
+    }
+  } else {
+    return false;
+  }
+
+  return true;
+}
+
+bool GlSnapshotWriter::encode(const std::string& filename, uint32_t width, uint32_t height, PixelFormat pixelfmt,
+                              PixelType type, const void* pixels) {
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(pixels);
+  uint32_t components = pixelComponents(pixelfmt);
+  size_t rowSize = static_cast<size_t>(width) * components * pixelTypeSize(type);
+
+  std::ofstream out(filename.c_str(), std::ios::binary);
+  if (!out.is_open()) return false;
+
+  std::string ext = glow::extension(filename);
+  if (ext == ".ppm" || ext == ".pgm") {
+    if (type != PixelType::UNSIGNED_BYTE || (components != 1 && components != 3)) return false;
+
+    out << ((components == 3) ? "P6" : "P5") << "\n" << width << " " << height << "\n255\n";
+    // first row of the file is the top row.
+    for (uint32_t y = height; y > 0; --y) out.write(reinterpret_cast<const char*>(data + (y - 1) * rowSize), rowSize);
+  } else if (ext == ".pfm") {
+    if (type != PixelType::FLOAT || (components != 1 && components != 3)) return false;
+
+    // negative scale marks little-endian values; rows are stored from the bottom to the top.
+    out << ((components == 3) ? "PF" : "Pf") << "\n" << width << " " << height << "\n";
+    out << (little_endian() ? "-1.0" : "1.0") << "\n";
+    out.write(reinterpret_cast<const char*>(data), rowSize * height);
+  } else if (ext == ".tga") {
+    if (type != PixelType::UNSIGNED_BYTE || components == 2 || width > 65535 || height > 65535) return false;
+
+    // run-length encoded true-color (10) or gray (11) image; the origin is the bottom-left corner.
+    std::vector<uint8_t> header{0, 0, static_cast<uint8_t>((components == 1) ? 11 : 10), 0, 0, 0, 0, 0};
+    append_uint16(header, 0);
+    append_uint16(header, 0);
+    append_uint16(header, width);
+    append_uint16(header, height);
+    header.push_back(8 * components);
+    header.push_back((components == 4) ? 8 : 0);  // bits of the alpha channel.
+    out.write(reinterpret_cast<const char*>(&header[0]), header.size());
+
+    std::vector<uint8_t> packets;
+    packets.reserve(rowSize + rowSize / 128 + 1);
+    for (uint32_t y = 0; y < height; ++y) {
+      packets.clear();
+      encode_tga_row(data + y * rowSize, width, components, packets);
+      out.write(reinterpret_cast<const char*>(&packets[0]), packets.size());
+    }
+  } else if (ext == ".raw") {
+    std::string name;
+    switch (type) {
+      case PixelType::UNSIGNED_BYTE:
+        name = "u8";
+        break;
+      case PixelType::UNSIGNED_SHORT:
+        name = "u16";
+        break;
+      case PixelType::HALF_FLOAT:
+        name = "f16";
+        break;
+      case PixelType::FLOAT:
+        name = "f32";
+        break;
+      default:
+        return false;
+    }
+
+    out << "GLOWRAW " << width << " " << height << " " << components << " " << name << "\n";
+    out.write(reinterpret_cast<const char*>(data), rowSize * height);
+  } else {
+    return false;
+  }
+
+  out.close();
+  return !out.fail();
+}
+
+bool GlSnapshotWriter::collect(Slot& slot, bool wait) {
+  if (slot.fence == 0) return true;
+
+  {
+    // only the GL thread adds snapshots; thus, the queue keeps its room after releasing the lock.
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (jobs_.size() >= maxQueued_) {
+      if (!wait) return false;
+      cond_.wait(lock, [this] { return jobs_.size() < maxQueued_; });
+    }
+  }
+
+  GLenum result = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+  while (wait && result == GL_TIMEOUT_EXPIRED) {
+    result = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);  // 1 ms.
+  }
+
+  if (result == GL_WAIT_FAILED) throw GlTextureError("Waiting for texture read back failed.");
+  if (result == GL_TIMEOUT_EXPIRED) return false;
+
+  glDeleteSync(slot.fence);
+  slot.fence = 0;
+
+  // the transfer is finished; thus, mapping does not stall.
+  Snapshot& snapshot = slot.snapshot;
+  size_t size = static_cast<size_t>(snapshot.width) * snapshot.height * pixelComponents(snapshot.pixelfmt) *
+                pixelTypeSize(snapshot.type);
+  snapshot.pixels.resize(size);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+  const void* ptr = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+  if (ptr != nullptr) {
+    std::memcpy(&snapshot.pixels[0], ptr, size);
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+  }
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  CheckGlError();
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (ptr != nullptr) {
+      jobs_.push_back(std::move(snapshot));
+    } else {
+      failed_ += 1;
+    }
+  }
+  cond_.notify_all();
+
+  return true;
+}
+
+void GlSnapshotWriter::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  while (true) {
+    cond_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+    if (jobs_.empty()) return;
+
+    Snapshot snapshot = std::move(jobs_.front());
+    jobs_.pop_front();
+    encoding_ += 1;
+    // the GL thread may wait for room in the queue.
+    cond_.notify_all();
+
+    // encode and write without holding the lock.
+    lock.unlock();
+    bool written = encode(snapshot.filename, snapshot.width, snapshot.height, snapshot.pixelfmt, snapshot.type,
+                          &snapshot.pixels[0]);
+    lock.lock();
+
+    encoding_ -= 1;
+    if (!written) failed_ += 1;
+    cond_.notify_all();
+  }
+}
+
+} /* namespace glow */
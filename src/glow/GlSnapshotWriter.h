@@ -0,0 +1,126 @@
+#ifndef INCLUDE_GLOW_GLSNAPSHOTWRITER_H_
+#define INCLUDE_GLOW_GLSNAPSHOTWRITER_H_
+
+#include <stdint.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "GlTexture.h"
+
+namespace glow {
+
+/** \brief Writes textures to image files without stalling the GL thread, e.g., to dump debug frames.
+ *
+ *  write() only starts the read back of the texture into a pixel pack buffer (PBO) and sets a fence.
+ *  When the fence is signaled, i.e., in a later write() or update(), the pixels are handed to a pool of
+ *  threads, which encode and write the file. Thus, the GL thread neither waits for the GPU nor for the disk:
+ *
+ *    GlSnapshotWriter writer;
+ *    while (rendering) {
+ *      ...
+ *      writer.write(texture, "frame" + std::to_string(frame) + ".ppm");
+ *    }
+ *    writer.finish();
+ *
+ *  At most maxQueued snapshots are read back and at most maxQueued snapshots wait for the threads. If the
+ *  threads cannot keep up, write() drops the snapshot and returns false instead of blocking.
+ *
+ *  The file type is inferred from the extension (see fileFormat):
+ *  - .ppm, .pgm: binary 8 bit RGB or gray image, read back as GL_UNSIGNED_BYTE.
+ *  - .pfm: RGB or gray float image.
+ *  - .tga: run-length encoded 8 bit BGR(A) or gray image, read back as GL_UNSIGNED_BYTE.
+ *  - .raw: raw file with the components and type of the texture (see GlImageFile).
+ *
+ *  All files can be loaded again by GlTexture::loadTexture, except for TGA files.
+ **/
+class GlSnapshotWriter {
+ public:
+  /** \brief writer with given number of threads and maximal number of queued snapshots. **/
+  explicit GlSnapshotWriter(uint32_t numThreads = 2, uint32_t maxQueued = 4);
+  /** \brief waits until all snapshots are written. **/
+  ~GlSnapshotWriter();
+
+  GlSnapshotWriter(const GlSnapshotWriter&) = delete;
+  GlSnapshotWriter& operator=(const GlSnapshotWriter&) = delete;
+
+  /** \brief start read back of level 0 of a 1D, 2D, or rectangle texture, which is then written to the file.
+   *
+   *  \return false, if the snapshot was dropped, since all read back buffers are in use.
+   *  \throws GlTextureError if the texture cannot be written to a file of this type.
+   **/
+  bool write(const GlTexture& texture, const std::string& filename);
+
+  /** \brief hand finished read backs to the threads without waiting. Also called by every write(). **/
+  void update();
+
+  /** \brief wait until all snapshots are written to their files. **/
+  void finish();
+
+  /** \brief number of snapshots, which are not yet written. **/
+  uint32_t pending() const;
+  /** \brief number of snapshots dropped by write(). **/
+  uint32_t dropped() const;
+  /** \brief number of files, which could not be written. **/
+  uint32_t failed() const;
+
+  /** \brief pixel format and type read back for a texture of given format, which is written to filename.
+   *
+   *  \return false, if the file type is not supported or cannot hold values of the texture format.
+   **/
+  static bool fileFormat(const std::string& filename, TextureFormat format, PixelFormat& pixelfmt,
+                         PixelType& type);
+
+  /** \brief encode and write pixels on the calling thread.
+   *
+   *  The pixels must have pixel format and type of fileFormat(); rows are tightly packed and stored from
+   *  the bottom to the top like the rows of a texture.
+   *
+   *  \return true, if the file could be written; false, otherwise.
+   **/
+  static bool encode(const std::string& filename, uint32_t width, uint32_t height, PixelFormat pixelfmt,
+                     PixelType type, const void* pixels);
+
+ protected:
+  struct Snapshot {
+   public:
+    std::string filename;
+    uint32_t width{0}, height{0};
+    PixelFormat pixelfmt{PixelFormat::RGB};
+    PixelType type{PixelType::UNSIGNED_BYTE};
+    std::vector<uint8_t> pixels;
+  };
+
+  struct Slot {
+   public:
+    GLuint buffer{0};
+    size_t capacity{0};
+    GLsync fence{0};  // 0, if the slot is free.
+    Snapshot snapshot;
+  };
+
+  /** \brief queue read back of the slot for the threads, if finished and the queue has room. **/
+  bool collect(Slot& slot, bool wait);
+
+  void run();
+
+  std::vector<Slot> slots_;
+  uint32_t maxQueued_;
+  uint32_t dropped_{0};
+
+  // thread pool.
+  mutable std::mutex mutex_;
+  std::condition_variable cond_;
+  std::vector<std::thread> workers_;
+  std::deque<Snapshot> jobs_;
+  uint32_t encoding_{0};  // snapshots taken by the threads, but not yet written.
+  uint32_t failed_{0};
+  bool stop_{false};
+};
+
+} /* namespace glow */
+
+#endif /* INCLUDE_GLOW_GLSNAPSHOTWRITER_H_ */
@@ -1,36 +1,169 @@
 #include "GlState.h"
 
+#include <algorithm>
 #include <sstream>
 #include <cassert>
 #include <cmath>
 
 namespace glow {
 
+/** \brief type and number of values of a state variable known to GlState. **/
+struct GlStateVariableInfo {
+  GLenum name;
+  GlState::GlStateVariable::DataType type;
+  uint32_t size;
+};
+
+// see also: https://www.opengl.org/wiki/GLAPI/glGet
+static const GlStateVariableInfo stateVariables[] = {
+    // Buffer binding state.
+    {GL_ARRAY_BUFFER_BINDING, GlState::GlStateVariable::INT, 1},
+    {GL_ELEMENT_ARRAY_BUFFER_BINDING, GlState::GlStateVariable::INT, 1},
+#if __GL_VERSION >= 400L
+    {GL_DRAW_INDIRECT_BUFFER_BINDING, GlState::GlStateVariable::INT, 1},
+#endif
+#if __GL_VERSION >= 440L
+    {GL_QUERY_BUFFER_BINDING, GlState::GlStateVariable::INT, 1},
+#endif
+
+    // Framebuffers.
+    {GL_COLOR_CLEAR_VALUE, GlState::GlStateVariable::FLOAT, 4},
+    {GL_DEPTH_CLEAR_VALUE, GlState::GlStateVariable::FLOAT, 1},
+    {GL_DEPTH_FUNC, GlState::GlStateVariable::INT, 1},
+    {GL_DEPTH_TEST, GlState::GlStateVariable::BOOL, 1},
+    {GL_DEPTH_WRITEMASK, GlState::GlStateVariable::BOOL, 1},
+    {GL_DRAW_BUFFER, GlState::GlStateVariable::INT, 1},
+    {GL_DRAW_FRAMEBUFFER_BINDING, GlState::GlStateVariable::INT, 1},
+    {GL_READ_FRAMEBUFFER_BINDING, GlState::GlStateVariable::INT, 1},
+    {GL_RENDERBUFFER_BINDING, GlState::GlStateVariable::INT, 1},
+
+    // Pixel Operations.
+    {GL_BLEND, GlState::GlStateVariable::BOOL, 1},
+    {GL_BLEND_COLOR, GlState::GlStateVariable::FLOAT, 4},
+    {GL_BLEND_SRC_RGB, GlState::GlStateVariable::INT, 1},
+    {GL_BLEND_DST_RGB, GlState::GlStateVariable::INT, 1},
+    {GL_BLEND_SRC_ALPHA, GlState::GlStateVariable::INT, 1},
+    {GL_BLEND_DST_ALPHA, GlState::GlStateVariable::INT, 1},
+
+    // Programs.
+    {GL_CURRENT_PROGRAM, GlState::GlStateVariable::INT, 1},
+    {GL_PROGRAM_PIPELINE_BINDING, GlState::GlStateVariable::INT, 1},
+
+    // Rasterization.
+    {GL_CULL_FACE, GlState::GlStateVariable::BOOL, 1},
+    {GL_CULL_FACE_MODE, GlState::GlStateVariable::INT, 1},
+    {GL_FRONT_FACE, GlState::GlStateVariable::INT, 1},
+    {GL_LINE_SMOOTH, GlState::GlStateVariable::BOOL, 1},
+    {GL_LINE_WIDTH, GlState::GlStateVariable::FLOAT, 1},
+    {GL_POINT_FADE_THRESHOLD_SIZE, GlState::GlStateVariable::FLOAT, 1},
+    {GL_POINT_SIZE, GlState::GlStateVariable::FLOAT, 1},
+    {GL_POINT_SIZE_GRANULARITY, GlState::GlStateVariable::FLOAT, 1},
+    {GL_POINT_SPRITE_COORD_ORIGIN, GlState::GlStateVariable::INT, 1},
+    {GL_POLYGON_OFFSET_FACTOR, GlState::GlStateVariable::FLOAT, 1},
+    {GL_POLYGON_OFFSET_FILL, GlState::GlStateVariable::BOOL, 1},
+    {GL_POLYGON_OFFSET_LINE, GlState::GlStateVariable::BOOL, 1},
+    {GL_POLYGON_OFFSET_POINT, GlState::GlStateVariable::BOOL, 1},
+    {GL_POLYGON_OFFSET_UNITS, GlState::GlStateVariable::FLOAT, 1},
+    {GL_POLYGON_SMOOTH, GlState::GlStateVariable::BOOL, 1},
+    {GL_PROGRAM_POINT_SIZE, GlState::GlStateVariable::BOOL, 1},
+    {GL_RASTERIZER_DISCARD, GlState::GlStateVariable::BOOL, 1},
+    {GL_SMOOTH_LINE_WIDTH_GRANULARITY, GlState::GlStateVariable::FLOAT, 1},
+    {GL_SUBPIXEL_BITS, GlState::GlStateVariable::INT, 1},
+    {GL_SCISSOR_TEST, GlState::GlStateVariable::BOOL, 1},
+    {GL_SCISSOR_BOX, GlState::GlStateVariable::INT, 4},
+
+    // Texture.
+    {GL_ACTIVE_TEXTURE, GlState::GlStateVariable::INT, 1},
+    {GL_SAMPLER_BINDING, GlState::GlStateVariable::INT, 1},
+    {GL_TEXTURE_BINDING_1D, GlState::GlStateVariable::INT, 1},
+    {GL_TEXTURE_BINDING_1D_ARRAY, GlState::GlStateVariable::INT, 1},
+    {GL_TEXTURE_BINDING_2D, GlState::GlStateVariable::INT, 1},
+    {GL_TEXTURE_BINDING_2D_ARRAY, GlState::GlStateVariable::INT, 1},
+    {GL_TEXTURE_BINDING_2D_MULTISAMPLE, GlState::GlStateVariable::INT, 1},
+    {GL_TEXTURE_BINDING_2D_MULTISAMPLE_ARRAY, GlState::GlStateVariable::INT, 1},
+    {GL_TEXTURE_BINDING_3D, GlState::GlStateVariable::INT, 1},
+    {GL_TEXTURE_BINDING_BUFFER, GlState::GlStateVariable::INT, 1},
+    {GL_TEXTURE_BINDING_CUBE_MAP, GlState::GlStateVariable::INT, 1},
+    {GL_TEXTURE_BINDING_RECTANGLE, GlState::GlStateVariable::INT, 1},
+    {GL_TEXTURE_CUBE_MAP_SEAMLESS, GlState::GlStateVariable::BOOL, 1},
+
+    // Transformation state.
+    {GL_DEPTH_CLAMP, GlState::GlStateVariable::BOOL, 1},
+    {GL_DEPTH_RANGE, GlState::GlStateVariable::FLOAT, 2},
+#if __GL_VERSION >= 400L
+    {GL_TRANSFORM_FEEDBACK_BINDING, GlState::GlStateVariable::INT, 1},
+#endif
+    {GL_VIEWPORT, GlState::GlStateVariable::INT, 4},
+
+    // Vertex arrays.
+    {GL_PRIMITIVE_RESTART, GlState::GlStateVariable::BOOL, 1},
+#if __GL_VERSION >= 430L
+    {GL_PRIMITIVE_RESTART_FIXED_INDEX, GlState::GlStateVariable::BOOL, 1},
+#endif
+    {GL_PRIMITIVE_RESTART_INDEX, GlState::GlStateVariable::INT, 1},
+    {GL_VERTEX_ARRAY_BINDING, GlState::GlStateVariable::INT, 1}};
+
+static const uint32_t numStateVariables = sizeof(stateVariables) / sizeof(GlStateVariableInfo);
+
 template <>
 void GlState::initGlParameter<int>(GLenum name, uint32_t num) {
   int32_t v[4];
   glGetIntegerv(name, v);
-  if (num == 1) state_.insert(std::make_pair(name, GlState::GlStateVariable(v[0])));
-  if (num == 2) state_.insert(std::make_pair(name, GlState::GlStateVariable(v[0], v[1])));
-  if (num == 3) state_.insert(std::make_pair(name, GlState::GlStateVariable(v[0], v[1], v[2])));
-  if (num == 4) state_.insert(std::make_pair(name, GlState::GlStateVariable(v[0], v[1], v[2], v[3])));
+  if (num == 1) insert(name, GlState::GlStateVariable(v[0]));
+  if (num == 2) insert(name, GlState::GlStateVariable(v[0], v[1]));
+  if (num == 3) insert(name, GlState::GlStateVariable(v[0], v[1], v[2]));
+  if (num == 4) insert(name, GlState::GlStateVariable(v[0], v[1], v[2], v[3]));
 }
 
 template <>
 void GlState::initGlParameter<float>(GLenum name, uint32_t num) {
   float v[4];
   glGetFloatv(name, v);
-  if (num == 1) state_.insert(std::make_pair(name, GlState::GlStateVariable(v[0])));
-  if (num == 2) state_.insert(std::make_pair(name, GlState::GlStateVariable(v[0], v[1])));
-  if (num == 3) state_.insert(std::make_pair(name, GlState::GlStateVariable(v[0], v[1], v[2])));
-  if (num == 4) state_.insert(std::make_pair(name, GlState::GlStateVariable(v[0], v[1], v[2], v[3])));
+  if (num == 1) insert(name, GlState::GlStateVariable(v[0]));
+  if (num == 2) insert(name, GlState::GlStateVariable(v[0], v[1]));
+  if (num == 3) insert(name, GlState::GlStateVariable(v[0], v[1], v[2]));
+  if (num == 4) insert(name, GlState::GlStateVariable(v[0], v[1], v[2], v[3]));
 }
 
 template <>
 void GlState::initGlParameter<bool>(GLenum name, uint32_t num) {
   GLboolean v[4];
   glGetBooleanv(name, v);
-  if (num == 1) state_.insert(std::make_pair(name, GlState::GlStateVariable(static_cast<bool>(v[0]))));
+  if (num == 1) insert(name, GlState::GlStateVariable(static_cast<bool>(v[0])));
+}
+
+void GlState::initGlParameter(GLenum name) {
+  for (uint32_t i = 0; i < numStateVariables; ++i) {
+    if (stateVariables[i].name != name) continue;
+
+    if (stateVariables[i].type == GlStateVariable::INT) initGlParameter<int>(name, stateVariables[i].size);
+    if (stateVariables[i].type == GlStateVariable::FLOAT) initGlParameter<float>(name, stateVariables[i].size);
+    if (stateVariables[i].type == GlStateVariable::BOOL) initGlParameter<bool>(name, stateVariables[i].size);
+
+    return;
+  }
+
+  throw std::runtime_error("Unknown state variable " + stringify_name(name) + ".");
+}
+
+std::vector<GlState::Entry>::const_iterator GlState::find(GLenum variable) const {
+  auto it = std::lower_bound(state_.begin(), state_.end(), variable,
+                             [](const Entry& e, GLenum name) { return e.first < name; });
+  if (it != state_.end() && it->first == variable) return it;
+
+  return state_.end();
+}
+
+void GlState::insert(GLenum variable, const GlStateVariable& value) {
+  auto it = std::lower_bound(state_.begin(), state_.end(), variable,
+                             [](const Entry& e, GLenum name) { return e.first < name; });
+  if (it != state_.end() && it->first == variable) return;
+
+  state_.insert(it, Entry(variable, value));
+}
+
+bool GlState::contains(GLenum variable) const {
+  return (find(variable) != state_.end());
 }
 
 #undef CASE
@@ -55,6 +188,12 @@ std::string GlState::stringify_name(GLenum value) const {
     CASE(GL_DEPTH_CLEAR_VALUE)
     CASE(GL_DEPTH_WRITEMASK)
     CASE(GL_DRAW_BUFFER)
+    CASE(GL_BLEND_SRC_RGB)
+    CASE(GL_BLEND_DST_RGB)
+    CASE(GL_BLEND_SRC_ALPHA)
+    CASE(GL_BLEND_DST_ALPHA)
+    CASE(GL_SCISSOR_TEST)
+    CASE(GL_SCISSOR_BOX)
     CASE(GL_RENDERBUFFER_BINDING)
     CASE(GL_BLEND)
     CASE(GL_BLEND_COLOR)
@@ -179,8 +318,8 @@ GlState::GlState() {
 
 template <>
 std::string GlState::get<std::string>(GLenum variable) const {
-  if (state_.find(variable) == state_.end()) throw std::runtime_error("No such variable found in GlState.");
-  auto it = state_.find(variable);
+  auto it = find(variable);
+  if (it == state_.end()) throw std::runtime_error("No such variable found in GlState.");
 
   return stringify_value(*it);
 }
@@ -190,78 +329,14 @@ void GlState::restore() {
 }
 
 GlState GlState::queryAll() {
-  // see also: https://www.opengl.org/wiki/GLAPI/glGet
-
   GlState state;
-  // Buffer binding state.
-  state.initGlParameter<int>(GL_ARRAY_BUFFER_BINDING, 1);
-  state.initGlParameter<int>(GL_ELEMENT_ARRAY_BUFFER_BINDING, 1);
-  state.initGlParameter<int>(GL_VERTEX_ARRAY_BINDING, 1);
-#if __GL_VERSION >= 400L
-  state.initGlParameter<int>(GL_DRAW_INDIRECT_BUFFER_BINDING, 1);
-#endif
-#if __GL_VERSION >= 440L
-  state.initGlParameter<int>(GL_QUERY_BUFFER_BINDING, 1);
-#endif
+  state.state_.reserve(numStateVariables + 32);
+
+  for (uint32_t i = 0; i < numStateVariables; ++i) {
+    if (stateVariables[i].name == GL_SAMPLER_BINDING) continue;  // queried for every texture unit below.
+    state.initGlParameter(stateVariables[i].name);
+  }
 
-  // Framebuffers.
-  state.initGlParameter<float>(GL_COLOR_CLEAR_VALUE, 4);
-  state.initGlParameter<float>(GL_DEPTH_CLEAR_VALUE, 1);
-
-  state.initGlParameter<int>(GL_DEPTH_FUNC, 1);
-  state.initGlParameter<bool>(GL_DEPTH_TEST, 1);
-  state.initGlParameter<bool>(GL_DEPTH_WRITEMASK, 1);
-
-  state.initGlParameter<int>(GL_DRAW_BUFFER, 1);
-  state.initGlParameter<int>(GL_DRAW_FRAMEBUFFER_BINDING, 1);
-  // TODO: GL_READ_BUFFER
-  state.initGlParameter<int>(GL_RENDERBUFFER_BINDING, 1);
-  // TODO: GL_STENCIL ...
-
-  // TODO: Hints, Image State, Multisampling,
-
-  // Pixel Operations.
-  state.initGlParameter<bool>(GL_BLEND, 1);
-  state.initGlParameter<float>(GL_BLEND_COLOR, 4);
-
-  // TODO: GL_BLEND_DST_ALPHA, GL_BLEND_DST_RGB, GL_BLEND_EQUATION_RGB, GL_BLEND_EQUATION_ALPHA,
-  // TODO: GL_BLEND_SRC_ALPHA, GL_BLEND_SRC_RGB, GL_COLOR_LOGIC_OP, GL_DITHER, GL_LOGIC_OP_MODE,
-  // TODO: GL_SCISSOR_BOX, GL_SCISSOR_TEST
-
-  // TODO: Pixel Transfer Operations
-
-  // Programs:
-  state.initGlParameter<int>(GL_CURRENT_PROGRAM, 1);
-  state.initGlParameter<int>(GL_PROGRAM_PIPELINE_BINDING, 1);
-
-  // OpenGL 4.3: GL_PROGRAM_BINARY_FORMATS
-  // OpenGL 4.1: GL_PROGRAM_PIPELINE_BINDING
-
-  // Rasterization:
-  state.initGlParameter<bool>(GL_CULL_FACE, 1);
-  state.initGlParameter<int>(GL_CULL_FACE_MODE, 1);
-  state.initGlParameter<int>(GL_FRONT_FACE, 1);
-  state.initGlParameter<bool>(GL_LINE_SMOOTH, 1);
-  state.initGlParameter<float>(GL_LINE_WIDTH, 1);
-  state.initGlParameter<float>(GL_POINT_FADE_THRESHOLD_SIZE, 1);
-  state.initGlParameter<float>(GL_POINT_SIZE, 1);
-  state.initGlParameter<float>(GL_POINT_SIZE_GRANULARITY, 1);
-  state.initGlParameter<int>(GL_POINT_SPRITE_COORD_ORIGIN, 1);
-  //  state.initGlParameter<int>(GL_POLYGON_MODE, 2);
-  state.initGlParameter<float>(GL_POLYGON_OFFSET_FACTOR, 1);
-  state.initGlParameter<bool>(GL_POLYGON_OFFSET_FILL, 1);
-  state.initGlParameter<bool>(GL_POLYGON_OFFSET_LINE, 1);
-  state.initGlParameter<bool>(GL_POLYGON_OFFSET_POINT, 1);
-  state.initGlParameter<float>(GL_POLYGON_OFFSET_UNITS, 1);
-
-  state.initGlParameter<bool>(GL_POLYGON_SMOOTH, 1);
-  state.initGlParameter<bool>(GL_PROGRAM_POINT_SIZE, 1);
-  state.initGlParameter<bool>(GL_RASTERIZER_DISCARD, 1);
-  state.initGlParameter<float>(GL_SMOOTH_LINE_WIDTH_GRANULARITY, 1);
-  state.initGlParameter<int>(GL_SUBPIXEL_BITS, 1);
-
-  // Texture:
-  state.initGlParameter<int>(GL_ACTIVE_TEXTURE, 1);
   // query all the sampler bindings:
   int32_t max_texunits;
   glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &max_texunits);
@@ -269,46 +344,24 @@ GlState GlState::queryAll() {
     int32_t v;
     glActiveTexture(GL_TEXTURE0 + i);
     glGetIntegerv(GL_SAMPLER_BINDING, &v);
-    state.state_.insert(std::make_pair(GL_SAMPLER_BINDING + GL_TEXTURE0 + i, GlState::GlStateVariable(v)));
+    state.insert(GL_SAMPLER_BINDING + GL_TEXTURE0 + i, GlState::GlStateVariable(v));
   }
-  glActiveTexture(state.get<int>(GL_ACTIVE_TEXTURE));
   // restore original state.
-  state.initGlParameter<int>(GL_TEXTURE_BINDING_1D, 1);
-  state.initGlParameter<int>(GL_TEXTURE_BINDING_1D_ARRAY, 1);
-  state.initGlParameter<int>(GL_TEXTURE_BINDING_2D, 1);
-  state.initGlParameter<int>(GL_TEXTURE_BINDING_2D_ARRAY, 1);
-  state.initGlParameter<int>(GL_TEXTURE_BINDING_2D_MULTISAMPLE, 1);
-  state.initGlParameter<int>(GL_TEXTURE_BINDING_2D_MULTISAMPLE_ARRAY, 1);
-  state.initGlParameter<int>(GL_TEXTURE_BINDING_3D, 1);
-  state.initGlParameter<int>(GL_TEXTURE_BINDING_BUFFER, 1);
-  state.initGlParameter<int>(GL_TEXTURE_BINDING_CUBE_MAP, 1);
-  state.initGlParameter<int>(GL_TEXTURE_BINDING_RECTANGLE, 1);
-  state.initGlParameter<bool>(GL_TEXTURE_CUBE_MAP_SEAMLESS, 1);
-
-  // Transformation state:
-  state.initGlParameter<bool>(GL_DEPTH_CLAMP, 1);
-  state.initGlParameter<float>(GL_DEPTH_RANGE, 1);
-#if __GL_VERSION >= 400L
-  state.initGlParameter<int>(GL_TRANSFORM_FEEDBACK_BINDING, 1);
-#endif
-  state.initGlParameter<int>(GL_VIEWPORT, 4);
-
-  // Vertex arrays.
-  state.initGlParameter<bool>(GL_PRIMITIVE_RESTART, 1);
-#if __GL_VERSION >= 430L
-  state.initGlParameter<bool>(GL_PRIMITIVE_RESTART_FIXED_INDEX, 1);
-#endif
-  state.initGlParameter<int>(GL_PRIMITIVE_RESTART_INDEX, 1);
-  state.initGlParameter<int>(GL_VERTEX_ARRAY_BINDING, 1);
+  glActiveTexture(state.get<int>(GL_ACTIVE_TEXTURE));
 
   // TODO: GL_VERTEX_BINDING_DIVISOR , GL_VERTEX_BINDING_OFFSET, GL_VERTEX_BINDING_STRIDE
   CheckGlError();
 
   return state;
+}
 
-  //  return GlState::query(GL_ACTIVE_TEXTURE, GL_CONTEXT_FLAGS, GL_CURRENT_PROGRAM, GL_DEPTH_TEST,
-  //  GL_DRAW_FRAMEBUFFER_BINDING, GL_READ_FRAMEBUFFER_BINDING, GL_READ_FRAMEBUFFER_BINDING, GL_VERTEX_ARRAY_BINDING,
-  //  GL_VIEWPORT);
+GlState GlState::query(std::initializer_list<GLenum> vars) {
+  GlState state;
+  state.state_.reserve(vars.size());
+
+  for (GLenum var : vars) state.initGlParameter(var);
+
+  return state;
 }
 
 GlState::GlStateVariable::GlStateVariable(bool value) : type(BOOL), valb{value}, size(1) {
@@ -377,12 +430,12 @@ std::ostream& operator<<(std::ostream& stream, const GlState& state) {
 
 void GlState::difference(const GlState& other) const {
   for (auto it = state_.begin(); it != state_.end(); ++it) {
-    if (other.state_.find(it->first) == other.state_.end()) {
+    auto oit = other.find(it->first);
+    if (oit == other.state_.end()) {
       std::cerr << stringify_name(it->first) << " missing." << std::endl;
+      continue;
     }
 
-    auto oit = other.state_.find(it->first);
-
     if (it->second != oit->second) {
       std::cerr << stringify_name(it->first) << " expected: ";
       std::cerr << stringify_value(*it) << " but got: " << stringify_value(*oit) << std::endl;
@@ -394,8 +447,8 @@ bool GlState::operator==(const GlState& other) const {
   if (state_.size() != other.state_.size()) return false;
 
   for (auto it = state_.begin(); it != state_.end(); ++it) {
-    if (other.state_.find(it->first) == other.state_.end()) return false;
-    auto oit = other.state_.find(it->first);
+    auto oit = other.find(it->first);
+    if (oit == other.state_.end()) return false;
 
     if (it->second != oit->second) return false;
   }
@@ -406,13 +459,5 @@ bool GlState::operator==(const GlState& other) const {
 bool GlState::operator!=(const GlState& other) const {
   return !(*this == other);
 }
-
-// GlState GlState::query(GLenum vars...)
-//{
-//  va_list args;
-//  va_start(args, vars);
-//
-//  while()
-//}
 }
 /* namespace rv */
@@ -2,9 +2,9 @@
 #define INCLUDE_RV_GLSTATE_H_
 
 #include "glbase.h"
-#include <cstdarg>
+#include <initializer_list>
 #include <ostream>
-#include <map>
+#include <vector>
 
 namespace glow {
 
@@ -13,9 +13,10 @@ namespace glow {
  *  In OpenGL, we sometimes screw up the state of OpenGL, but we don't know exactly where.
  *  Here, the GlState class comes into play to get a snapshot of the current state that is
  *  accessible via glGet*. On initialization all available information is gathered, therefore
- *  it is not a good idea to call this frequently in production and time-critical code.
+ *  it is not a good idea to call this frequently in production and time-critical code. If only
+ *  some variables are of interest, use query(vars...) to get only these.
  *
- *  TODO: implement querying of single values and specific set of values.
+ *  For saving and restoring state around a piece of code, see GlStateGuard.
  *
  *  \author behley
  **/
@@ -74,8 +75,19 @@ class GlState {
    **/
   bool operator!=(const GlState& other) const;
 
-  /** \brief get some state variables. **/
-  //   TODO: static GlState query(GLenum vars...);
+  /** \brief get only the given state variables, e.g., GlState::query(GL_VIEWPORT, GL_DEPTH_TEST).
+   *
+   *  Throws a std::runtime_error for variables that are unknown to GlState.
+   **/
+  template <typename... Vars>
+  static GlState query(GLenum var, Vars... vars) {
+    return query({var, static_cast<GLenum>(vars)...});
+  }
+  static GlState query(std::initializer_list<GLenum> vars);
+
+  /** \brief is the given variable part of the state? **/
+  bool contains(GLenum variable) const;
+
   friend std::ostream& operator<<(std::ostream& stream, const GlState& state);
 
  protected:
@@ -84,16 +96,25 @@ class GlState {
   std::string stringify_name(GLenum value) const;
   std::string stringify_value(const std::pair<GLenum, GlState::GlStateVariable>& entry) const;
 
+  typedef std::pair<GLenum, GlStateVariable> Entry;
+
   template <typename T>
   void initGlParameter(GLenum name, uint32_t num_values);
+  /** \brief query variable with its type and number of values given by the table of known variables. **/
+  void initGlParameter(GLenum name);
+
+  /** \brief find entry by binary search; returns state_.end(), if variable is not present. **/
+  std::vector<Entry>::const_iterator find(GLenum variable) const;
+  /** \brief insert entry at its sorted position; an already present variable is not replaced. **/
+  void insert(GLenum variable, const GlStateVariable& value);
 
-  std::map<GLenum, GlStateVariable> state_;
+  std::vector<Entry> state_;  // sorted by variable name.
 };
 
 template <typename T>
 T GlState::get(GLenum variable) const {
-  if (state_.find(variable) == state_.end()) throw std::runtime_error("No such variable found in GlState.");
-  auto it = state_.find(variable);
+  auto it = find(variable);
+  if (it == state_.end()) throw std::runtime_error("No such variable found in GlState.");
 
   if (it->second.type == GlStateVariable::INT) {
     return T(it->second.vali[0]);
@@ -0,0 +1,324 @@
+#include "GlStateGuard.h"
+
+#include "GlFramebuffer.h"
+#include "GlProgram.h"
+#include "GlStats.h"
+#include "GlTexture.h"
+#include "GlVertexArray.h"
+#include "glexception.h"
+
+namespace glow {
+
+inline GLenum binding_of(GLenum target) {
+  switch (target) {
+    case GL_TEXTURE_1D:
+      return GL_TEXTURE_BINDING_1D;
+    case GL_TEXTURE_1D_ARRAY:
+      return GL_TEXTURE_BINDING_1D_ARRAY;
+    case GL_TEXTURE_2D_ARRAY:
+      return GL_TEXTURE_BINDING_2D_ARRAY;
+    case GL_TEXTURE_2D_MULTISAMPLE:
+      return GL_TEXTURE_BINDING_2D_MULTISAMPLE;
+    case GL_TEXTURE_2D_MULTISAMPLE_ARRAY:
+      return GL_TEXTURE_BINDING_2D_MULTISAMPLE_ARRAY;
+    case GL_TEXTURE_3D:
+      return GL_TEXTURE_BINDING_3D;
+    case GL_TEXTURE_BUFFER:
+      return GL_TEXTURE_BINDING_BUFFER;
+    case GL_TEXTURE_CUBE_MAP:
+      return GL_TEXTURE_BINDING_CUBE_MAP;
+    case GL_TEXTURE_RECTANGLE:
+      return GL_TEXTURE_BINDING_RECTANGLE;
+    default:
+      return GL_TEXTURE_BINDING_2D;
+  }
+}
+
+GlStateGuard::GlStateGuard(GlStateCategory categories) : categories_(categories) {
+  framebuffer_ = GlFramebuffer::boundFramebuffer_;
+  program_ = GlProgram::boundProgram_;
+  vertexArray_ = GlVertexArray::boundVAO_;
+}
+
+GlStateGuard::~GlStateGuard() {
+  restore();
+}
+
+void GlStateGuard::check(GlStateCategory category) const {
+  if ((categories_ & category) == GlStateCategory::NONE) {
+    throw GlStateError("GlStateGuard: state category not guarded. Add it to the categories of the guard.");
+  }
+  if (restored_) throw GlStateError("GlStateGuard: state already restored.");
+}
+
+void GlStateGuard::saveViewport() {
+  check(GlStateCategory::VIEWPORT);
+  if (viewportSaved_) return;
+
+  glGetIntegerv(GL_VIEWPORT, viewport_);
+  for (uint32_t i = 0; i < 4; ++i) currentViewport_[i] = viewport_[i];
+  viewportSaved_ = true;
+}
+
+void GlStateGuard::saveDepth() {
+  check(GlStateCategory::DEPTH);
+  if (depthSaved_) return;
+
+  glGetBooleanv(GL_DEPTH_TEST, &depthTest_);
+  glGetBooleanv(GL_DEPTH_WRITEMASK, &depthMask_);
+  glGetIntegerv(GL_DEPTH_FUNC, &depthFunc_);
+  currentDepthTest_ = depthTest_;
+  currentDepthMask_ = depthMask_;
+  currentDepthFunc_ = depthFunc_;
+  depthSaved_ = true;
+}
+
+void GlStateGuard::saveBlend() {
+  check(GlStateCategory::BLEND);
+  if (blendSaved_) return;
+
+  glGetBooleanv(GL_BLEND, &blend_);
+  glGetIntegerv(GL_BLEND_SRC_RGB, &blendFunc_[0]);
+  glGetIntegerv(GL_BLEND_DST_RGB, &blendFunc_[1]);
+  glGetIntegerv(GL_BLEND_SRC_ALPHA, &blendFunc_[2]);
+  glGetIntegerv(GL_BLEND_DST_ALPHA, &blendFunc_[3]);
+  currentBlend_ = blend_;
+  for (uint32_t i = 0; i < 4; ++i) currentBlendFunc_[i] = blendFunc_[i];
+  blendSaved_ = true;
+}
+
+void GlStateGuard::saveScissor() {
+  check(GlStateCategory::SCISSOR);
+  if (scissorSaved_) return;
+
+  glGetBooleanv(GL_SCISSOR_TEST, &scissorTest_);
+  currentScissorTest_ = scissorTest_;
+  scissorSaved_ = true;
+}
+
+void GlStateGuard::setViewport(int32_t x, int32_t y, int32_t width, int32_t height) {
+  saveViewport();
+
+  if (currentViewport_[0] == x && currentViewport_[1] == y && currentViewport_[2] == width &&
+      currentViewport_[3] == height)
+    return;
+
+  glViewport(x, y, width, height);
+  GLOW_STATS_CALL(STATE);
+  currentViewport_[0] = x;
+  currentViewport_[1] = y;
+  currentViewport_[2] = width;
+  currentViewport_[3] = height;
+}
+
+inline void set_capability(GLenum cap, GLboolean enabled) {
+  if (enabled)
+    glEnable(cap);
+  else
+    glDisable(cap);
+  GLOW_STATS_CALL(STATE);
+}
+
+void GlStateGuard::setDepthTest(bool enabled) {
+  saveDepth();
+
+  GLboolean value = enabled ? GL_TRUE : GL_FALSE;
+  if (currentDepthTest_ == value) return;
+
+  set_capability(GL_DEPTH_TEST, value);
+  currentDepthTest_ = value;
+}
+
+void GlStateGuard::setDepthMask(bool enabled) {
+  saveDepth();
+
+  GLboolean value = enabled ? GL_TRUE : GL_FALSE;
+  if (currentDepthMask_ == value) return;
+
+  glDepthMask(value);
+  GLOW_STATS_CALL(STATE);
+  currentDepthMask_ = value;
+}
+
+void GlStateGuard::setDepthFunc(GLenum func) {
+  saveDepth();
+
+  if (currentDepthFunc_ == static_cast<GLint>(func)) return;
+
+  glDepthFunc(func);
+  GLOW_STATS_CALL(STATE);
+  currentDepthFunc_ = func;
+}
+
+void GlStateGuard::setBlend(bool enabled) {
+  saveBlend();
+
+  GLboolean value = enabled ? GL_TRUE : GL_FALSE;
+  if (currentBlend_ == value) return;
+
+  set_capability(GL_BLEND, value);
+  currentBlend_ = value;
+}
+
+void GlStateGuard::setBlendFunc(GLenum src, GLenum dst) {
+  saveBlend();
+
+  GLint s = src, d = dst;
+  if (currentBlendFunc_[0] == s && currentBlendFunc_[1] == d && currentBlendFunc_[2] == s && currentBlendFunc_[3] == d)
+    return;
+
+  glBlendFunc(src, dst);
+  GLOW_STATS_CALL(STATE);
+  currentBlendFunc_[0] = currentBlendFunc_[2] = s;
+  currentBlendFunc_[1] = currentBlendFunc_[3] = d;
+}
+
+void GlStateGuard::setScissorTest(bool enabled) {
+  saveScissor();
+
+  GLboolean value = enabled ? GL_TRUE : GL_FALSE;
+  if (currentScissorTest_ == value) return;
+
+  set_capability(GL_SCISSOR_TEST, value);
+  currentScissorTest_ = value;
+}
+
+void GlStateGuard::saveFramebuffers() {
+  check(GlStateCategory::FRAMEBUFFER);
+  if (framebufferSaved_) return;
+
+  // the bound framebuffers might not be bound by glow; thus, glow's shadow state is not sufficient.
+  glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFramebuffer_);
+  glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer_);
+  framebufferSaved_ = true;
+}
+
+void GlStateGuard::bindFramebuffer(GLenum target, GLuint framebuffer) {
+  saveFramebuffers();
+
+  glBindFramebuffer(target, framebuffer);
+  GLOW_STATS_CALL(BIND_FRAMEBUFFER);
+}
+
+void GlStateGuard::saveTextureUnits() {
+  check(GlStateCategory::TEXTURE_UNITS);
+  if (textureSaved_) return;
+
+  glGetIntegerv(GL_ACTIVE_TEXTURE, &activeTexture_);
+  currentActiveTexture_ = activeTexture_;
+  textureSaved_ = true;
+}
+
+void GlStateGuard::setActiveTexture(uint32_t unit) {
+  saveTextureUnits();
+
+  GLint value = GL_TEXTURE0 + unit;
+  if (currentActiveTexture_ == value) return;
+
+  glActiveTexture(value);
+  GLOW_STATS_CALL(STATE);
+  currentActiveTexture_ = value;
+}
+
+void GlStateGuard::bindTexture(uint32_t unit, GLenum target, GLuint texture) {
+  setActiveTexture(unit);
+
+  bool saved = false;
+  for (const TextureBinding& b : textures_) saved = saved || (b.unit == unit && b.target == target);
+
+  if (!saved) {
+    TextureBinding binding;
+    binding.unit = unit;
+    binding.target = target;
+    glGetIntegerv(binding_of(target), &binding.saved);
+    textures_.push_back(binding);
+  }
+
+  glBindTexture(target, texture);
+  GLOW_STATS_CALL(BIND_TEXTURE);
+}
+
+void GlStateGuard::bindTexture(uint32_t unit, const GlTexture& texture) {
+  bindTexture(unit, texture.target_, texture.id());
+}
+
+void GlStateGuard::restore() {
+  if (restored_) return;
+  restored_ = true;
+
+  if (framebufferSaved_) {
+    if (drawFramebuffer_ == readFramebuffer_) {
+      glBindFramebuffer(GL_FRAMEBUFFER, drawFramebuffer_);
+      GLOW_STATS_CALL(BIND_FRAMEBUFFER);
+    } else {
+      glBindFramebuffer(GL_DRAW_FRAMEBUFFER, drawFramebuffer_);
+      GLOW_STATS_CALL(BIND_FRAMEBUFFER);
+      glBindFramebuffer(GL_READ_FRAMEBUFFER, readFramebuffer_);
+      GLOW_STATS_CALL(BIND_FRAMEBUFFER);
+    }
+    GlFramebuffer::boundFramebuffer_ = framebuffer_;
+  } else if ((categories_ & GlStateCategory::FRAMEBUFFER) != GlStateCategory::NONE &&
+             GlFramebuffer::boundFramebuffer_ != framebuffer_) {
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer_);
+    GLOW_STATS_CALL(BIND_FRAMEBUFFER);
+    GlFramebuffer::boundFramebuffer_ = framebuffer_;
+  }
+
+  if ((categories_ & GlStateCategory::PROGRAM) != GlStateCategory::NONE && GlProgram::boundProgram_ != program_) {
+    glUseProgram(program_);
+    GLOW_STATS_CALL(BIND_PROGRAM);
+    GlProgram::boundProgram_ = program_;
+  }
+
+  if ((categories_ & GlStateCategory::VERTEX_ARRAY) != GlStateCategory::NONE &&
+      GlVertexArray::boundVAO_ != vertexArray_) {
+    glBindVertexArray(vertexArray_);
+    GLOW_STATS_CALL(BIND_VERTEX_ARRAY);
+    GlVertexArray::boundVAO_ = vertexArray_;
+  }
+
+  if (viewportSaved_ && (currentViewport_[0] != viewport_[0] || currentViewport_[1] != viewport_[1] ||
+                         currentViewport_[2] != viewport_[2] || currentViewport_[3] != viewport_[3])) {
+    glViewport(viewport_[0], viewport_[1], viewport_[2], viewport_[3]);
+    GLOW_STATS_CALL(STATE);
+  }
+
+  if (depthSaved_) {
+    if (currentDepthTest_ != depthTest_) set_capability(GL_DEPTH_TEST, depthTest_);
+    if (currentDepthMask_ != depthMask_) {
+      glDepthMask(depthMask_);
+      GLOW_STATS_CALL(STATE);
+    }
+    if (currentDepthFunc_ != depthFunc_) {
+      glDepthFunc(depthFunc_);
+      GLOW_STATS_CALL(STATE);
+    }
+  }
+
+  if (blendSaved_) {
+    if (currentBlend_ != blend_) set_capability(GL_BLEND, blend_);
+    if (currentBlendFunc_[0] != blendFunc_[0] || currentBlendFunc_[1] != blendFunc_[1] ||
+        currentBlendFunc_[2] != blendFunc_[2] || currentBlendFunc_[3] != blendFunc_[3]) {
+      glBlendFuncSeparate(blendFunc_[0], blendFunc_[1], blendFunc_[2], blendFunc_[3]);
+      GLOW_STATS_CALL(STATE);
+    }
+  }
+
+  if (scissorSaved_ && currentScissorTest_ != scissorTest_) set_capability(GL_SCISSOR_TEST, scissorTest_);
+
+  if (textureSaved_) {
+    for (const TextureBinding& b : textures_) {
+      glActiveTexture(GL_TEXTURE0 + b.unit);
+      glBindTexture(b.target, b.saved);
+      GLOW_STATS_CALL(BIND_TEXTURE);
+      currentActiveTexture_ = GL_TEXTURE0 + b.unit;
+    }
+
+    if (currentActiveTexture_ != activeTexture_) {
+      glActiveTexture(activeTexture_);
+      GLOW_STATS_CALL(STATE);
+    }
+  }
+}
+
+} /* namespace glow */
@@ -0,0 +1,145 @@
+#ifndef INCLUDE_GLOW_GLSTATEGUARD_H_
+#define INCLUDE_GLOW_GLSTATEGUARD_H_
+
+#include <stdint.h>
+#include <vector>
+
+#include "glbase.h"
+
+namespace glow {
+
+class GlTexture;
+
+/** \brief categories of OpenGL state that can be saved and restored by a GlStateGuard. **/
+enum class GlStateCategory : uint32_t {
+  NONE = 0,
+  VIEWPORT = 1,        // glViewport.
+  DEPTH = 2,           // depth test, depth mask, and depth function.
+  BLEND = 4,           // blending and blend function.
+  FRAMEBUFFER = 8,     // framebuffer bound by GlFramebuffer or bindFramebuffer().
+  PROGRAM = 16,        // program bound by GlProgram.
+  VERTEX_ARRAY = 32,   // vertex array object bound by GlVertexArray.
+  TEXTURE_UNITS = 64,  // active texture unit and textures bound via bindTexture().
+  SCISSOR = 128,       // scissor test.
+  ALL = 255
+};
+
+inline GlStateCategory operator|(GlStateCategory a, GlStateCategory b) {
+  return static_cast<GlStateCategory>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b));
+}
+
+inline GlStateCategory operator&(GlStateCategory a, GlStateCategory b) {
+  return static_cast<GlStateCategory>(static_cast<uint32_t>(a) & static_cast<uint32_t>(b));
+}
+
+/** \brief Scoped save and restore of selected OpenGL state.
+ *
+ *  In contrast to GlState::queryAll(), only the named categories are saved and only state that was
+ *  actually changed is restored when the guard goes out of scope:
+ *
+ *  - Bindings of framebuffers, programs, and vertex array objects are taken from the bindings
+ *    glow keeps track of (see bindTransparently of the objects) and therefore need no glGet at all.
+ *    Thus, only bindings done via glow's objects are visible to the guard. The exception are framebuffers
+ *    bound by bindFramebuffer(), which queries the bound draw and read framebuffers once, since these might
+ *    not be bound by glow, e.g., the framebuffer of a QOpenGLWidget.
+ *  - Viewport, depth, blend, scissor, and texture unit state is not tracked by glow. These are changed via the
+ *    setters of the guard, which query the old value with the first change of the category and skip
+ *    redundant calls. If a category is never changed, it is neither queried nor restored.
+ *
+ *  Example:
+ *    {
+ *      GlStateGuard guard(GlStateCategory::VIEWPORT | GlStateCategory::DEPTH | GlStateCategory::FRAMEBUFFER);
+ *      guard.setViewport(0, 0, width, height);
+ *      guard.setDepthTest(false);
+ *      fbo.bind();
+ *      // ... draw ...
+ *    } // viewport, depth test and framebuffer binding are restored.
+ *
+ *  Calling a setter of a category that was not named in the constructor throws a GlStateError.
+ **/
+class GlStateGuard {
+ public:
+  explicit GlStateGuard(GlStateCategory categories);
+  ~GlStateGuard();
+
+  GlStateGuard(const GlStateGuard&) = delete;
+  GlStateGuard& operator=(const GlStateGuard&) = delete;
+
+  void setViewport(int32_t x, int32_t y, int32_t width, int32_t height);
+
+  void setDepthTest(bool enabled);
+  void setDepthMask(bool enabled);
+  void setDepthFunc(GLenum func);
+
+  void setBlend(bool enabled);
+  void setBlendFunc(GLenum src, GLenum dst);
+
+  void setScissorTest(bool enabled);
+
+  /** \brief bind framebuffer object not managed by a GlFramebuffer, e.g., to GL_READ_FRAMEBUFFER.
+   *
+   *  Requires FRAMEBUFFER. The first call queries the bound draw and read framebuffers, which are restored
+   *  separately; thus, also framebuffers bound without glow are restored.
+   **/
+  void bindFramebuffer(GLenum target, GLuint framebuffer);
+
+  /** \brief set active texture unit (0, 1, ...). **/
+  void setActiveTexture(uint32_t unit);
+  /** \brief bind texture to the given texture unit; the previous binding of the unit is restored. **/
+  void bindTexture(uint32_t unit, GLenum target, GLuint texture);
+  void bindTexture(uint32_t unit, const GlTexture& texture);
+
+  /** \brief restore changed state now; afterwards the guard restores nothing. **/
+  void restore();
+
+ protected:
+  /** \brief throws, if category is not guarded. **/
+  void check(GlStateCategory category) const;
+
+  /** \brief query state of the category, if not already done. **/
+  void saveViewport();
+  void saveDepth();
+  void saveBlend();
+  void saveScissor();
+  void saveFramebuffers();
+  void saveTextureUnits();
+
+  struct TextureBinding {
+   public:
+    uint32_t unit;
+    GLenum target;
+    GLint saved;
+  };
+
+  GlStateCategory categories_;
+  bool restored_{false};
+
+  // bindings from glow's shadow state.
+  GLuint framebuffer_{0}, program_{0}, vertexArray_{0};
+
+  // state that is queried lazily with the first change of the category.
+  bool viewportSaved_{false};
+  GLint viewport_[4], currentViewport_[4];
+
+  bool depthSaved_{false};
+  GLboolean depthTest_, depthMask_, currentDepthTest_, currentDepthMask_;
+  GLint depthFunc_, currentDepthFunc_;
+
+  bool blendSaved_{false};
+  GLboolean blend_, currentBlend_;
+  GLint blendFunc_[4], currentBlendFunc_[4];  // src rgb, dst rgb, src alpha, dst alpha.
+
+  bool scissorSaved_{false};
+  GLboolean scissorTest_, currentScissorTest_;
+
+  bool framebufferSaved_{false};  // queried by the first bindFramebuffer().
+  GLint drawFramebuffer_, readFramebuffer_;
+
+  bool textureSaved_{false};
+  GLint activeTexture_, currentActiveTexture_;
+  std::vector<TextureBinding> textures_;
+};
+
+} /* namespace glow */
+
+#endif /* INCLUDE_GLOW_GLSTATEGUARD_H_ */
@@ -0,0 +1,93 @@
+#include "GlStats.h"
+
+namespace glow {
+
+GlStatsSnapshot GlStats::current_;
+GlStatsSnapshot GlStats::last_;
+
+void GlStatsSnapshot::reset() {
+  for (uint32_t i = 0; i < static_cast<uint32_t>(GlStatsCall::NUM_CALLS); ++i) calls[i] = 0;
+  for (uint32_t i = 0; i < static_cast<uint32_t>(GlStatsObject::NUM_OBJECTS); ++i) {
+    created[i] = 0;
+    destroyed[i] = 0;
+  }
+
+  bytesUploaded = 0;
+  bytesDownloaded = 0;
+  bytesCopied = 0;
+  redundantBinds = 0;
+}
+
+uint64_t GlStatsSnapshot::totalCalls() const {
+  uint64_t sum = 0;
+  for (uint32_t i = 0; i < static_cast<uint32_t>(GlStatsCall::NUM_CALLS); ++i) sum += calls[i];
+
+  return sum;
+}
+
+uint64_t GlStatsSnapshot::totalBinds() const {
+  uint64_t sum = 0;
+  for (uint32_t i = 0; i <= static_cast<uint32_t>(GlStatsCall::BIND_SAMPLER); ++i) sum += calls[i];
+
+  return sum;
+}
+
+std::ostream& operator<<(std::ostream& out, const GlStatsSnapshot& stats) {
+  static const char* call_names[] = {"bind buffer", "bind texture", "bind framebuffer", "bind renderbuffer",
+                                     "bind program", "bind vertex array", "bind sampler", "uniform", "state",
+                                     "upload", "download", "copy", "draw", "query"};
+  static const char* object_names[] = {"buffer",  "texture", "framebuffer", "renderbuffer", "program",
+                                       "shader",  "vertex array", "sampler", "query", "transform feedback"};
+
+  for (uint32_t i = 0; i < static_cast<uint32_t>(GlStatsCall::NUM_CALLS); ++i) {
+    out.width(20);
+    out << call_names[i];
+    out.width(0);
+    out << ": " << stats.calls[i] << std::endl;
+  }
+
+  out.width(20);
+  out << "redundant binds";
+  out.width(0);
+  out << ": " << stats.redundantBinds << std::endl;
+
+  out.width(20);
+  out << "bytes uploaded";
+  out.width(0);
+  out << ": " << stats.bytesUploaded << std::endl;
+  out.width(20);
+  out << "bytes downloaded";
+  out.width(0);
+  out << ": " << stats.bytesDownloaded << std::endl;
+  out.width(20);
+  out << "bytes copied";
+  out.width(0);
+  out << ": " << stats.bytesCopied << std::endl;
+
+  for (uint32_t i = 0; i < static_cast<uint32_t>(GlStatsObject::NUM_OBJECTS); ++i) {
+    if (stats.created[i] == 0 && stats.destroyed[i] == 0) continue;
+    out.width(20);
+    out << object_names[i];
+    out.width(0);
+    out << ": +" << stats.created[i] << " -" << stats.destroyed[i] << std::endl;
+  }
+
+  return out;
+}
+
+bool GlStats::enabled() {
+#ifdef GLOW_ENABLE_STATS
+  return true;
+#else
+  return false;
+#endif
+}
+
+GlStatsSnapshot GlStats::endFrame() {
+  last_ = current_;
+  current_.reset();
+
+  return last_;
+}
+
+} /* namespace glow */
@@ -0,0 +1,148 @@
+#ifndef INCLUDE_GLOW_GLSTATS_H_
+#define INCLUDE_GLOW_GLSTATS_H_
+
+#include <stdint.h>
+#include <ostream>
+
+namespace glow {
+
+/** \brief kinds of OpenGL calls counted by GlStats. **/
+enum class GlStatsCall {
+  BIND_BUFFER,
+  BIND_TEXTURE,
+  BIND_FRAMEBUFFER,
+  BIND_RENDERBUFFER,
+  BIND_PROGRAM,
+  BIND_VERTEX_ARRAY,
+  BIND_SAMPLER,
+  UNIFORM,  // glUniform*
+  STATE,    // parameter and state changes, e.g., glTexParameter, glVertexAttribPointer, attachments.
+  UPLOAD,   // host to device transfers, e.g., glBufferSubData, glTexImage.
+  DOWNLOAD, // device to host transfers, e.g., glGetBufferSubData, glGetTexImage.
+  COPY,     // device to device transfers.
+  DRAW,
+  QUERY,
+  NUM_CALLS
+};
+
+/** \brief kinds of OpenGL objects counted by GlStats. **/
+enum class GlStatsObject {
+  BUFFER,
+  TEXTURE,
+  FRAMEBUFFER,
+  RENDERBUFFER,
+  PROGRAM,
+  SHADER,
+  VERTEX_ARRAY,
+  SAMPLER,
+  QUERY,
+  TRANSFORM_FEEDBACK,
+  NUM_OBJECTS
+};
+
+/** \brief counters of a single frame. **/
+struct GlStatsSnapshot {
+ public:
+  uint64_t calls[static_cast<uint32_t>(GlStatsCall::NUM_CALLS)];
+  uint64_t created[static_cast<uint32_t>(GlStatsObject::NUM_OBJECTS)];
+  uint64_t destroyed[static_cast<uint32_t>(GlStatsObject::NUM_OBJECTS)];
+
+  uint64_t bytesUploaded;
+  uint64_t bytesDownloaded;
+  uint64_t bytesCopied;
+
+  uint64_t redundantBinds;  // binds that were elided, since the object was already bound.
+
+  GlStatsSnapshot() { reset(); }
+
+  void reset();
+
+  uint64_t operator[](GlStatsCall kind) const { return calls[static_cast<uint32_t>(kind)]; }
+
+  /** \brief number of counted calls of all kinds. **/
+  uint64_t totalCalls() const;
+  /** \brief number of counted binds of all objects. **/
+  uint64_t totalBinds() const;
+
+  friend std::ostream& operator<<(std::ostream& out, const GlStatsSnapshot& stats);
+};
+
+/** \brief Per-frame counters of OpenGL calls, transferred bytes and object lifetimes.
+ *
+ *  The wrappers increment the counters on every OpenGL entry point, if glow is compiled with
+ *  GLOW_ENABLE_STATS (cmake option ENABLE_GL_STATS). Otherwise, the GLOW_STATS_* macros expand
+ *  to nothing and counting has no cost at all. Note that code including glow's headers must be
+ *  compiled with the same setting, since the templated wrappers count in the headers.
+ *
+ *  Example:
+ *    while (running) {
+ *      // ... render frame ...
+ *      GlStatsSnapshot stats = GlStats::endFrame();
+ *      std::cout << stats << std::endl;
+ *    }
+ *
+ *  Only calls issued through glow's wrappers are counted, raw OpenGL calls are not visible.
+ */
+class GlStats {
+ public:
+  GlStats() = delete;
+
+  /** \brief were the wrappers compiled with counting enabled? **/
+  static bool enabled();
+
+  /** \brief counters of the current frame so far. **/
+  static const GlStatsSnapshot& current() { return current_; }
+
+  /** \brief counters of the last completed frame. **/
+  static const GlStatsSnapshot& lastFrame() { return last_; }
+
+  /** \brief finish the current frame: return its counters and reset them for the next frame. **/
+  static GlStatsSnapshot endFrame();
+
+  static void call(GlStatsCall kind) { current_.calls[static_cast<uint32_t>(kind)] += 1; }
+  static void created(GlStatsObject kind) { current_.created[static_cast<uint32_t>(kind)] += 1; }
+  static void destroyed(GlStatsObject kind) { current_.destroyed[static_cast<uint32_t>(kind)] += 1; }
+
+  static void uploaded(uint64_t bytes) {
+    current_.calls[static_cast<uint32_t>(GlStatsCall::UPLOAD)] += 1;
+    current_.bytesUploaded += bytes;
+  }
+
+  static void downloaded(uint64_t bytes) {
+    current_.calls[static_cast<uint32_t>(GlStatsCall::DOWNLOAD)] += 1;
+    current_.bytesDownloaded += bytes;
+  }
+
+  static void copied(uint64_t bytes) {
+    current_.calls[static_cast<uint32_t>(GlStatsCall::COPY)] += 1;
+    current_.bytesCopied += bytes;
+  }
+
+  static void redundantBind() { current_.redundantBinds += 1; }
+
+ protected:
+  static GlStatsSnapshot current_;
+  static GlStatsSnapshot last_;
+};
+
+} /* namespace glow */
+
+#ifdef GLOW_ENABLE_STATS
+#define GLOW_STATS_CALL(KIND) glow::GlStats::call(glow::GlStatsCall::KIND)
+#define GLOW_STATS_CREATED(KIND) glow::GlStats::created(glow::GlStatsObject::KIND)
+#define GLOW_STATS_DESTROYED(KIND) glow::GlStats::destroyed(glow::GlStatsObject::KIND)
+#define GLOW_STATS_UPLOADED(BYTES) glow::GlStats::uploaded(BYTES)
+#define GLOW_STATS_DOWNLOADED(BYTES) glow::GlStats::downloaded(BYTES)
+#define GLOW_STATS_COPIED(BYTES) glow::GlStats::copied(BYTES)
+#define GLOW_STATS_REDUNDANT_BIND() glow::GlStats::redundantBind()
+#else
+#define GLOW_STATS_CALL(KIND) static_cast<void>(0)
+#define GLOW_STATS_CREATED(KIND) static_cast<void>(0)
+#define GLOW_STATS_DESTROYED(KIND) static_cast<void>(0)
+#define GLOW_STATS_UPLOADED(BYTES) static_cast<void>(0)
+#define GLOW_STATS_DOWNLOADED(BYTES) static_cast<void>(0)
+#define GLOW_STATS_COPIED(BYTES) static_cast<void>(0)
+#define GLOW_STATS_REDUNDANT_BIND() static_cast<void>(0)
+#endif
+
+#endif /* INCLUDE_GLOW_GLSTATS_H_ */
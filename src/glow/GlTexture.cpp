@@ -4,14 +4,14 @@
 #include <cassert>
 #include <vector>
 
-#include "GlFramebuffer.h"
-#include "GlProgram.h"
-#include "GlSampler.h"
+#include "GlBlitter.h"
+#include "GlCapabilities.h"
+#include "GlImageFile.h"
+#include "GlSnapshotWriter.h"
 #include "GlState.h"
-#include "GlVertexArray.h"
 #include "glutil.h"
 
-#include <fstream>
+#include <sstream>
 
 #include <boost/filesystem.hpp>
 
@@ -19,335 +19,189 @@ namespace glow {
 
 GLuint GlTexture::boundTexture_ = 0;
 
-template <>
-void GlTexture::download<float>(std::vector<float>& data) const {
-  data.resize(numComponents(format_) * width_ * height_);
-  GLuint id = bindTransparently();
-
-  GLenum pixFormat = GL_RGBA;
-
-  switch (format_) {
-    case TextureFormat::R:
-    case TextureFormat::R_FLOAT:
-      pixFormat = GL_RED;
-      break;
-
-    case TextureFormat::R_INTEGER:
-      pixFormat = GL_RED_INTEGER;
-      break;
-
-    case TextureFormat::RG:
-    case TextureFormat::RG_FLOAT:
-      pixFormat = GL_RG;
-      break;
-
-    case TextureFormat::RG_INTEGER:
-      pixFormat = GL_RG_INTEGER;
-      break;
+GlTexture::GlTexture(uint32_t width, TextureFormat format, uint32_t levels)
+    : GlTexture(GL_TEXTURE_1D, width, 0, 0, format, levels) {}
 
-    case TextureFormat::RGB:
-    case TextureFormat::RGB_FLOAT:
-      pixFormat = GL_RGB;
-      break;
+GlTexture::GlTexture(uint32_t width, uint32_t height, TextureFormat format, uint32_t levels)
+    : GlTexture(GL_TEXTURE_2D, width, height, 0, format, levels) {}
 
-    case TextureFormat::RGB_INTEGER:
-      pixFormat = GL_RGB_INTEGER;
-      break;
-
-    case TextureFormat::RGBA:
-    case TextureFormat::RGBA_FLOAT:
-      pixFormat = GL_RGBA;
-      break;
-
-    case TextureFormat::RGBA_INTEGER:
-      pixFormat = GL_RGBA_INTEGER;
-      break;
-
-    case TextureFormat::DEPTH:
-      pixFormat = GL_DEPTH;
-      break;
-
-    case TextureFormat::DEPTH_STENCIL:
-      pixFormat = GL_DEPTH_STENCIL;
-      break;
-  }
+GlTexture::GlTexture(uint32_t width, uint32_t height, uint32_t depth, TextureFormat format, uint32_t levels)
+    : GlTexture(GL_TEXTURE_3D, width, height, depth, format, levels) {}
 
-  glGetTexImage(target_, 0, pixFormat, GL_FLOAT, reinterpret_cast<GLvoid*>(&data[0]));
-  CheckGlError();
-  releaseTransparently(id);
-}
+GlTexture::GlTexture()
+    : target_(GL_TEXTURE_2D), format_(TextureFormat::RGB), info_(textureFormatInfo(TextureFormat::RGB)) {}
 
-template <>
-void GlTexture::download<vec4>(std::vector<vec4>& data) const {
-  data.resize(width_ * height_);
-  GLuint id = bindTransparently();
-  if (format_ == TextureFormat::R_INTEGER)  // || format_ == TextureFormat::RG_INTEGER|| format_ ==
-                                            // TextureFormat::RGB_INTEGER || format_ == TextureFormat::RGBA_INTEGER)
-  {
-    std::vector<int32_t> d(width_ * height_);
-
-    glGetTexImage(target_, 0, GL_RED_INTEGER, GL_INT, reinterpret_cast<GLvoid*>(&d[0]));
-    for (uint32_t i = 0; i < width_ * height_; ++i) {
-      data[i].x = d[i];
-      data[i].y = 0;
-      data[i].z = 0;
-      data[i].w = 0;
-    }
-  } else {
-    glGetTexImage(target_, 0, GL_RGBA, GL_FLOAT, reinterpret_cast<GLvoid*>(&data[0]));
+GlTexture::GlTexture(GLenum target, uint32_t width, uint32_t height, uint32_t depth, TextureFormat format,
+                     uint32_t levels)
+    : target_(target), format_(format), info_(textureFormatInfo(format)) {
+  storage_->width = width;
+  storage_->height = height;
+  storage_->depth = depth;
+  storage_->levels = levels;
+  if (target == GL_TEXTURE_2D_ARRAY && (width == 0 || height == 0 || depth == 0)) {
+    throw GlTextureError("Texture array needs at least one layer.");
   }
-
-  CheckGlError();
-  releaseTransparently(id);
-}
-
-template <>
-void GlTexture::download(Eigen::Vector4f* ptr) const {
-  GLuint id = bindTransparently();
-  glGetTexImage(target_, 0, GL_RGBA, GL_FLOAT, reinterpret_cast<GLvoid*>(ptr));
-  CheckGlError();
-  releaseTransparently(id);
-}
-
-template <>
-void GlTexture::download(PixelFormat pixelfmt, float* ptr) const {
-  GLuint id = bindTransparently();
-  glGetTexImage(target_, 0, static_cast<GLenum>(pixelfmt), GL_FLOAT, reinterpret_cast<GLvoid*>(ptr));
-  releaseTransparently(id);
-}
-
-template <>
-void GlTexture::download(PixelFormat pixelfmt, int32_t* ptr) const {
-  std::cout << "downloading int." << std::endl;
-  GLuint id = bindTransparently();
-  glGetTexImage(target_, 0, static_cast<GLenum>(pixelfmt), GL_INT, reinterpret_cast<GLvoid*>(ptr));
-  releaseTransparently(id);
-  CheckGlError();
-  std::cout << "finished." << std::endl;
-}
-
-GlTexture::GlTexture(uint32_t width, TextureFormat format) : width_(width), height_(0), depth_(0), format_(format) {
-  glGenTextures(1, &id_);
-  target_ = GL_TEXTURE_1D;
-  ptr_ = std::shared_ptr<GLuint>(new GLuint(id_), [](GLuint* ptr) {
-    glDeleteTextures(1, ptr);
-    delete ptr;
-  });
+  if (target == GL_TEXTURE_RECTANGLE && levels > 1) throw GlTextureError("Rectangle texture has no mip levels.");
+  generate();
 
   // allocate space.
   GLuint old_id = bindTransparently();
   allocateMemory();
+  // rectangle textures do not support GL_REPEAT.
+  GLint wrap = (target == GL_TEXTURE_RECTANGLE) ? GL_CLAMP_TO_BORDER : GL_REPEAT;
   glTexParameteri(target_, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  GLOW_STATS_CALL(STATE);
   glTexParameteri(target_, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-  glTexParameteri(target_, GL_TEXTURE_WRAP_S, GL_REPEAT);
-  releaseTransparently(old_id);
-
-  CheckGlError();
-}
-
-GlTexture::GlTexture(uint32_t width, uint32_t height, TextureFormat format)
-    : width_(width), height_(height), depth_(0), format_(format) {
-  glGenTextures(1, &id_);
-  target_ = GL_TEXTURE_2D;
-  ptr_ = std::shared_ptr<GLuint>(new GLuint(id_), [](GLuint* ptr) {
-    glDeleteTextures(1, ptr);
-    delete ptr;
-  });
-
-  // allocate space.
-  GLuint old_id = bindTransparently();
-  allocateMemory();
-  glTexParameteri(target_, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-  glTexParameteri(target_, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-  glTexParameteri(target_, GL_TEXTURE_WRAP_S, GL_REPEAT);
-  glTexParameteri(target_, GL_TEXTURE_WRAP_T, GL_REPEAT);
+  GLOW_STATS_CALL(STATE);
+  glTexParameteri(target_, GL_TEXTURE_WRAP_S, wrap);
+  GLOW_STATS_CALL(STATE);
+  if (storage_->height > 0) {
+    glTexParameteri(target_, GL_TEXTURE_WRAP_T, wrap);
+    GLOW_STATS_CALL(STATE);
+  }
+  if (target_ == GL_TEXTURE_3D) {
+    glTexParameteri(target_, GL_TEXTURE_WRAP_R, wrap);
+    GLOW_STATS_CALL(STATE);
+  }
   releaseTransparently(old_id);
 
   CheckGlError();
 }
 
-GlTexture::GlTexture(uint32_t width, uint32_t height, uint32_t depth, TextureFormat format)
-    : width_(width), height_(height), depth_(depth), format_(format) {
-  glGenTextures(1, &id_);
-  target_ = GL_TEXTURE_3D;
-  ptr_ = std::shared_ptr<GLuint>(new GLuint(id_), [](GLuint* ptr) {
-    glDeleteTextures(1, ptr);
-    delete ptr;
-  });
-
-  // allocate space.
-  GLuint old_id = bindTransparently();
-  allocateMemory();
-  glTexParameteri(target_, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-  glTexParameteri(target_, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-  glTexParameteri(target_, GL_TEXTURE_WRAP_S, GL_REPEAT);
-  glTexParameteri(target_, GL_TEXTURE_WRAP_T, GL_REPEAT);
-  glTexParameteri(target_, GL_TEXTURE_WRAP_R, GL_REPEAT);
-  releaseTransparently(old_id);
-
-  CheckGlError();
+GlTexture GlTexture::array2D(uint32_t width, uint32_t height, uint32_t layers, TextureFormat format, uint32_t levels) {
+  return GlTexture(GL_TEXTURE_2D_ARRAY, width, height, layers, format, levels);
 }
 
 GlTexture::~GlTexture() {
-  if (boundTexture_ == id_) {
+  if (boundTexture_ == storage_->id) {
     release();
-    assert((boundTexture_ != id_) && "Texture object still bound.");
+    assert((boundTexture_ != storage_->id) && "Texture object still bound.");
   }
 }
 
-void GlTexture::copy(const GlTexture& other) {
-  if (height_ == 0 || depth_ > 0) {
-    // FIXME: implement.
-    std::cout << "WARNING: copy of 1D and 3D textures not supported." << std::endl;
-    return;  // copy only data for two-dimensional textures.
-  }
-
-  GLint ov[4];
-  GLboolean depthTest;
-  GLint old_fbo;
-
-  glGetIntegerv(GL_VIEWPORT, ov);
-  glGetBooleanv(GL_DEPTH_TEST, &depthTest);
-  glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &old_fbo);
-
-  GlVertexArray vao;
-
-  // create a framebuffer with destination texture and use fragment shader for copy.
-  GlSampler sampler;
-  sampler.setMinifyingOperation(TexMinOp::NEAREST);
-  sampler.setMagnifyingOperation(TexMagOp::NEAREST);
-  sampler.setWrapOperation(TexWrapOp::REPEAT, TexWrapOp::REPEAT);
-
-  GlFramebuffer copy_fbo(width_, height_, FramebufferTarget::DRAW);
-  GlRenderbuffer rbo(width_, height_, RenderbufferFormat::DEPTH_STENCIL);
-  copy_fbo.attach(FramebufferAttachment::COLOR0, *this);
-  copy_fbo.attach(FramebufferAttachment::DEPTH_STENCIL, rbo);
-  assert(copy_fbo.valid());
-
-  std::string empty_vert = "#version 330 core\nvoid main(){}";
-  std::string quad_geom = "#version 330 core\nlayout(points) in;\nlayout(triangle_strip, max_vertices = 4) out;\n";
-  quad_geom += "out vec2 texCoords;\nvoid main(){\n";
-  quad_geom += "  gl_Position = vec4(1.0, 1.0, 0.0, 1.0);\ntexCoords = vec2(1.0, 1.0);\nEmitVertex();\n";
-  quad_geom += "  gl_Position = vec4(-1.0, 1.0, 0.0, 1.0);\ntexCoords = vec2(0.0, 1.0);\nEmitVertex();\n";
-  quad_geom += "  gl_Position = vec4(1.0,-1.0, 0.0, 1.0);\ntexCoords = vec2(1.0, 0.0);\nEmitVertex();\n";
-  quad_geom += "  gl_Position = vec4(-1.0,-1.0, 0.0, 1.0);\ntexCoords = vec2(0.0, 0.0);\nEmitVertex();\n";
-  quad_geom += "  EndPrimitive();\n}";
-  std::string copy_frag = "#version 330 core\nin vec2 texCoords;\n";
-
-  switch (other.format_) {
-    case TextureFormat::R_INTEGER:
-    case TextureFormat::RG_INTEGER:
-    case TextureFormat::RGB_INTEGER:
-    case TextureFormat::RGBA_INTEGER:
-      copy_frag += "uniform isampler2D tex_other;\n";
-      break;
-    default:
-      copy_frag += "uniform sampler2D tex_other;\n";
-  }
-  // do we need to consider input/ouptut formats?
-  copy_frag += "out vec4 color;\nvoid main(){\n  color = texture(tex_other, texCoords); \n}";
-
-  GlProgram copy_program;
-  copy_program.attach(GlShader(ShaderType::VERTEX_SHADER, empty_vert));
-  copy_program.attach(GlShader(ShaderType::GEOMETRY_SHADER, quad_geom));
-  copy_program.attach(GlShader(ShaderType::FRAGMENT_SHADER, copy_frag));
-  copy_program.link();
-  copy_program.setUniform(GlUniform<int32_t>("tex_other", 0));
-
-  copy_fbo.bind();
-  copy_program.bind();
-  vao.bind();
-
-  glDisable(GL_DEPTH_TEST);
-  glViewport(0, 0, width_, height_);  // set viewport to new values
+void GlTexture::copy(const GlTexture& other, TexMagOp filter) {
+  GlBlitter::getInstance().copy(other.blitTexture(), blitTexture(), filter);
+  GLOW_STATS_COPIED(numPixels() * texelSize(info_));
+}
 
-  glActiveTexture(GL_TEXTURE0);
-  uint32_t old_id = other.bindTransparently();
-  sampler.bind(0);
+GlBlitTexture GlTexture::blitTexture() const {
+  GlBlitTexture texture;
+  texture.id = storage_->id;
+  texture.target = target_;
+  texture.width = storage_->width;
+  texture.height = std::max<uint32_t>(storage_->height, 1);
+  texture.depth = std::max<uint32_t>(storage_->depth, 1);
+  texture.format = info_.sizedFormat;
 
-  glDrawArrays(GL_POINTS, 0, 1);
+  return texture;
+}
 
-  sampler.release(0);
-  vao.release();
-  other.releaseTransparently(old_id);
-  copy_program.release();
+GlTexture GlTexture::multisample2D(uint32_t width, uint32_t height, uint32_t samples, TextureFormat format,
+                                   bool fixedSampleLocations) {
+  if (samples == 0) throw GlTextureError("Multisample texture needs at least one sample.");
 
-  glEnable(GL_DEPTH_TEST);
-  copy_fbo.release();
+  // integer and depth formats may support less samples than color formats.
+  TextureFormatInfo info = textureFormatInfo(format);
+  GLenum limit = GL_MAX_COLOR_TEXTURE_SAMPLES;
+  if (info.integer) limit = GL_MAX_INTEGER_SAMPLES;
+  if (info.pixelFormat == GL_DEPTH_COMPONENT || info.pixelFormat == GL_DEPTH_STENCIL) {
+    limit = GL_MAX_DEPTH_TEXTURE_SAMPLES;
+  }
+  uint32_t maxSamples = GlCapabilities::getInstance().get<int32_t>(limit);
+  if (samples > maxSamples) {
+    std::stringstream error;
+    error << "Number of samples " << samples << " exceeds the maximal number of samples (" << maxSamples << ").";
+    throw GlTextureError(error.str());
+  }
 
-  glFinish();
+  GlTexture texture;
+  texture.storage_->width = width;
+  texture.storage_->height = height;
+  texture.samples_ = samples;
+  texture.fixedSampleLocations_ = fixedSampleLocations;
+  texture.format_ = format;
+  texture.info_ = info;
+  texture.target_ = GL_TEXTURE_2D_MULTISAMPLE;
+  texture.generate();
+
+  // multisample textures have no sampler state.
+  GLuint old_id = texture.bindTransparently();
+  texture.allocateMemory();
+  texture.releaseTransparently(old_id);
 
-  // restore settings.
-  glViewport(ov[0], ov[1], ov[2], ov[3]);
-  if (depthTest)
-    glEnable(GL_DEPTH_TEST);
-  else
-    glDisable(GL_DEPTH_TEST);
+  CheckGlError();
 
-  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, old_fbo);
+  return texture;
 }
 
 GlTexture GlTexture::clone() const {
-  if (height_ > 0 && depth_ > 0) {
-    GlTexture tex(width_, height_, depth_, format_);
-    tex.copy(*this);
-
-    return tex;
-  } else if (height_ > 0) {
-    GlTexture tex(width_, height_, format_);
-    tex.copy(*this);
-
-    return tex;
-  } else {
-    GlTexture tex(width_, format_);
+  if (samples_ > 0) {
+    GlTexture tex = multisample2D(storage_->width, storage_->height, samples_, format_, fixedSampleLocations_);
     tex.copy(*this);
 
     return tex;
   }
 
-  throw GlTextureError("invalid texture.");
+  GlTexture tex(target_, storage_->width, storage_->height, storage_->depth, format_, storage_->levels);
+  tex.copy(*this);
+
+  return tex;
 }
 
 void GlTexture::bind() {
-  glBindTexture(target_, id_);
-  boundTexture_ = id_;
+  glBindTexture(target_, storage_->id);
+  GLOW_STATS_CALL(BIND_TEXTURE);
+  boundTexture_ = storage_->id;
 }
 
 void GlTexture::release() {
   glBindTexture(target_, 0);
+  GLOW_STATS_CALL(BIND_TEXTURE);
   boundTexture_ = 0;
 }
 
+GLuint GlTexture::id() const {
+  return storage_->id;
+}
+
 void GlTexture::setMinifyingOperation(TexMinOp minifyingOperation) {
   GLuint old_id = bindTransparently();
   glTexParameteri(target_, GL_TEXTURE_MIN_FILTER, static_cast<GLenum>(minifyingOperation));
+  GLOW_STATS_CALL(STATE);
   releaseTransparently(old_id);
 }
 
 void GlTexture::setMagnifyingOperation(TexMagOp magnifyingOperation) {
   GLuint old_id = bindTransparently();
   glTexParameteri(target_, GL_TEXTURE_MAG_FILTER, static_cast<GLenum>(magnifyingOperation));
+  GLOW_STATS_CALL(STATE);
   releaseTransparently(old_id);
 }
 
 void GlTexture::setWrapOperation(TexWrapOp wrap_s) {
   GLuint old_id = bindTransparently();
   glTexParameteri(target_, GL_TEXTURE_WRAP_S, static_cast<GLenum>(wrap_s));
+  GLOW_STATS_CALL(STATE);
   releaseTransparently(old_id);
 }
 
 void GlTexture::setWrapOperation(TexWrapOp wrap_s, TexWrapOp wrap_t) {
   GLuint old_id = bindTransparently();
   glTexParameteri(target_, GL_TEXTURE_WRAP_S, static_cast<GLenum>(wrap_s));
+  GLOW_STATS_CALL(STATE);
   glTexParameteri(target_, GL_TEXTURE_WRAP_T, static_cast<GLenum>(wrap_t));
+  GLOW_STATS_CALL(STATE);
   releaseTransparently(old_id);
 }
 
 void GlTexture::setWrapOperation(TexWrapOp wrap_s, TexWrapOp wrap_t, TexWrapOp wrap_r) {
   GLuint old_id = bindTransparently();
   glTexParameteri(target_, GL_TEXTURE_WRAP_S, static_cast<GLenum>(wrap_s));
+  GLOW_STATS_CALL(STATE);
   glTexParameteri(target_, GL_TEXTURE_WRAP_T, static_cast<GLenum>(wrap_t));
+  GLOW_STATS_CALL(STATE);
   glTexParameteri(target_, GL_TEXTURE_WRAP_R, static_cast<GLenum>(wrap_r));
+  GLOW_STATS_CALL(STATE);
   releaseTransparently(old_id);
 }
 
@@ -357,282 +211,387 @@ void GlTexture::setTextureSwizzle(TexSwizzle red, TexSwizzle green, TexSwizzle b
 
   GLuint old_id = bindTransparently();
   glTexParameteriv(target_, GL_TEXTURE_SWIZZLE_RGBA, swizzleMask);
+  GLOW_STATS_CALL(STATE);
   releaseTransparently(old_id);
 }
 
 bool GlTexture::save(const std::string& filename) const {
-  // TODO: implement saving to image. (libpng, etc.)
-  // note: texture transfer is always specified by pixel transfer; therefore we can have arbitrary output,...
-
-  std::string ext = glow::extension(filename);
-  if (ext == ".ppm") {
-    if (height_ == 0) {
-      std::ofstream out(filename.c_str());
-      out << "P6" << std::endl;
-      out << width_ << std::endl;
-      out << 1 << std::endl;
-      out << "255" << std::endl;
-
-      std::vector<float> colors(width_ * 3);
-      GLuint id = bindTransparently();
-      glGetTexImage(target_, 0, GL_RGB, GL_FLOAT, reinterpret_cast<GLvoid*>(&colors[0]));
-      CheckGlError();
-      releaseTransparently(id);
-
-      std::vector<char> data(width_ * 3);
-
-      for (uint32_t x = 0; x < width_; ++x) {
-        int32_t r = 255 * colors[3 * x];
-        int32_t g = 255 * colors[3 * x + 1];
-        int32_t b = 255 * colors[3 * x + 2];
-        data[3 * x] = (char)std::max(std::min(255, r), 0);
-        data[3 * x + 1] = (char)std::max(std::min(255, g), 0);
-        data[3 * x + 2] = (char)std::max(std::min(255, b), 0);
-      }
-
-      out.write(&data[0], height_ * 3);
-
-      out.close();
-      return true;
-
-    } else {
-      std::ofstream out(filename.c_str());
-      out << "P6" << std::endl;
-      out << width_ << std::endl;
-      out << height_ << std::endl;
-      out << "255" << std::endl;
-
-      std::vector<float> colors(width_ * height_ * 3);
-      GLuint id = bindTransparently();
-      glGetTexImage(target_, 0, GL_RGB, GL_FLOAT, reinterpret_cast<GLvoid*>(&colors[0]));
-      CheckGlError();
-      releaseTransparently(id);
-
-      std::vector<char> data(width_ * height_ * 3);
-
-      for (uint32_t x = 0; x < width_; ++x) {
-        for (uint32_t y = 0; y < height_; ++y) {
-          int32_t r = 255 * colors[3 * (x + (height_ - 1 - y) * width_)];
-          int32_t g = 255 * colors[3 * (x + (height_ - 1 - y) * width_) + 1];
-          int32_t b = 255 * colors[3 * (x + (height_ - 1 - y) * width_) + 2];
-          data[3 * (x + y * width_)] = (char)std::max(std::min(255, r), 0);
-          data[3 * (x + y * width_) + 1] = (char)std::max(std::min(255, g), 0);
-          data[3 * (x + y * width_) + 2] = (char)std::max(std::min(255, b), 0);
-        }
-      }
-
-      out.write(&data[0], width_ * height_ * 3);
-
-      out.close();
-      return true;
-    }
-  }
+  PixelFormat pixelfmt;
+  PixelType type;
+  if (target_ != GL_TEXTURE_1D && target_ != GL_TEXTURE_2D && target_ != GL_TEXTURE_RECTANGLE) return false;
+  if (!GlSnapshotWriter::fileFormat(filename, format_, pixelfmt, type)) return false;
 
-  return false;
+  uint32_t height = std::max<uint32_t>(storage_->height, 1);
+  std::vector<uint8_t> pixels(static_cast<size_t>(storage_->width) * height * pixelComponents(pixelfmt) *
+                              pixelTypeSize(type));
+  download(pixelfmt, type, &pixels[0], PixelStore::tight());
+
+  return GlSnapshotWriter::encode(filename, storage_->width, height, pixelfmt, type, &pixels[0]);
 }
 
 GlTexture GlTexture::loadTexture(const std::string& filename) {
-  assert(false && "Loading of textures not implemented.");
-  // TODO: implement loading to image. (libpng, etc.)
-  return GlTexture(0);
+  return loadTexture(GlImageFile(filename));
+}
+
+GlTexture GlTexture::loadTexture(const GlImageFile& image) {
+  GlTexture texture(image.width(), image.height(), image.textureFormat());
+  texture.assign(image);
+
+  return texture;
+}
+
+void GlTexture::assign(const GlImageFile& image) {
+  if ((target_ != GL_TEXTURE_2D && target_ != GL_TEXTURE_RECTANGLE) || storage_->width != image.width() ||
+      storage_->height != image.height()) {
+    throw GlTextureError("Image file '" + image.filename() + "' does not match the size of the texture.");
+  }
+
+  if (image.bottomUp()) {
+    assign(image.pixelFormat(), image.pixelType(), image.pixels(), image.layout());
+    return;
+  }
+
+  // rows from the top to the bottom are flipped on the GPU instead of in a copy on the host.
+  GlBlitter& blitter = GlBlitter::getInstance();
+  GlTexture& rows = blitter.scratch(storage_->width, storage_->height, image.textureFormat());
+  rows.assign(image.pixelFormat(), image.pixelType(), image.pixels(), image.layout());
+  blitter.flip(rows.blitTexture(), blitTexture());
+  GLOW_STATS_COPIED(numPixels() * texelSize(info_));
 }
 
 GLuint GlTexture::bindTransparently() const {
-  if (boundTexture_ == id_) return id_;
+  if (boundTexture_ == storage_->id) {
+    GLOW_STATS_REDUNDANT_BIND();
+    return storage_->id;
+  }
 
-  glBindTexture(target_, id_);
+  glBindTexture(target_, storage_->id);
+  GLOW_STATS_CALL(BIND_TEXTURE);
 
   return boundTexture_;
 }
 
 void GlTexture::releaseTransparently(GLuint old_id) const {
-  if (old_id == id_) return;
+  if (old_id == storage_->id) return;
 
   glBindTexture(target_, old_id);
+  GLOW_STATS_CALL(BIND_TEXTURE);
 }
 
-void GlTexture::resize(uint32_t width) {
-  if (height_ > 0 || depth_ > 0) {
+void GlTexture::resize(uint32_t width, TexResizeMode mode) {
+  if (storage_->height > 0 || storage_->depth > 0) {
     throw GlTextureError("Texture not one-dimensional. Hence, resize needs more then just one dimension.");
   }
 
-  width_ = width;
-  GLuint id = bindTransparently();
-  allocateMemory();
-  releaseTransparently(id);
+  reallocate(width, 0, 0, mode);
 }
 
-void GlTexture::resize(uint32_t width, uint32_t height) {
-  if (height_ == 0 || depth_ > 0) {
+void GlTexture::resize(uint32_t width, uint32_t height, TexResizeMode mode) {
+  if (storage_->height == 0 || storage_->depth > 0) {
     throw GlTextureError("Texture not two-dimensional. Hence, resize needs more or less dimension.");
   }
 
-  width_ = width;
-  height_ = height;
-  GLuint id = bindTransparently();
-  allocateMemory();
-  releaseTransparently(id);
+  reallocate(width, height, 0, mode);
 }
 
-void GlTexture::resize(uint32_t width, uint32_t height, uint32_t depth) {
-  if (height_ == 0 || depth_ == 0) {
+void GlTexture::resize(uint32_t width, uint32_t height, uint32_t depth, TexResizeMode mode) {
+  if (storage_->height == 0 || storage_->depth == 0) {
     throw GlTextureError("Texture not three-dimensional. Hence, resize needs more or less dimension.");
   }
 
-  width_ = width;
-  height_ = height;
-  depth_ = depth;
+  reallocate(width, height, depth, mode);
+}
+
+void GlTexture::reallocate(uint32_t width, uint32_t height, uint32_t depth, TexResizeMode mode) {
+  if (view_) throw GlTextureError("Texture view cannot be resized.");
+  if (samples_ > 0 && mode == TexResizeMode::PRESERVE) {
+    throw GlTextureError("Content of multisample texture cannot be preserved.");
+  }
+
+  // overlapping region of old and new size.
+  uint32_t w = std::min(storage_->width, width);
+  uint32_t h = std::min(std::max<uint32_t>(storage_->height, 1), std::max<uint32_t>(height, 1));
+  uint32_t d = std::min(std::max<uint32_t>(storage_->depth, 1), std::max<uint32_t>(depth, 1));
+
+  if (storage_->immutable) {
+    // immutable storage cannot be specified again; thus, a new texture object with the same parameters is
+    // needed and the overlap is copied directly from the old texture object. The new texture object replaces
+    // the old one in all copies of the texture.
+    static const GLenum parameters[] = {GL_TEXTURE_MIN_FILTER,   GL_TEXTURE_MAG_FILTER,   GL_TEXTURE_WRAP_S,
+                                        GL_TEXTURE_WRAP_T,       GL_TEXTURE_WRAP_R,       GL_TEXTURE_COMPARE_MODE,
+                                        GL_TEXTURE_COMPARE_FUNC, GL_TEXTURE_SWIZZLE_R,    GL_TEXTURE_SWIZZLE_G,
+                                        GL_TEXTURE_SWIZZLE_B,    GL_TEXTURE_SWIZZLE_A,    GL_TEXTURE_BASE_LEVEL,
+                                        GL_TEXTURE_MAX_LEVEL};
+    // multisample textures have no sampler state and mip levels.
+    const uint32_t numParameters = (samples_ > 0) ? 0 : sizeof(parameters) / sizeof(GLenum);
+    GLint values[sizeof(parameters) / sizeof(GLenum)];
+
+    GlBlitTexture old = blitTexture();
+    GLuint id = bindTransparently();
+    for (uint32_t i = 0; i < numParameters; ++i) glGetTexParameteriv(target_, parameters[i], &values[i]);
+    releaseTransparently(id);
+
+    storage_->width = width;
+    storage_->height = height;
+    storage_->depth = depth;
+    generate();
+
+    id = bindTransparently();
+    allocateMemory();
+    for (uint32_t i = 0; i < numParameters; ++i) {
+      glTexParameteri(target_, parameters[i], values[i]);
+      GLOW_STATS_CALL(STATE);
+    }
+    releaseTransparently(id);
+
+    if (mode == TexResizeMode::PRESERVE && w > 0) {
+      GlBlitter::getInstance().copy(old, blitTexture(), w, h, d);
+      GLOW_STATS_COPIED(static_cast<uint64_t>(w) * h * d * texelSize(info_));
+    }
+
+    // the pending copy keeps the storage of the old texture object until it is finished.
+    if (boundTexture_ == old.id) boundTexture_ = 0;
+    glDeleteTextures(1, &old.id);
+    GLOW_STATS_DESTROYED(TEXTURE);
+
+    return;
+  }
+
+  if (mode == TexResizeMode::DISCARD || w == 0) {
+    storage_->width = width;
+    storage_->height = height;
+    storage_->depth = depth;
+
+    GLuint id = bindTransparently();
+    allocateMemory();
+    releaseTransparently(id);
+
+    return;
+  }
+
+  // The texture object must stay the same; thus, the overlap is copied to a temporary texture and back.
+  GlBlitter& blitter = GlBlitter::getInstance();
+  GlTexture tmp(target_, w, (height > 0) ? h : 0, (depth > 0) ? d : 0, format_, 1);
+  blitter.copy(blitTexture(), tmp.blitTexture(), w, h, d);
+  GLOW_STATS_COPIED(static_cast<uint64_t>(w) * h * d * texelSize(info_));
+
+  storage_->width = width;
+  storage_->height = height;
+  storage_->depth = depth;
 
   GLuint id = bindTransparently();
   allocateMemory();
   releaseTransparently(id);
+
+  blitter.copy(tmp.blitTexture(), blitTexture(), w, h, d);
+  GLOW_STATS_COPIED(static_cast<uint64_t>(w) * h * d * texelSize(info_));
+}
+
+uint32_t GlTexture::levels() const {
+  return storage_->levels;
+}
+
+uint32_t GlTexture::samples() const {
+  return samples_;
+}
+
+bool GlTexture::immutable() const {
+  return storage_->immutable;
+}
+
+uint32_t GlTexture::maxLevels(uint32_t width, uint32_t height, uint32_t depth) {
+  uint32_t size = std::max(width, std::max(height, depth));
+  uint32_t levels = 1;
+  while (size > 1) {
+    size = size / 2;
+    levels += 1;
+  }
+
+  return levels;
 }
 
 uint32_t GlTexture::width() const {
-  return width_;
+  return storage_->width;
 }
 
 uint32_t GlTexture::height() const {
-  return height_;
+  return storage_->height;
 }
 
 uint32_t GlTexture::depth() const {
-  return depth_;
+  return storage_->depth;
 }
 
 uint32_t GlTexture::numComponents(TextureFormat fmt) {
-  switch (fmt) {
-    case TextureFormat::R:
-    case TextureFormat::R_INTEGER:
-    case TextureFormat::R_FLOAT:
-      return 1;
-    case TextureFormat::RG:
-    case TextureFormat::RG_INTEGER:
-    case TextureFormat::RG_FLOAT:
-      return 2;
-    case TextureFormat::RGB:
-    case TextureFormat::RGB_INTEGER:
-    case TextureFormat::RGB_FLOAT:
-      return 3;
-    case TextureFormat::RGBA:
-    case TextureFormat::RGBA_INTEGER:
-    case TextureFormat::RGBA_FLOAT:
-      return 4;
-    //    case TextureFormat::GRAY:
-    //      return 1;
-    //    case TextureFormat::INTENSITY:
-    //      return 1;
-    case TextureFormat::DEPTH:
-      return 1;
-    case TextureFormat::DEPTH_STENCIL:
-      return 2;
-  }
-
-  return 4;
+  return textureFormatInfo(fmt).components;
 }
 
 void writeBitmap(const std::string& filename, const unsigned char* data) {}
 
+void GlTexture::generate() {
+  glGenTextures(1, &storage_->id);
+  GLOW_STATS_CREATED(TEXTURE);
+}
+
+GlTexture::Storage::~Storage() {
+  if (id == 0) return;
+
+  glDeleteTextures(1, &id);
+  GLOW_STATS_DESTROYED(TEXTURE);
+}
+
+GLenum GlTexture::sizedFormat(TextureFormat format) {
+  // immutable storage needs sized internal formats.
+  return textureFormatInfo(format).sizedFormat;
+}
+
 void GlTexture::allocateMemory() {
   CheckGlError();
-  if (width_ == 0 && height_ == 0 && depth_ == 0) return;
+  if (storage_->width == 0 && storage_->height == 0 && storage_->depth == 0) return;
+
+  if (samples_ > 0) {
+#if __GL_VERSION >= 430L
+    glTexStorage2DMultisample(target_, samples_, info_.sizedFormat, storage_->width, storage_->height,
+                              fixedSampleLocations_);
+    storage_->immutable = true;
+#else
+    glTexImage2DMultisample(target_, samples_, info_.sizedFormat, storage_->width, storage_->height,
+                            fixedSampleLocations_);
+#endif
+    GLOW_STATS_CALL(STATE);
+
+    CheckGlError();
+    return;
+  }
+
+  if (format_ == TextureFormat::GRAY) {
+    // single channel, which is replicated to RGB by the swizzle mask.
+    GLint swizzle[] = {GL_RED, GL_RED, GL_RED, GL_ONE};
+    glTexParameteriv(target_, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+    GLOW_STATS_CALL(STATE);
+  }
+
+#if __GL_VERSION >= 420L
+  // immutable storage with all levels; subsequent assigns only upload data.
+  if (storage_->height == 0 && storage_->depth == 0)
+    glTexStorage1D(target_, storage_->levels, info_.sizedFormat, storage_->width);
+  else if (storage_->depth == 0)
+    glTexStorage2D(target_, storage_->levels, info_.sizedFormat, storage_->width, storage_->height);
+  else
+    glTexStorage3D(target_, storage_->levels, info_.sizedFormat, storage_->width, storage_->height,
+                   storage_->depth);
+  GLOW_STATS_CALL(STATE);
+  storage_->immutable = true;
+
+  CheckGlError();
+  return;
+#endif
 
   // select pix format and type according to texture format.
-  GLint texFormat = static_cast<GLint>(format_);
-  GLenum pixFormat = GL_RGBA;
-  GLenum pixType = GL_UNSIGNED_BYTE;
-
-  switch (format_) {
-    case TextureFormat::R:
-    case TextureFormat::RG:
-    case TextureFormat::RGB:
-    case TextureFormat::RGBA:
-      pixType = GL_UNSIGNED_BYTE;
-      break;
-
-    case TextureFormat::R_INTEGER:
-    case TextureFormat::RG_INTEGER:
-    case TextureFormat::RGB_INTEGER:
-    case TextureFormat::RGBA_INTEGER:
-      pixType = GL_INT;
-      break;
-
-    case TextureFormat::R_FLOAT:
-    case TextureFormat::RG_FLOAT:
-    case TextureFormat::RGB_FLOAT:
-    case TextureFormat::RGBA_FLOAT:
-      pixType = GL_FLOAT;
-      break;
-
-    case TextureFormat::DEPTH:
-      pixType = GL_UNSIGNED_BYTE;  // ??
-      break;
-
-    case TextureFormat::DEPTH_STENCIL:
-      pixType = GL_DEPTH24_STENCIL8;
-      break;
+  const TextureFormatInfo& info = info_;
+  GLint texFormat = info.sizedFormat;
+  GLenum pixFormat = info.pixelFormat;
+  GLenum pixType = info.pixelType;
+
+  // this ensures that integral internal formats are matched to integral pixel formats:
+  for (uint32_t level = 0; level < storage_->levels; ++level) {
+    uint32_t width = std::max<uint32_t>(storage_->width >> level, 1);
+    uint32_t height = std::max<uint32_t>(storage_->height >> level, 1);
+    uint32_t depth = layered() ? storage_->depth : std::max<uint32_t>(storage_->depth >> level, 1);
+
+    if (storage_->height == 0 && storage_->depth == 0)
+      glTexImage1D(target_, level, texFormat, width, 0, pixFormat, pixType, nullptr);
+    else if (storage_->depth == 0)
+      glTexImage2D(target_, level, texFormat, width, height, 0, pixFormat, pixType, nullptr);
+    else
+      glTexImage3D(target_, level, texFormat, width, height, depth, 0, pixFormat, pixType, nullptr);
+    GLOW_STATS_CALL(STATE);
   }
 
-  switch (format_) {
-    case TextureFormat::R:
-    case TextureFormat::R_FLOAT:
-      pixFormat = GL_RED;
-      break;
-
-    case TextureFormat::R_INTEGER:
-      pixFormat = GL_RED_INTEGER;
-      break;
-
-    case TextureFormat::RG:
-    case TextureFormat::RG_FLOAT:
-      pixFormat = GL_RG;
-      break;
-
-    case TextureFormat::RG_INTEGER:
-      pixFormat = GL_RG_INTEGER;
-      break;
-
-    case TextureFormat::RGB:
-    case TextureFormat::RGB_FLOAT:
-      pixFormat = GL_RGB;
-      break;
-
-    case TextureFormat::RGB_INTEGER:
-      pixFormat = GL_RGB_INTEGER;
-      break;
-
-    case TextureFormat::RGBA:
-    case TextureFormat::RGBA_FLOAT:
-      pixFormat = GL_RGBA;
-      break;
-
-    case TextureFormat::RGBA_INTEGER:
-      pixFormat = GL_RGBA_INTEGER;
-      break;
-
-    case TextureFormat::DEPTH:
-      pixFormat = GL_DEPTH;
-      break;
-
-    case TextureFormat::DEPTH_STENCIL:
-      pixFormat = GL_DEPTH_STENCIL;
-      break;
+  // only the allocated levels should be used.
+  if (storage_->levels > 1) {
+    glTexParameteri(target_, GL_TEXTURE_MAX_LEVEL, storage_->levels - 1);
+    GLOW_STATS_CALL(STATE);
   }
 
-  // this ensures that integral internal formats are matched to integral pixel formats:
-  if (height_ == 0 && depth_ == 0)
-    glTexImage1D(target_, 0, texFormat, width_, 0, pixFormat, pixType, nullptr);
-  else if (depth_ == 0)
-    glTexImage2D(target_, 0, texFormat, width_, height_, 0, pixFormat, pixType, nullptr);
-  else
-    glTexImage3D(target_, 0, texFormat, width_, height_, depth_, 0, pixFormat, pixType, nullptr);
+  CheckGlError();
+}
+
+void GlTexture::downloadRegion(uint32_t x, uint32_t y, uint32_t width, uint32_t height, PixelFormat pixelfmt,
+                               PixelType type, void* data, uint32_t level, uint32_t layer) const {
+  readRegion(x, y, width, height, pixelfmt, type, data, level, layer, nullptr);
+}
+
+void GlTexture::downloadLayer(uint32_t layer, PixelFormat pixelfmt, PixelType type, void* data) const {
+  if (storage_->depth == 0) throw GlTextureError("Texture has no layers.");
+  readRegion(0, 0, storage_->width, storage_->height, pixelfmt, type, data, 0, layer, nullptr);
+}
+
+void GlTexture::download(PixelFormat pixelfmt, PixelType type, void* data, const PixelStore& layout) const {
+  downloadImage(pixelfmt, type, data, &layout);
+}
+
+void GlTexture::downloadImage(PixelFormat pixelfmt, PixelType type, void* data, const PixelStore* layout) const {
+  if (samples_ > 0) throw GlTextureError("Unable to download a multisample texture; resolve it first.");
+  GLuint id = bindTransparently();
+  // without layout, rows are tightly packed like the data of the typed overloads.
+  PixelStore previous = (layout != nullptr) ? layout->apply(true) : PixelStore::tight().apply(true);
+  glGetTexImage(target_, 0, static_cast<GLenum>(pixelfmt), static_cast<GLenum>(type), data);
+  GLOW_STATS_DOWNLOADED(numPixels() * pixelComponents(pixelfmt) * pixelTypeSize(type));
+  previous.apply(true);
+  releaseTransparently(id);
 
   CheckGlError();
 }
 
+void GlTexture::downloadComponents(uint32_t components, PixelType type, void* data) const {
+  const TextureFormatInfo& info = info_;
+  if (!info.integer || type != PixelType::FLOAT) {
+    downloadImage(pixelFormatOf(info, components), type, data, nullptr);
+    return;
+  }
+
+  // integer values cannot be read as float; thus, the values are converted.
+  std::vector<int32_t> values(numPixels() * info.components);
+  downloadImage(pixelFormatOf(info.components, true), PixelType::INT, &values[0], nullptr);
+
+  float* dst = reinterpret_cast<float*>(data);
+  for (uint64_t i = 0; i < numPixels(); ++i) {
+    for (uint32_t c = 0; c < components; ++c) {
+      dst[i * components + c] = (c < info.components) ? values[i * info.components + c] : 0.0f;
+    }
+  }
+}
+
+void GlTexture::downloadRegion(uint32_t x, uint32_t y, uint32_t width, uint32_t height, PixelFormat pixelfmt,
+                               PixelType type, void* data, const PixelStore& layout, uint32_t level,
+                               uint32_t layer) const {
+  readRegion(x, y, width, height, pixelfmt, type, data, level, layer, &layout);
+}
+
+void GlTexture::readRegion(uint32_t x, uint32_t y, uint32_t width, uint32_t height, PixelFormat pixelfmt,
+                           PixelType type, void* data, uint32_t level, uint32_t layer, const PixelStore* layout) const {
+  if (level >= storage_->levels) throw GlTextureError("Level exceeds the mip levels of the texture.");
+  if (samples_ > 0) throw GlTextureError("Unable to download a multisample texture; resolve it first.");
+
+  // dimensions of the requested level.
+  uint32_t levelWidth = std::max<uint32_t>(storage_->width >> level, 1);
+  uint32_t levelHeight = (storage_->height > 0) ? std::max<uint32_t>(storage_->height >> level, 1) : 1;
+  uint32_t levelDepth = layered() ? storage_->depth
+                                  : (storage_->depth > 0) ? std::max<uint32_t>(storage_->depth >> level, 1) : 1;
+  if (x + width > levelWidth || y + height > levelHeight || layer >= levelDepth) {
+    throw GlTextureError("Region exceeds the dimensions of the texture.");
+  }
+
+  PixelStore tight = PixelStore::tight();
+  GlBlitter::getInstance().read(blitTexture(), level, layer, x, y, width, height, pixelfmt, type, data,
+                                (layout != nullptr) ? layout : &tight);
+}
+
 void GlTexture::generateMipmaps() {
   GLuint id = bindTransparently();
   glGenerateMipmap(target_);
+  GLOW_STATS_CALL(STATE);
   releaseTransparently(id);
 }
 }
@@ -1,8 +1,10 @@
 #ifndef SRC_OPENGL_GLTEXTURE_H_
 #define SRC_OPENGL_GLTEXTURE_H_
 
+#include <algorithm>
 #include <vector>
 
+#include "GlFormatTraits.h"
 #include "GlObject.h"
 #include "GlPixelFormat.h"
 #include "GlTextureFormat.h"
@@ -10,7 +12,8 @@
 namespace glow {
 
 class GlFramebuffer;
-class GlTextureRectangle;
+class GlImageFile;
+struct GlBlitTexture;
 
 enum class TexMinOp {
   LINEAR = GL_LINEAR,
@@ -33,6 +36,12 @@ enum class TexWrapOp {
 
 enum class TexSwizzle { R = GL_RED, G = GL_GREEN, B = GL_BLUE, A = GL_ALPHA, ZERO = GL_ZERO, ONE = GL_ONE };
 
+/** \brief content of a texture after resize. **/
+enum class TexResizeMode {
+  DISCARD,  // content is undefined after resize.
+  PRESERVE  // overlapping region of old and new size is copied on the GPU.
+};
+
 /**
  * \brief Wrapper for OpenGl's texture
  *
@@ -55,11 +64,11 @@ enum class TexSwizzle { R = GL_RED, G = GL_GREEN, B = GL_BLUE, A = GL_ALPHA, ZER
  * TODO: To ensure consistency: the assign, resize on non-unique objects should generate a new
  * texture object, i.e., if ptr_->unique is true, then these functions simply resue the texture object?
  *
- * TODO: Implement for each dimension a own class: GlTexture1D, GlTexture2D, GlTexture3D...this, would
- * firstly enable a more consistent enforcement of constraints for framebuffers, etc. and secondly make
- * it unnecessary to check always the dimensions of the underlying opengl texture.
+ * The GlTexture decides by the dimensions of the texture at runtime how data is uploaded, etc. The
+ * typed textures GlTexture1D, GlTexture2D, GlTexture3D, GlTexture2DArray, and GlTextureRectangle fix
+ * the target at compile time and only offer the functions matching it (see GlTypedTexture).
  *
- * \see GlFramebuffer
+ * \see GlFramebuffer, GlTypedTexture
  *
  * \author behley
  *
@@ -67,25 +76,53 @@ enum class TexSwizzle { R = GL_RED, G = GL_GREEN, B = GL_BLUE, A = GL_ALPHA, ZER
 class GlTexture : public GlObject {
  public:
   friend class GlFramebuffer;
-  friend class GlTextureRectangle;
-
-  /** \brief create a one-dimensional empty texture with specified internal format **/
-  GlTexture(uint32_t width, TextureFormat format = TextureFormat::RGB);
-  /** \brief create a two-dimensional empty texture with specified internal format **/
-  GlTexture(uint32_t width, uint32_t height, TextureFormat format = TextureFormat::RGB);
-  /** \brief create a three-dimensional empty texture with specified internal format **/
-  GlTexture(uint32_t width, uint32_t height, uint32_t depth, TextureFormat format = TextureFormat::RGB);
+  friend class GlStateGuard;
+  friend class GlTextureView;
+  friend class GlFormatConverter;
+  friend class GlTexturePool;
+  friend class GlSnapshotWriter;
+
+  /** \brief create a one-dimensional empty texture with specified internal format and number of mip levels. **/
+  GlTexture(uint32_t width, TextureFormat format = TextureFormat::RGB, uint32_t levels = 1);
+  /** \brief create a two-dimensional empty texture with specified internal format and number of mip levels. **/
+  GlTexture(uint32_t width, uint32_t height, TextureFormat format = TextureFormat::RGB, uint32_t levels = 1);
+  /** \brief create a three-dimensional empty texture with specified internal format and number of mip levels. **/
+  GlTexture(uint32_t width, uint32_t height, uint32_t depth, TextureFormat format = TextureFormat::RGB,
+            uint32_t levels = 1);
 
   ~GlTexture();
 
+  /** \brief create an empty array of layers two-dimensional textures (GL_TEXTURE_2D_ARRAY).
+   *
+   *  All layers share width, height, format and mip levels; depth() is the number of layers, which is not
+   *  reduced for the mip levels. With GlFramebuffer::attachLayered, all layers can be rendered by a single
+   *  draw call, where gl_Layer in the geometry shader selects the layer.
+   **/
+  static GlTexture array2D(uint32_t width, uint32_t height, uint32_t layers, TextureFormat format = TextureFormat::RGB,
+                           uint32_t levels = 1);
+
+  /** \brief create an empty two-dimensional texture with samples per pixel (GL_TEXTURE_2D_MULTISAMPLE).
+   *
+   *  Multisample textures can only be rendered into and fetched by texelFetch in shaders; for assign,
+   *  download, etc., the texture must be resolved by GlFramebuffer::resolveTo.
+   *
+   *  \throws GlTextureError if samples exceeds the limit of the format, e.g., GL_MAX_COLOR_TEXTURE_SAMPLES.
+   **/
+  static GlTexture multisample2D(uint32_t width, uint32_t height, uint32_t samples,
+                                 TextureFormat format = TextureFormat::RGBA, bool fixedSampleLocations = true);
+
   /** \brief generate a copy of the texture. **/
   GlTexture clone() const;
 
   /** \brief copy data from other to this texture.
    *
-   *  If textures have different sizes, the values are interpolated by using NEAREST texture value.
+   *  If textures have different sizes, the values are interpolated with the given filter, i.e., the NEAREST
+   *  texel or LINEAR between texels, where only float and normalized formats can be interpolated LINEAR.
+   *  The copy reuses cached objects of the GlBlitter and does not wait for its completion.
+   *
+   *  \throws GlTextureError if integer, depth or stencil values of different sizes are copied LINEAR.
    **/
-  void copy(const GlTexture& other);
+  void copy(const GlTexture& other, TexMagOp filter = TexMagOp::NEAREST);
 
   /** \brief bind the texture to the currently active texture unit.
    *
@@ -101,6 +138,9 @@ class GlTexture : public GlObject {
 
   void release() override;
 
+  /** \brief texture object shared by all copies; a resize of immutable storage replaces it in all copies. **/
+  GLuint id() const override;
+
   // TODO: expose remaining texture parameters by virtue of getter/setters.
 
   /** \brief set the filtering operation if texture is projected on smaller elements (squashed). **/
@@ -125,36 +165,89 @@ class GlTexture : public GlObject {
    */
   void setTextureSwizzle(TexSwizzle red, TexSwizzle green, TexSwizzle blue, TexSwizzle alpha);
 
-  /** \brief Assign data to the texture. **/
+  /** \brief Assign data to the texture.
+   *
+   *  \throws GlTextureError if the pixel type does not match the type of typed data (see pixelTypeMatches).
+   **/
   template <typename T>
   void assign(PixelFormat pixelfmt, PixelType type, T* data);
 
+  /** \brief Assign data to the texture, where the pixel type is inferred from T (see PixelTypeOf). **/
+  template <typename T>
+  void assign(PixelFormat pixelfmt, T* data);
+
+  /** \brief Assign data to the texture, where pixel format and type are inferred from T and the texture format.
+   *
+   *  \throws GlTextureError if data has less values than the texture.
+   **/
+  template <typename T>
+  void assign(const std::vector<T>& data);
+
+  /** \brief Assign data to the region [x, x + width) x [y, y + height) x [z, z + depth) of the texture.
+   *
+   *  Only the data of the region is uploaded into the existing storage, e.g., a single row or a single
+   *  slice of a 3D texture. For one-dimensional textures, y = z = 0 and height = depth = 1; for
+   *  two-dimensional textures, z = 0 and depth = 1.
+   *
+   *  \throws GlTextureError if the region exceeds the texture.
+   **/
+  template <typename T>
+  void assignRegion(uint32_t x, uint32_t y, uint32_t z, uint32_t width, uint32_t height, uint32_t depth,
+                    PixelFormat pixelfmt, PixelType type, T* data);
+
+  /** \brief Assign data to a single layer of a 2D array texture or slice of a 3D texture. **/
+  template <typename T>
+  void assignLayer(uint32_t layer, PixelFormat pixelfmt, PixelType type, T* data);
+
+  /** \brief Assign data with rows in the given layout, e.g., with padded rows of a cv::Mat. **/
+  template <typename T>
+  void assign(PixelFormat pixelfmt, PixelType type, T* data, const PixelStore& layout);
+
+  /** \brief Assign pixels of the image file directly from its mapping; rows are flipped on the GPU if needed.
+   *
+   *  \throws GlTextureError if the texture is not two-dimensional or has another size than the image.
+   **/
+  void assign(const GlImageFile& image);
+
+  /** \brief Assign data with rows in the given layout to the region of the texture.
+   *
+   *  \see assignRegion(x, y, z, width, height, depth, pixelfmt, type, data)
+   **/
+  template <typename T>
+  void assignRegion(uint32_t x, uint32_t y, uint32_t z, uint32_t width, uint32_t height, uint32_t depth,
+                    PixelFormat pixelfmt, PixelType type, T* data, const PixelStore& layout);
+
   /** \brief resizing the texture to given dimensions.
    *
-   *  FIXME: resize currently causes loss of all old information.
+   *  With TexResizeMode::PRESERVE, the overlapping region of old and new texture is kept. All copies of the
+   *  GlTexture share the size and the texture object; thus, all copies see the new size. The texture object
+   *  stays the same, i.e., attachments to framebuffers stay valid. Only for immutable storage (see
+   *  immutable()) a new texture object is generated, since the storage cannot be allocated again; the new
+   *  texture object replaces the old one in all copies and is attached again by GlFramebuffer::bind().
    **/
-  void resize(uint32_t width);
+  void resize(uint32_t width, TexResizeMode mode = TexResizeMode::DISCARD);
 
   /** \brief resizing the texture to given dimensions.
    *
-   *  FIXME: resize currently causes loss of all old information.
+   *  \see resize(uint32_t width, TexResizeMode mode)
    **/
-  void resize(uint32_t width, uint32_t height);
+  void resize(uint32_t width, uint32_t height, TexResizeMode mode = TexResizeMode::DISCARD);
 
   /** \brief resizing the texture to given dimensions.
    *
-   *  FIXME: resize currently causes loss of all old information.
+   *  \see resize(uint32_t width, TexResizeMode mode)
    **/
-  void resize(uint32_t width, uint32_t height, uint32_t depth);
+  void resize(uint32_t width, uint32_t height, uint32_t depth, TexResizeMode mode = TexResizeMode::DISCARD);
 
   uint32_t width() const;
   uint32_t height() const;
+  /** \brief depth of a 3D texture or number of layers of a 2D array texture; 0 otherwise. **/
   uint32_t depth() const;
 
   /** \brief save texture to specified file with given filename.
    *
-   *  Depending on the available libraries, different file types are supported. The
-   *  file type is inferred from the extension of the filename.
+   *  The file type is inferred from the extension of the filename (see GlSnapshotWriter). The texture
+   *  is read back and written on the calling thread; use a GlSnapshotWriter for frequent snapshots.
    *
    *  \return true, if file could be written to the specified location. false, otherwise.
    **/
@@ -162,30 +255,100 @@ class GlTexture : public GlObject {
 
   /** \brief load texture from specified file with given filename.
    *
-   *  Depending on the available libraries, different input file types are supported. The
-   *  actual file type is inferred from the extension of the filename.
+   *  Binary PGM/PPM, PFM, and raw files are supported (see GlImageFile). The file type is inferred
+   *  from the header of the file. The texture gets the size of the image and a sized format, which
+   *  holds the values without loss, e.g., TextureFormat::R16 for a 16 bit PGM file.
    *
-   *  \throw GlTextureError
+   *  \throw GlTextureError if the file cannot be read or has an unsupported type.
    */
   static GlTexture loadTexture(const std::string& filename);
+  /** \brief load texture from an already opened image file, e.g., of a GlImageLoader. **/
+  static GlTexture loadTexture(const GlImageFile& image);
 
   /** \brief download the texture to the given vector.
    *
-   *  TODO: enforce correct format.
+   *  The pixel type is inferred from T (see PixelTypeOf). Vector types, e.g., vec4, get as many
+   *  components as they have; otherwise, every pixel gets the components of the texture format.
+   *  Float data of integer textures is converted, where missing components are 0.
    **/
   template <typename T>
   void download(std::vector<T>& data) const;
 
+  /** \brief download the texture to ptr like download(std::vector<T>&). **/
   template <typename T>
   void download(T* ptr) const;
 
+  /** \brief download the texture in the given pixel format; the pixel type is inferred from T. **/
   template <typename T>
   void download(PixelFormat pixelfmt, T* ptr) const;
 
-  /** \brief generate Mipmaps. **/
+  /** \brief download the region [x, x + width) x [y, y + height) of the given mip level and layer.
+   *
+   *  The layer is the slice of a 3D texture or the layer of a 2D array texture; for one-dimensional textures,
+   *  y = 0 and height = 1. The rows are written tightly packed to data, i.e., without padding.
+   *
+   *  \throws GlTextureError if the region, level, or layer exceeds the texture.
+   **/
+  void downloadRegion(uint32_t x, uint32_t y, uint32_t width, uint32_t height, PixelFormat pixelfmt, PixelType type,
+                      void* data, uint32_t level = 0, uint32_t layer = 0) const;
+
+  /** \brief download a single layer of a 2D array texture or slice of a 3D texture. **/
+  void downloadLayer(uint32_t layer, PixelFormat pixelfmt, PixelType type, void* data) const;
+
+  /** \brief download the texture with rows in the given layout, e.g., into a cv::Mat with padded rows. **/
+  void download(PixelFormat pixelfmt, PixelType type, void* data, const PixelStore& layout) const;
+
+  /** \brief download the region with rows in the given layout.
+   *
+   *  \see downloadRegion(x, y, width, height, pixelfmt, type, data, level, layer)
+   **/
+  void downloadRegion(uint32_t x, uint32_t y, uint32_t width, uint32_t height, PixelFormat pixelfmt, PixelType type,
+                      void* data, const PixelStore& layout, uint32_t level = 0, uint32_t layer = 0) const;
+
+  /** \brief generate Mipmaps.
+   *
+   *  Only the allocated levels are generated, i.e., the texture must be created with levels > 1.
+   **/
   void generateMipmaps();
 
+  /** \brief number of allocated mip levels. **/
+  uint32_t levels() const;
+
+  /** \brief number of samples per pixel of a multisample texture; 0 otherwise. **/
+  uint32_t samples() const;
+
+  /** \brief has the texture immutable storage allocated with glTexStorage (OpenGL 4.2)?
+   *
+   *  Immutable storage is allocated once with all levels and then only filled by assign, etc.
+   *  A resize of a texture with immutable storage therefore creates a new texture object.
+   **/
+  bool immutable() const;
+
+  /** \brief number of mip levels of a complete mipmap chain for the given dimensions. **/
+  static uint32_t maxLevels(uint32_t width, uint32_t height = 1, uint32_t depth = 1);
+
  protected:
+  /** \brief texture without texture object and storage, e.g., for GlTextureView. **/
+  GlTexture();
+
+  /** \brief create texture of given target and allocate its storage; unused dimensions are 0. **/
+  GlTexture(GLenum target, uint32_t width, uint32_t height, uint32_t depth, TextureFormat format, uint32_t levels);
+
+  /** \brief upload data to region; without layout, the rows are tightly packed (see PixelStore::tight). **/
+  template <typename T>
+  void subImage(uint32_t x, uint32_t y, uint32_t z, uint32_t width, uint32_t height, uint32_t depth,
+                PixelFormat pixelfmt, PixelType type, T* data, const PixelStore* layout);
+
+  /** \brief download region; without layout, the rows are tightly packed (see PixelStore::tight). **/
+  void readRegion(uint32_t x, uint32_t y, uint32_t width, uint32_t height, PixelFormat pixelfmt, PixelType type,
+                  void* data, uint32_t level, uint32_t layer, const PixelStore* layout) const;
+
+  /** \brief generate new texture object. **/
+  void generate();
+
+  /** \brief sized internal format needed for immutable storage. **/
+  static GLenum sizedFormat(TextureFormat format);
+
   //    const std::shared_ptr<GLuint>& ptr() const
   //    {
   //      return ptr_;
@@ -196,31 +359,149 @@ class GlTexture : public GlObject {
 
   void allocateMemory();
 
+  /** \brief set new dimensions and allocate memory, where the content is kept as given by mode. **/
+  void reallocate(uint32_t width, uint32_t height, uint32_t depth, TexResizeMode mode);
+
   static uint32_t numComponents(TextureFormat format);
+
+  /** \brief download level 0; the layout is only set if given. **/
+  void downloadImage(PixelFormat pixelfmt, PixelType type, void* data, const PixelStore* layout) const;
+  /** \brief download level 0 with given number of components per pixel. **/
+  void downloadComponents(uint32_t components, PixelType type, void* data) const;
   static GLuint boundTexture_;
 
-  uint32_t width_, height_{0}, depth_{0};
+  /** \brief description of the texture for the GlBlitter. **/
+  GlBlitTexture blitTexture() const;
+
+  /** \brief is the texture an array of textures, whose layers keep their number for all mip levels? **/
+  bool layered() const {
+    return target_ == GL_TEXTURE_2D_ARRAY;
+  }
+
+  /** \brief number of pixels (or voxels) of the texture. **/
+  uint64_t numPixels() const {
+    return static_cast<uint64_t>(storage_->width) * std::max<uint32_t>(storage_->height, 1) *
+           std::max<uint32_t>(storage_->depth, 1);
+  }
+
+  /** \brief texture object and its dimensions, which are shared by all copies of the texture.
+   *
+   *  Thus, a resize of any copy, e.g., of the copy attached to a GlFramebuffer, is seen by all copies. With
+   *  immutable storage, the copies also get the new texture object. The texture object is deleted with the
+   *  last copy; ptr_ is therefore not used by textures.
+   **/
+  struct Storage {
+   public:
+    ~Storage();
+
+    GLuint id{0};
+    uint32_t width{0}, height{0}, depth{0};
+    uint32_t levels{1};
+    bool immutable{false};
+  };
+
+  std::shared_ptr<Storage> storage_{std::make_shared<Storage>()};
+  uint32_t samples_{0};
+  bool fixedSampleLocations_{true};
+  bool view_{false};
   GLenum target_;
   TextureFormat format_;
+  TextureFormatInfo info_;  // properties of format_, looked up once instead of for every transfer.
 };
 
 template <typename T>
 void GlTexture::assign(PixelFormat pixelfmt, PixelType pixeltype, T* data) {
-  GLuint old_id = bindTransparently();
+  // storage is already allocated; thus, only the data is uploaded.
+  assignRegion(0, 0, 0, storage_->width, std::max<uint32_t>(storage_->height, 1),
+               std::max<uint32_t>(storage_->depth, 1), pixelfmt, pixeltype, data);
+}
+
+template <typename T>
+void GlTexture::assignRegion(uint32_t x, uint32_t y, uint32_t z, uint32_t width, uint32_t height, uint32_t depth,
+                             PixelFormat pixelfmt, PixelType pixeltype, T* data) {
+  subImage(x, y, z, width, height, depth, pixelfmt, pixeltype, data, nullptr);
+}
+
+template <typename T>
+void GlTexture::assign(PixelFormat pixelfmt, T* data) {
+  assign(pixelfmt, PixelTypeOf<T>::type, data);
+}
+
+template <typename T>
+void GlTexture::assign(const std::vector<T>& data) {
+  const TextureFormatInfo& info = info_;
+  uint32_t components = (PixelTypeOf<T>::components > 1) ? PixelTypeOf<T>::components : info.components;
+  if (data.size() * PixelTypeOf<T>::components < numPixels() * components) {
+    throw GlTextureError("Data has less values than the texture.");
+  }
+
+  assign(pixelFormatOf(info, components), PixelTypeOf<T>::type, &data[0]);
+}
+
+template <typename T>
+void GlTexture::download(std::vector<T>& data) const {
+  uint32_t components = (PixelTypeOf<T>::components > 1) ? PixelTypeOf<T>::components : info_.components;
+  data.resize(numPixels() * components / PixelTypeOf<T>::components);
+  downloadComponents(components, PixelTypeOf<T>::type, &data[0]);
+}
+
+template <typename T>
+void GlTexture::download(T* ptr) const {
+  uint32_t components = (PixelTypeOf<T>::components > 1) ? PixelTypeOf<T>::components : info_.components;
+  downloadComponents(components, PixelTypeOf<T>::type, ptr);
+}
+
+template <typename T>
+void GlTexture::download(PixelFormat pixelfmt, T* ptr) const {
+  downloadImage(pixelfmt, PixelTypeOf<T>::type, ptr, nullptr);
+}
 
-  // TODO: possible to have pixeltype == T?
+template <typename T>
+void GlTexture::assignLayer(uint32_t layer, PixelFormat pixelfmt, PixelType pixeltype, T* data) {
+  if (storage_->depth == 0) throw GlTextureError("Texture has no layers.");
+  subImage(0, 0, layer, storage_->width, storage_->height, 1, pixelfmt, pixeltype, data, nullptr);
+}
+
+template <typename T>
+void GlTexture::assign(PixelFormat pixelfmt, PixelType pixeltype, T* data, const PixelStore& layout) {
+  subImage(0, 0, 0, storage_->width, std::max<uint32_t>(storage_->height, 1), std::max<uint32_t>(storage_->depth, 1),
+           pixelfmt, pixeltype, data, &layout);
+}
+
+template <typename T>
+void GlTexture::assignRegion(uint32_t x, uint32_t y, uint32_t z, uint32_t width, uint32_t height, uint32_t depth,
+                             PixelFormat pixelfmt, PixelType pixeltype, T* data, const PixelStore& layout) {
+  subImage(x, y, z, width, height, depth, pixelfmt, pixeltype, data, &layout);
+}
+
+template <typename T>
+void GlTexture::subImage(uint32_t x, uint32_t y, uint32_t z, uint32_t width, uint32_t height, uint32_t depth,
+                         PixelFormat pixelfmt, PixelType pixeltype, T* data, const PixelStore* layout) {
+  if (x + width > storage_->width || y + height > std::max<uint32_t>(storage_->height, 1) ||
+      z + depth > std::max<uint32_t>(storage_->depth, 1)) {
+    throw GlTextureError("Region exceeds the dimensions of the texture.");
+  }
+  if (samples_ > 0) throw GlTextureError("Unable to assign data to a multisample texture.");
+  if (!pixelTypeMatches<T>(pixeltype)) throw GlTextureError("Pixel type does not match the type of the data.");
+  if (width == 0 || height == 0 || depth == 0) return;
+
+  GLuint old_id = bindTransparently();
+  // the default alignment of 4 would pad rows, which the sizes of the typed overloads do not expect.
+  PixelStore previous = (layout != nullptr) ? layout->apply(false) : PixelStore::tight().apply(false);
 
   if (target_ == GL_TEXTURE_1D) {
-    glTexImage1D(target_, 0, static_cast<GLint>(format_), width_, 0, static_cast<GLenum>(pixelfmt),
-                 static_cast<GLenum>(pixeltype), data);
-  } else if (target_ == GL_TEXTURE_2D) {
-    glTexImage2D(target_, 0, static_cast<GLint>(format_), width_, height_, 0, static_cast<GLenum>(pixelfmt),
-                 static_cast<GLenum>(pixeltype), data);
-  } else if (target_ == GL_TEXTURE_3D) {
-    glTexImage3D(target_, 0, static_cast<GLint>(format_), width_, height_, depth_, 0, static_cast<GLenum>(pixelfmt),
-                 static_cast<GLenum>(pixeltype), data);
+    glTexSubImage1D(target_, 0, x, width, static_cast<GLenum>(pixelfmt), static_cast<GLenum>(pixeltype), data);
+  } else if (target_ == GL_TEXTURE_2D || target_ == GL_TEXTURE_RECTANGLE) {
+    glTexSubImage2D(target_, 0, x, y, width, height, static_cast<GLenum>(pixelfmt), static_cast<GLenum>(pixeltype),
+                    data);
+  } else if (target_ == GL_TEXTURE_3D || target_ == GL_TEXTURE_2D_ARRAY) {
+    glTexSubImage3D(target_, 0, x, y, z, width, height, depth, static_cast<GLenum>(pixelfmt),
+                    static_cast<GLenum>(pixeltype), data);
   }
+  GLOW_STATS_UPLOADED(static_cast<uint64_t>(width) * height * depth * pixelComponents(pixelfmt) *
+                      pixelTypeSize(pixeltype));
 
+  previous.apply(false);
   releaseTransparently(old_id);
 }
 
@@ -2,7 +2,7 @@
 #define INCLUDE_RV_GLTEXTUREBUFFER_H_
 
 #include "GlBuffer.h"
-#include "GlTextureFormat.h"
+#include "GlFormatTraits.h"
 
 namespace glow {
 
@@ -20,16 +20,19 @@ class GlTextureBuffer : public GlObject {
       : format_(format) {
     buffer_ = buffer.ptr_;  // hold pointer to avoid deallocation before texture object is deallocated.
     glGenTextures(1, &id_);
+    GLOW_STATS_CREATED(TEXTURE);
 
     ptr_ = std::shared_ptr<GLuint>(new GLuint(id_), [](GLuint* ptr) {
       glDeleteTextures(1, ptr);
+      GLOW_STATS_DESTROYED(TEXTURE);
       delete ptr;
     });
 
     GLuint old_id = bindTransparently();
-    GLint texFormat = static_cast<GLint>(format_);
+    GLint texFormat = textureFormatInfo(format_).sizedFormat;
     buffer.bind();
     glTexBuffer(GL_TEXTURE_BUFFER, texFormat, buffer.id());
+    GLOW_STATS_CALL(STATE);
     buffer.release();
     releaseTransparently(old_id);
 
@@ -38,19 +41,25 @@ class GlTextureBuffer : public GlObject {
 
   void bind() override {
     glBindTexture(GL_TEXTURE_BUFFER, id_);
+    GLOW_STATS_CALL(BIND_TEXTURE);
     boundTexture_ = id_;
   }
 
   void release() override {
     glBindTexture(GL_TEXTURE_BUFFER, 0);
+    GLOW_STATS_CALL(BIND_TEXTURE);
     boundTexture_ = 0;
   }
 
  protected:
   GLuint bindTransparently() const {
-    if (boundTexture_ == id_) return id_;
+    if (boundTexture_ == id_) {
+      GLOW_STATS_REDUNDANT_BIND();
+      return id_;
+    }
 
     glBindTexture(GL_TEXTURE_BUFFER, id_);
+    GLOW_STATS_CALL(BIND_TEXTURE);
 
     return boundTexture_;
   }
@@ -59,6 +68,7 @@ class GlTextureBuffer : public GlObject {
     if (old_id == id_) return;
 
     glBindTexture(GL_TEXTURE_BUFFER, old_id);
+    GLOW_STATS_CALL(BIND_TEXTURE);
   }
 
   static GLuint boundTexture_;
@@ -24,9 +24,51 @@ enum class TextureFormat {
   RGB = GL_RGB,    // values in [0.0, 1.0]
   RG = GL_RG,      // values in [0.0, 1.0]
   R = GL_RED,      // values in [0.0, 1.0]
-  DEPTH = GL_DEPTH,
+  DEPTH = GL_DEPTH_COMPONENT,
   DEPTH_STENCIL = GL_DEPTH24_STENCIL8,
 
+  // gray values in a single red channel, which is returned as (R, R, R, 1.0) by samplers:
+  GRAY = GL_LUMINANCE8,  // only used as tag; stored as GL_R8.
+
+  // sized 8-bit formats:
+  R8 = GL_R8,  // values in [0.0, 1.0]
+  RG8 = GL_RG8,
+  RGB8 = GL_RGB8,
+  RGBA8 = GL_RGBA8,
+  R8_SNORM = GL_R8_SNORM,  // values in [-1.0, 1.0]
+  RG8_SNORM = GL_RG8_SNORM,
+  RGBA8_SNORM = GL_RGBA8_SNORM,
+  R8UI = GL_R8UI,
+  RG8UI = GL_RG8UI,
+  RGBA8UI = GL_RGBA8UI,
+  R8I = GL_R8I,
+  RG8I = GL_RG8I,
+  RGBA8I = GL_RGBA8I,
+
+  // sized 16-bit formats:
+  R16 = GL_R16,  // values in [0.0, 1.0]
+  RG16 = GL_RG16,
+  RGB16 = GL_RGB16,
+  RGBA16 = GL_RGBA16,
+  R16_SNORM = GL_R16_SNORM,  // values in [-1.0, 1.0]
+  RG16_SNORM = GL_RG16_SNORM,
+  RGBA16_SNORM = GL_RGBA16_SNORM,
+  R16UI = GL_R16UI,
+  RG16UI = GL_RG16UI,
+  RGBA16UI = GL_RGBA16UI,
+  R16I = GL_R16I,
+  RG16I = GL_RG16I,
+  RGBA16I = GL_RGBA16I,
+  R16F = GL_R16F,  // half floats
+  RG16F = GL_RG16F,
+  RGB16F = GL_RGB16F,
+  RGBA16F = GL_RGBA16F,
+
+  // sized depth formats:
+  DEPTH16 = GL_DEPTH_COMPONENT16,
+  DEPTH24 = GL_DEPTH_COMPONENT24,
+  DEPTH32F = GL_DEPTH_COMPONENT32F,
+
   // Some explicit 32-bit texture formats:
   R_INTEGER = GL_R32I,
   RG_INTEGER = GL_RG32I,
@@ -37,10 +79,6 @@ enum class TextureFormat {
   RG_FLOAT = GL_RG32F,
   RGB_FLOAT = GL_RGB32F,
   RGBA_FLOAT = GL_RGBA32F
-
-  // custom formats
-  // TODO: INTENSITY = GL_R, // GRAY => GL_R and swizzle mask (R, R, R, 1.0)
-
 };
 }
 
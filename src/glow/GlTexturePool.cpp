@@ -0,0 +1,141 @@
+#include "GlTexturePool.h"
+
+#include <algorithm>
+
+#include "glexception.h"
+
+namespace glow {
+
+bool GlTexturePool::Key::operator==(const Key& other) const {
+  return target == other.target && width == other.width && height == other.height && depth == other.depth &&
+         format == other.format && levels == other.levels;
+}
+
+GlTexturePool::GlTexturePool(size_t maxBytes) : free_(std::make_shared<FreeList>()) {
+  free_->maxBytes = maxBytes;
+}
+
+std::shared_ptr<GlTexture> GlTexturePool::acquire(uint32_t width, TextureFormat format, uint32_t levels) {
+  return acquire(Key{GL_TEXTURE_1D, width, 0, 0, format, levels});
+}
+
+std::shared_ptr<GlTexture> GlTexturePool::acquire(uint32_t width, uint32_t height, TextureFormat format,
+                                                  uint32_t levels) {
+  return acquire(Key{GL_TEXTURE_2D, width, height, 0, format, levels});
+}
+
+std::shared_ptr<GlTexture> GlTexturePool::acquire(uint32_t width, uint32_t height, uint32_t depth,
+                                                  TextureFormat format, uint32_t levels) {
+  return acquire(Key{GL_TEXTURE_3D, width, height, depth, format, levels});
+}
+
+std::shared_ptr<GlTexture> GlTexturePool::acquireArray(uint32_t width, uint32_t height, uint32_t layers,
+                                                       TextureFormat format, uint32_t levels) {
+  return acquire(Key{GL_TEXTURE_2D_ARRAY, width, height, layers, format, levels});
+}
+
+std::shared_ptr<GlTexture> GlTexturePool::clone(const GlTexture& texture) {
+  if (texture.samples_ > 0) throw GlTextureError("Multisample textures cannot be leased from a texture pool.");
+
+  std::shared_ptr<GlTexture> lease = acquire(
+      Key{texture.target_, texture.width(), texture.height(), texture.depth(), texture.format_, texture.levels()});
+  lease->copy(texture);
+
+  return lease;
+}
+
+std::shared_ptr<GlTexture> GlTexturePool::acquire(const Key& key) {
+  std::list<Entry>& entries = free_->entries;
+  auto it = std::find_if(entries.begin(), entries.end(), [&key](const Entry& entry) { return entry.key == key; });
+
+  GlTexture* texture = nullptr;
+  if (it != entries.end()) {
+    texture = it->texture.release();
+    free_->bytes -= it->bytes;
+    entries.erase(it);
+  } else {
+    texture = create(key);
+  }
+
+  // the lease does not keep the pool alive; without pool, the texture is simply deleted.
+  std::weak_ptr<FreeList> weak = free_;
+  return std::shared_ptr<GlTexture>(texture, [weak, key](GlTexture* ptr) {
+    std::shared_ptr<FreeList> free = weak.lock();
+    if (free != nullptr) {
+      free->release(key, ptr);
+    } else {
+      delete ptr;
+    }
+  });
+}
+
+void GlTexturePool::setMaxBytes(size_t maxBytes) {
+  free_->maxBytes = maxBytes;
+  free_->trim();
+}
+
+size_t GlTexturePool::maxBytes() const {
+  return free_->maxBytes;
+}
+
+size_t GlTexturePool::freeBytes() const {
+  return free_->bytes;
+}
+
+uint32_t GlTexturePool::freeTextures() const {
+  return free_->entries.size();
+}
+
+void GlTexturePool::clear() {
+  free_->entries.clear();
+  free_->bytes = 0;
+}
+
+void GlTexturePool::FreeList::release(const Key& key, GlTexture* texture) {
+  if (!reusable(key, *texture)) {
+    delete texture;
+    return;
+  }
+
+  Entry entry;
+  entry.key = key;
+  entry.texture.reset(texture);
+  entry.bytes = bytesOf(key);
+  bytes += entry.bytes;
+  entries.push_front(std::move(entry));
+
+  trim();
+}
+
+void GlTexturePool::FreeList::trim() {
+  while (bytes > maxBytes && !entries.empty()) {
+    bytes -= entries.back().bytes;
+    entries.pop_back();
+  }
+}
+
+GlTexture* GlTexturePool::create(const Key& key) {
+  return new GlTexture(key.target, key.width, key.height, key.depth, key.format, key.levels);
+}
+
+size_t GlTexturePool::bytesOf(const Key& key) {
+  size_t texel = texelSize(textureFormatInfo(key.format));
+
+  size_t bytes = 0;
+  for (uint32_t level = 0; level < key.levels; ++level) {
+    size_t width = std::max<uint32_t>(key.width >> level, 1);
+    size_t height = std::max<uint32_t>(key.height >> level, 1);
+    size_t depth = (key.target == GL_TEXTURE_2D_ARRAY) ? key.depth : std::max<uint32_t>(key.depth >> level, 1);
+    bytes += width * height * depth * texel;
+  }
+
+  return bytes;
+}
+
+bool GlTexturePool::reusable(const Key& key, const GlTexture& texture) {
+  // resized textures or textures still referenced, e.g., by a framebuffer, cannot be handed out again.
+  Key current{texture.target_, texture.width(), texture.height(), texture.depth(), texture.format_, texture.levels()};
+  return (current == key) && texture.storage_.unique();
+}
+
+} /* namespace glow */
@@ -0,0 +1,113 @@
+#ifndef INCLUDE_GLOW_GLTEXTUREPOOL_H_
+#define INCLUDE_GLOW_GLTEXTUREPOOL_H_
+
+#include <stdint.h>
+#include <list>
+#include <memory>
+
+#include "GlTexture.h"
+
+namespace glow {
+
+/** \brief Recycles temporary textures instead of generating and deleting texture objects every frame.
+ *
+ *  The pool hands out leases of textures with given target, size, format, and mip levels. If the lease
+ *  is released, i.e., the last copy of the returned shared_ptr is destroyed, the texture is not deleted,
+ *  but put into the free list of the pool. A subsequent acquire with the same parameters reuses the
+ *  texture; thus, a pipeline with the same intermediate textures in every frame generates texture objects
+ *  only in the first frame:
+ *
+ *    std::shared_ptr<GlTexture> tmp = pool.acquire(width, height, TextureFormat::R16F);
+ *    converter.convert(input, *tmp);
+ *    ...
+ *    tmp = nullptr;  // back into the pool.
+ *
+ *  Recycled textures keep their content and texture parameters (filtering, wrapping, ...) of the previous
+ *  lease. If the free textures exceed maxBytes(), the least recently released textures are deleted.
+ *
+ *  A released texture is only recycled if no copy of the GlTexture object holds the texture object anymore.
+ *  A GlFramebuffer (or GlFramebufferCache) keeps its own copy of attached textures; thus, a lease released
+ *  while the texture is still attached is not recycled, but only deleted with the framebuffer. To recycle
+ *  render targets, the framebuffer must be destroyed or attach other textures first. Leases may outlive
+ *  the pool.
+ **/
+class GlTexturePool {
+ public:
+  /** \brief pool, which keeps free textures up to maxBytes of (estimated) texture memory. **/
+  explicit GlTexturePool(size_t maxBytes = 256 * 1024 * 1024);
+
+  GlTexturePool(const GlTexturePool&) = delete;
+  GlTexturePool& operator=(const GlTexturePool&) = delete;
+
+  /** \brief lease one-dimensional texture. **/
+  std::shared_ptr<GlTexture> acquire(uint32_t width, TextureFormat format, uint32_t levels = 1);
+  /** \brief lease two-dimensional texture. **/
+  std::shared_ptr<GlTexture> acquire(uint32_t width, uint32_t height, TextureFormat format, uint32_t levels = 1);
+  /** \brief lease three-dimensional texture. **/
+  std::shared_ptr<GlTexture> acquire(uint32_t width, uint32_t height, uint32_t depth, TextureFormat format,
+                                     uint32_t levels = 1);
+  /** \brief lease 2D array texture with given number of layers (see GlTexture::array2D). **/
+  std::shared_ptr<GlTexture> acquireArray(uint32_t width, uint32_t height, uint32_t layers, TextureFormat format,
+                                          uint32_t levels = 1);
+
+  /** \brief lease a texture like the given one with a copy of its content (see GlTexture::clone). **/
+  std::shared_ptr<GlTexture> clone(const GlTexture& texture);
+
+  /** \brief set maximal size of free textures in bytes; 0 disables recycling. **/
+  void setMaxBytes(size_t maxBytes);
+  size_t maxBytes() const;
+
+  /** \brief (estimated) size of the free textures in bytes. **/
+  size_t freeBytes() const;
+  /** \brief number of free textures. **/
+  uint32_t freeTextures() const;
+
+  /** \brief delete all free textures, e.g., before the context is destroyed. **/
+  void clear();
+
+ protected:
+  struct Key {
+   public:
+    GLenum target;
+    uint32_t width, height, depth;
+    TextureFormat format;
+    uint32_t levels;
+
+    bool operator==(const Key& other) const;
+  };
+
+  struct Entry {
+   public:
+    Key key;
+    std::unique_ptr<GlTexture> texture;
+    size_t bytes;
+  };
+
+  /** \brief free list shared with the leases, which release their textures into it. **/
+  struct FreeList {
+   public:
+    /** \brief put texture back or delete it, if it cannot be recycled. **/
+    void release(const Key& key, GlTexture* texture);
+    /** \brief delete least recently released textures until the free textures fit into maxBytes. **/
+    void trim();
+
+    std::list<Entry> entries;  // most recently released first.
+    size_t bytes{0};
+    size_t maxBytes;
+  };
+
+  std::shared_ptr<GlTexture> acquire(const Key& key);
+
+  /** \brief create new texture with the parameters of key. **/
+  static GlTexture* create(const Key& key);
+  /** \brief (estimated) size of all levels of a texture in bytes. **/
+  static size_t bytesOf(const Key& key);
+  /** \brief has the texture still the parameters of key and is not shared? **/
+  static bool reusable(const Key& key, const GlTexture& texture);
+
+  std::shared_ptr<FreeList> free_;
+};
+
+} /* namespace glow */
+
+#endif /* INCLUDE_GLOW_GLTEXTUREPOOL_H_ */
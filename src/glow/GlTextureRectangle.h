@@ -1,16 +1,11 @@
 #ifndef INCLUDE_RV_GLTEXTURERECTANGLE_H_
 #define INCLUDE_RV_GLTEXTURERECTANGLE_H_
 
-#include <vector>
-#include "GlObject.h"
-#include "GlPixelFormat.h"
-#include "GlTextureFormat.h"
+#include <string>
+#include "GlTypedTexture.h"
 
 namespace glow {
 
-// forward declaration
-class GlTexture;
-
 enum class TexRectMinOp { LINEAR = GL_LINEAR, NEAREST = GL_NEAREST };
 
 enum class TexRectMagOp { LINEAR = GL_LINEAR, NEAREST = GL_NEAREST };
@@ -50,48 +45,20 @@ enum class TexRectSwizzle { R = GL_RED, G = GL_GREEN, B = GL_BLUE, A = GL_ALPHA,
  *  rectangular texture does not do the conversion to "texture coordinates" in range
  *  [0,1], this type of texture does only support a single layer of textures and thus no
  *  mipmapping. Furthermore, only two-dimensional rectangular textures are supported by
- *  OpenGL. Apart from that, it should be the same as a "normal" texture.
- *
- *  TODO: implement compatible texture's functionality.
+ *  OpenGL. Apart from that, it is the same as a GlTexture2D.
  *
- *  \see GlFramebuffer
+ *  \see GlFramebuffer, GlTypedTexture
  *
  *  \author behley
  **/
-class GlTextureRectangle : public GlObject {
+class GlTextureRectangle : public GlTypedTexture<GL_TEXTURE_RECTANGLE> {
  public:
-  friend class GlFramebuffer;
-
   /** \brief create and allocate rectangular texture of given size and format. **/
   GlTextureRectangle(uint32_t width, uint32_t height, TextureFormat);
 
-  ~GlTextureRectangle();
-
   /** \brief generate a copy of the texture. **/
   GlTextureRectangle clone() const;
 
-  /** \brief copy data from other to this texture.
-   *
-   *  If textures have different sizes, the values are interpolated by using NEAREST texture value.
-   **/
-  void copy(const GlTextureRectangle& other);
-
-  /** \brief copy data from another texture. **/
-  void copy(const GlTexture& other);
-
-  /** \brief bind the texture to the currently active texture unit.
-   *
-   *  Use glActiveTexture(...) to activate a specific texture unit before calling bind.
-   *
-   *  FIXME: bind(id) and release(id)
-   *  FIXME: ScopedBinder with arguments?
-   */
-  void bind() override;
-
-  void release() override;
-
-  // TODO: expose remaining texture parameters by virtue of getter/setters.
-
   /** \brief set the filtering operation if texture is projected on smaller elements (squashed). **/
   void setMinifyingOperation(TexRectMinOp minifyingOperation);
   /** \brief set the filtering operation if texture is projected on larger elements (enlarged). **/
@@ -110,75 +77,15 @@ class GlTextureRectangle : public GlObject {
    */
   void setTextureSwizzle(TexRectSwizzle red, TexRectSwizzle green, TexRectSwizzle blue, TexRectSwizzle alpha);
 
-  /** \brief Assign data to the texture. **/
-  template <typename T>
-  void assign(PixelFormat pixelfmt, PixelType type, T* data);
-
-  /** \brief resize texture to given dimensions.
-   *
-   * FIXME: currently resize causes loss of all data.
-   */
-  void resize(uint32_t width, uint32_t height);
-
-  uint32_t width() const;
-  uint32_t height() const;
-
-  /** \brief save texture to specified file with given filename.
-   *
-   *  Depending on the available libraries, different file types are supported. The
-   *  file type is inferred from the extension of the filename.
-   *
-   *  \return true, if file could be written to the specified location. false, otherwise.
-   **/
-  bool save(const std::string& filename) const;
-
-  /** \brief load texture from specified file with given filename.
-   *
-   *  Depending on the available libraries, different input file types are supported. The
-   *  actual file type is inferred from the extension of the filename.
-   *
-   *  \throw GlTextureRectangle
-   */
+  /** \brief load texture from specified file with given filename (see GlTexture::loadTexture). **/
   static GlTextureRectangle loadTexture(const std::string& filename);
-
-  /** \brief download the texture to the given vector.
-   *
-   *  TODO: enforce correct format.
-   **/
-  template <typename T>
-  void download(std::vector<T>& data) const;
-
-  template <typename T>
-  void download(T* ptr) const;
-
-  template <typename T>
-  void download(PixelFormat pixelfmt, T* ptr) const;
+  /** \brief load texture from an already opened image file, e.g., of a GlImageLoader. **/
+  static GlTextureRectangle loadTexture(const GlImageFile& image);
 
  protected:
-  GLuint bindTransparently() const;
-  void releaseTransparently(GLuint old_id) const;
-
-  void allocateMemory();
-
-  static uint32_t numComponents(TextureFormat format);
-  static GLuint boundTexture_;
-
-  uint32_t width_, height_;
-  TextureFormat format_;
+  explicit GlTextureRectangle(const GlTexture& texture);
 };
 
-template <typename T>
-void GlTextureRectangle::assign(PixelFormat pixelfmt, PixelType pixeltype, T* data) {
-  GLuint old_id = bindTransparently();
-
-  // TODO: possible to have pixeltype == T?
-
-  glTexImage2D(GL_TEXTURE_RECTANGLE, 0, static_cast<GLint>(format_), width_, height_, 0, static_cast<GLenum>(pixelfmt),
-               static_cast<GLenum>(pixeltype), data);
-
-  releaseTransparently(old_id);
-}
-}
-/* namespace rv */
+} /* namespace glow */
 
 #endif /* INCLUDE_RV_GLTEXTURERECTANGLE_H_ */
@@ -0,0 +1,232 @@
+#include "GlTextureUploader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#include "GlStats.h"
+#include "glexception.h"
+
+namespace glow {
+
+GlTextureUploader::GlTextureUploader(size_t frameSize, uint32_t numBuffers)
+    : frameSize_(frameSize), slots_(numBuffers) {
+  if (frameSize == 0 || numBuffers == 0) throw GlTextureError("Texture uploader needs at least one non-empty buffer.");
+
+#if __GL_VERSION >= 440L
+  persistent_ = true;
+#endif
+
+  for (Slot& slot : slots_) {
+    glGenBuffers(1, &slot.buffer);
+    GLOW_STATS_CREATED(BUFFER);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.buffer);
+#if __GL_VERSION >= 440L
+    // mapped once for the whole lifetime; the fences guarantee that no buffer is written while read by the GPU.
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glBufferStorage(GL_PIXEL_UNPACK_BUFFER, frameSize_, nullptr, flags);
+    slot.ptr = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, frameSize_, flags);
+#else
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, frameSize_, nullptr, GL_STREAM_DRAW);
+#endif
+  }
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+GlTextureUploader::~GlTextureUploader() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cond_.notify_all();
+  if (worker_.joinable()) worker_.join();
+
+  for (Slot& slot : slots_) {
+    if (slot.fence != 0) glDeleteSync(slot.fence);
+    if (slot.ptr != nullptr) {
+      glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.buffer);
+      glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    }
+    glDeleteBuffers(1, &slot.buffer);
+    GLOW_STATS_DESTROYED(BUFFER);
+  }
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+size_t GlTextureUploader::frameSize() const {
+  return frameSize_;
+}
+
+void* GlTextureUploader::map() {
+  {
+    // the worker is started by submit(), which may be called from any thread.
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) throw GlTextureError("Texture uploader is already used with a worker thread.");
+  }
+
+  Slot& slot = slots_[next_];
+  if (slot.state == SlotState::WRITING) return slot.ptr;
+
+  recycle(slot, true);
+  if (slot.state == SlotState::FREE) mapSlot(slot);
+  slot.state = SlotState::WRITING;
+
+  return slot.ptr;
+}
+
+void GlTextureUploader::upload(GlTexture& texture, PixelFormat pixelfmt, PixelType type, const PixelStore& layout) {
+  Slot& slot = slots_[next_];
+  if (slot.state != SlotState::WRITING) throw GlTextureError("Texture upload without preceding map().");
+
+  // check before unmapping; thus, the slot stays mapped and usable if the frame does not fit.
+  checkSize(texture, pixelfmt, type, layout);
+  unmapSlot(slot);
+  transfer(slot, texture, pixelfmt, type, layout);
+  next_ = (next_ + 1) % slots_.size();
+}
+
+void GlTextureUploader::upload(GlTexture& texture, PixelFormat pixelfmt, PixelType type, const void* data) {
+  uint32_t rows = std::max<uint32_t>(texture.height(), 1) * std::max<uint32_t>(texture.depth(), 1);
+  size_t size = PixelStore().size(texture.width(), rows, pixelfmt, type);
+  if (size > frameSize_) throw GlTextureError("Texture data exceeds the frame size of the texture uploader.");
+
+  std::memcpy(map(), data, size);
+  upload(texture, pixelfmt, type);
+}
+
+void GlTextureUploader::submit(const std::function<void(void*, size_t)>& fill) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.push_back(fill);
+    if (!running_) {
+      running_ = true;
+      worker_ = std::thread(&GlTextureUploader::run, this);
+    }
+  }
+  cond_.notify_all();
+}
+
+bool GlTextureUploader::update(GlTexture& texture, PixelFormat pixelfmt, PixelType type, const PixelStore& layout) {
+  bool uploaded = false;
+  {
+    // the worker only touches the slot in state MAPPED or WRITING; thus, the lock is never held long.
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Slot& next = slots_[uploadIdx_];
+    if (next.state == SlotState::FILLED) {
+      checkSize(texture, pixelfmt, type, layout);
+      unmapSlot(next);
+      transfer(next, texture, pixelfmt, type, layout);
+      uploadIdx_ = (uploadIdx_ + 1) % slots_.size();
+      uploaded = true;
+    }
+
+    // provide mapped buffers for the worker without ever waiting for the GPU.
+    for (Slot& slot : slots_) {
+      if (slot.state == SlotState::UPLOADING) recycle(slot, false);
+      if (slot.state == SlotState::FREE) mapSlot(slot);
+    }
+  }
+  cond_.notify_all();
+
+  return uploaded;
+}
+
+uint32_t GlTextureUploader::pending() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  uint32_t count = jobs_.size();
+  for (const Slot& slot : slots_) {
+    if (slot.state == SlotState::WRITING || slot.state == SlotState::FILLED) count += 1;
+  }
+
+  return count;
+}
+
+bool GlTextureUploader::recycle(Slot& slot, bool wait) {
+  if (slot.state != SlotState::UPLOADING) return true;
+
+  GLenum result = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+  while (wait && result == GL_TIMEOUT_EXPIRED) {
+    result = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);  // 1 ms.
+  }
+
+  if (result == GL_WAIT_FAILED) throw GlTextureError("Waiting for texture upload failed.");
+  if (result == GL_TIMEOUT_EXPIRED) return false;
+
+  glDeleteSync(slot.fence);
+  slot.fence = 0;
+  slot.state = SlotState::FREE;
+
+  return true;
+}
+
+void GlTextureUploader::mapSlot(Slot& slot) {
+  if (!persistent_) {
+    // the fence was already signaled; thus, no implicit synchronization is needed.
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.buffer);
+    slot.ptr = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, frameSize_,
+                                GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  }
+  if (slot.ptr == nullptr) throw GlTextureError("Unable to map pixel unpack buffer.");
+
+  slot.state = SlotState::MAPPED;
+}
+
+void GlTextureUploader::unmapSlot(Slot& slot) {
+  if (persistent_) return;
+
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.buffer);
+  glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  slot.ptr = nullptr;
+}
+
+void GlTextureUploader::checkSize(const GlTexture& texture, PixelFormat pixelfmt, PixelType type,
+                                  const PixelStore& layout) const {
+  // the slices of 3D textures directly follow each other.
+  uint32_t rows = std::max<uint32_t>(texture.height(), 1) * std::max<uint32_t>(texture.depth(), 1);
+  size_t size = layout.size(texture.width(), rows, pixelfmt, type);
+  if (size > frameSize_) {
+    std::stringstream error;
+    error << "Texture data of " << size << " bytes exceeds the frame size of the texture uploader (" << frameSize_
+          << " bytes).";
+    throw GlTextureError(error.str());
+  }
+}
+
+void GlTextureUploader::transfer(Slot& slot, GlTexture& texture, PixelFormat pixelfmt, PixelType type,
+                                 const PixelStore& layout) {
+  // with a bound pixel unpack buffer, the data pointer is interpreted as offset into the buffer.
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.buffer);
+  texture.assign(pixelfmt, type, static_cast<const void*>(nullptr), layout);
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+  slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  slot.state = SlotState::UPLOADING;
+}
+
+void GlTextureUploader::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  while (true) {
+    cond_.wait(lock, [this] { return stop_ || (!jobs_.empty() && slots_[fillIdx_].state == SlotState::MAPPED); });
+    if (stop_) return;
+
+    std::function<void(void*, size_t)> fill = std::move(jobs_.front());
+    jobs_.pop_front();
+    Slot& slot = slots_[fillIdx_];
+    slot.state = SlotState::WRITING;
+    void* ptr = slot.ptr;
+
+    // fill the buffer without holding the lock.
+    lock.unlock();
+    fill(ptr, frameSize_);
+    lock.lock();
+
+    slot.state = SlotState::FILLED;
+    fillIdx_ = (fillIdx_ + 1) % slots_.size();
+  }
+}
+
+} /* namespace glow */
@@ -0,0 +1,124 @@
+#ifndef INCLUDE_GLOW_GLTEXTUREUPLOADER_H_
+#define INCLUDE_GLOW_GLTEXTUREUPLOADER_H_
+
+#include <stdint.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "GlTexture.h"
+
+namespace glow {
+
+/** \brief Asynchronous texture uploads via a ring of pixel unpack buffers (PBOs).
+ *
+ *  Instead of GlTexture::assign, which blocks until the driver copied the host data, the data is
+ *  written into a mapped buffer of the ring and the texture is filled from the buffer by the GPU. While
+ *  frame k is transferred, frame k + 1 can already be written into the next buffer. Before a buffer is
+ *  reused, a fence ensures that the GPU finished reading it.
+ *
+ *  With OpenGL 4.4, the buffers are persistently mapped; otherwise, every buffer is mapped for writing
+ *  and unmapped before the transfer.
+ *
+ *  The uploader is used in one of two ways:
+ *
+ *  1. on the GL thread only:
+ *
+ *    void* ptr = uploader.map();
+ *    convert(frame, ptr);  // write at most frameSize() bytes.
+ *    uploader.upload(texture, PixelFormat::RGB, PixelType::FLOAT);
+ *
+ *  2. with a worker thread, which fills the buffers, while the GL thread only issues the transfers:
+ *
+ *    uploader.submit([&frame](void* ptr, size_t size) { convert(frame, ptr); });  // any thread.
+ *    ...
+ *    if (uploader.update(texture, PixelFormat::RGB, PixelType::FLOAT)) { ... }  // GL thread, every frame.
+ *
+ *  Submitted frames are uploaded in order. The rows of the data are given by the layout of upload() and
+ *  update(); by default, rows are tightly packed and aligned to 4 bytes.
+ **/
+class GlTextureUploader {
+ public:
+  /** \brief create ring of numBuffers buffers holding frameSize bytes each. **/
+  GlTextureUploader(size_t frameSize, uint32_t numBuffers = 3);
+  ~GlTextureUploader();
+
+  GlTextureUploader(const GlTextureUploader&) = delete;
+  GlTextureUploader& operator=(const GlTextureUploader&) = delete;
+
+  /** \brief maximal size of a frame in bytes. **/
+  size_t frameSize() const;
+
+  /** \brief get next buffer of the ring for writing; waits if the GPU still reads from the buffer. **/
+  void* map();
+
+  /** \brief transfer the buffer returned by map() to the texture. Returns without waiting for the transfer. **/
+  void upload(GlTexture& texture, PixelFormat pixelfmt, PixelType type, const PixelStore& layout = PixelStore());
+
+  /** \brief copy data into the next buffer and transfer it to the texture. **/
+  void upload(GlTexture& texture, PixelFormat pixelfmt, PixelType type, const void* data);
+
+  /** \brief fill the next free buffer with fill(ptr, frameSize()) on the worker thread.
+   *
+   *  The worker thread is started with the first submit. Can be called from any thread.
+   **/
+  void submit(const std::function<void(void*, size_t)>& fill);
+
+  /** \brief transfer the next frame filled by the worker to the texture, if available.
+   *
+   *  Must be called regularly on the GL thread, since it also recycles and maps the buffers for the worker.
+   *  \return true, if a frame was transferred; false, otherwise.
+   **/
+  bool update(GlTexture& texture, PixelFormat pixelfmt, PixelType type, const PixelStore& layout = PixelStore());
+
+  /** \brief number of submitted frames, which are not yet transferred. **/
+  uint32_t pending() const;
+
+ protected:
+  enum class SlotState {
+    FREE,       // unused and not mapped.
+    MAPPED,     // mapped and ready for writing.
+    WRITING,    // data is written by map() caller or worker.
+    FILLED,     // ready for transfer.
+    UPLOADING,  // transfer issued, fence not yet signaled.
+  };
+
+  struct Slot {
+   public:
+    GLuint buffer{0};
+    void* ptr{nullptr};
+    GLsync fence{0};
+    SlotState state{SlotState::FREE};
+  };
+
+  /** \brief wait for fence of the slot (blocking or not) and mark it as free. **/
+  bool recycle(Slot& slot, bool wait);
+  void mapSlot(Slot& slot);
+  void unmapSlot(Slot& slot);
+  /** \brief throw GlTextureError, if the data of the texture with given layout exceeds the frame size. **/
+  void checkSize(const GlTexture& texture, PixelFormat pixelfmt, PixelType type, const PixelStore& layout) const;
+  /** \brief issue transfer from buffer to texture and set fence. **/
+  void transfer(Slot& slot, GlTexture& texture, PixelFormat pixelfmt, PixelType type, const PixelStore& layout);
+
+  void run();
+
+  size_t frameSize_;
+  bool persistent_{false};
+  std::vector<Slot> slots_;
+  uint32_t next_{0};  // slot of map() and upload().
+
+  // worker thread.
+  mutable std::mutex mutex_;
+  std::condition_variable cond_;
+  std::thread worker_;
+  bool running_{false}, stop_{false};
+  std::deque<std::function<void(void*, size_t)> > jobs_;
+  uint32_t fillIdx_{0}, uploadIdx_{0};
+};
+
+} /* namespace glow */
+
+#endif /* INCLUDE_GLOW_GLTEXTUREUPLOADER_H_ */
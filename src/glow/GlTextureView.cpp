@@ -0,0 +1,55 @@
+#include "GlTextureView.h"
+
+#include <sstream>
+
+#include "glexception.h"
+
+namespace glow {
+
+GlTextureView::GlTextureView(const GlTexture& texture, TextureFormat format, uint32_t minLevel, uint32_t numLevels,
+                             uint32_t minLayer, uint32_t numLayers)
+    : minLevel_(minLevel), minLayer_(minLayer) {
+#if __GL_VERSION >= 430L
+  if (!texture.immutable()) throw GlTextureError("Texture view needs a texture with immutable storage.");
+  if (numLevels == 0 || minLevel + numLevels > texture.levels()) {
+    std::stringstream error;
+    error << "Texture view with levels [" << minLevel << ", " << (minLevel + numLevels)
+          << ") exceeds the levels of the texture (" << texture.levels() << ").";
+    throw GlTextureError(error.str());
+  }
+
+  // dimensions of the first level of the view.
+  target_ = texture.target_;
+  format_ = format;
+  info_ = textureFormatInfo(format);
+  storage_->width = std::max<uint32_t>(texture.width() >> minLevel, 1);
+  if (texture.height() > 0) storage_->height = std::max<uint32_t>(texture.height() >> minLevel, 1);
+  if (texture.layered()) {
+    storage_->depth = numLayers;
+  } else if (texture.depth() > 0) {
+    storage_->depth = std::max<uint32_t>(texture.depth() >> minLevel, 1);
+  }
+  storage_->levels = numLevels;
+  storage_->immutable = true;
+  view_ = true;
+
+  // the texture object of the view must not be bound before glTextureView.
+  generate();
+  glTextureView(storage_->id, target_, texture.id(), sizedFormat(format_), minLevel, numLevels, minLayer, numLayers);
+  GLOW_STATS_CALL(STATE);
+
+  CheckGlError();
+#else
+  throw GlTextureError("Texture views need OpenGL 4.3.");
+#endif
+}
+
+uint32_t GlTextureView::minLevel() const {
+  return minLevel_;
+}
+
+uint32_t GlTextureView::minLayer() const {
+  return minLayer_;
+}
+
+} /* namespace glow */
@@ -0,0 +1,38 @@
+#ifndef INCLUDE_GLOW_GLTEXTUREVIEW_H_
+#define INCLUDE_GLOW_GLTEXTUREVIEW_H_
+
+#include "GlTexture.h"
+
+namespace glow {
+
+/** \brief View on the storage of another texture (OpenGL 4.3).
+ *
+ *  A texture view reinterprets the data of a texture with immutable storage (see GlTexture::immutable())
+ *  without copying anything, e.g., a texture in R_FLOAT format can be accessed as R_INTEGER texture for
+ *  bit manipulations. The format of the view must be compatible with the format of the viewed texture,
+ *  i.e., have the same size per texel. Furthermore, a view can restrict the range of levels and layers.
+ *
+ *  Changes of the data are visible in the view and the viewed texture. The view can be used like any
+ *  other GlTexture, but cannot be resized. The storage stays valid as long as the view exists.
+ **/
+class GlTextureView : public GlTexture {
+ public:
+  /** \brief create view on levels [minLevel, minLevel + numLevels) and layers [minLayer, minLayer + numLayers).
+   *
+   *  \throws GlTextureError if texture has no immutable storage or views are unavailable.
+   **/
+  GlTextureView(const GlTexture& texture, TextureFormat format, uint32_t minLevel = 0, uint32_t numLevels = 1,
+                uint32_t minLayer = 0, uint32_t numLayers = 1);
+
+  /** \brief first level of the viewed texture. **/
+  uint32_t minLevel() const;
+  /** \brief first layer of the viewed texture. **/
+  uint32_t minLayer() const;
+
+ protected:
+  uint32_t minLevel_, minLayer_;
+};
+
+} /* namespace glow */
+
+#endif /* INCLUDE_GLOW_GLTEXTUREVIEW_H_ */
@@ -7,8 +7,10 @@ GlTransformFeedback::GlTransformFeedback()
     : bound_(std::make_shared<bool>(false)), linked_(std::make_shared<bool>(false)) {
 #if __GL_VERSION >= 400L
   glGenTransformFeedbacks(1, &id_);
+  GLOW_STATS_CREATED(TRANSFORM_FEEDBACK);
   ptr_ = std::shared_ptr<GLuint>(new GLuint(id_), [](GLuint* ptr) {
     glDeleteTransformFeedbacks(1, ptr);
+    GLOW_STATS_DESTROYED(TRANSFORM_FEEDBACK);
     delete ptr;
   });
 #endif
@@ -59,6 +61,7 @@ void GlTransformFeedback::resume() {
 void GlTransformFeedback::draw(GLenum mode) const {
   // OpenGL 4.0+
   glDrawTransformFeedback(mode, id_);
+  GLOW_STATS_CALL(DRAW);
 }
 #endif
 
@@ -0,0 +1,284 @@
+#ifndef INCLUDE_GLOW_GLTYPEDTEXTURE_H_
+#define INCLUDE_GLOW_GLTYPEDTEXTURE_H_
+
+#include <type_traits>
+#include <vector>
+
+#include "GlTexture.h"
+
+namespace glow {
+
+/** \brief upload of a region with the glTexSubImage function for the given number of dimensions. **/
+template <uint32_t Dimensions>
+struct TexSubImage;
+
+template <>
+struct TexSubImage<1> {
+  static void upload(GLenum target, uint32_t x, uint32_t, uint32_t, uint32_t width, uint32_t, uint32_t,
+                     GLenum pixelfmt, GLenum type, const void* data) {
+    glTexSubImage1D(target, 0, x, width, pixelfmt, type, data);
+  }
+};
+
+template <>
+struct TexSubImage<2> {
+  static void upload(GLenum target, uint32_t x, uint32_t y, uint32_t, uint32_t width, uint32_t height, uint32_t,
+                     GLenum pixelfmt, GLenum type, const void* data) {
+    glTexSubImage2D(target, 0, x, y, width, height, pixelfmt, type, data);
+  }
+};
+
+template <>
+struct TexSubImage<3> {
+  static void upload(GLenum target, uint32_t x, uint32_t y, uint32_t z, uint32_t width, uint32_t height,
+                     uint32_t depth, GLenum pixelfmt, GLenum type, const void* data) {
+    glTexSubImage3D(target, 0, x, y, z, width, height, depth, pixelfmt, type, data);
+  }
+};
+
+/** \brief properties of a texture target known at compile time.
+ *
+ *  dimensions is the number of coordinates of a texel, where the layer of an array texture counts as
+ *  coordinate; layered textures keep their number of layers for all mip levels.
+ **/
+template <GLenum Target>
+struct TextureTargetTraits;
+
+template <>
+struct TextureTargetTraits<GL_TEXTURE_1D> : public TexSubImage<1> {
+  static constexpr uint32_t dimensions = 1;
+  static constexpr bool layered = false;
+  static constexpr bool mipmaps = true;
+};
+
+template <>
+struct TextureTargetTraits<GL_TEXTURE_2D> : public TexSubImage<2> {
+  static constexpr uint32_t dimensions = 2;
+  static constexpr bool layered = false;
+  static constexpr bool mipmaps = true;
+};
+
+template <>
+struct TextureTargetTraits<GL_TEXTURE_3D> : public TexSubImage<3> {
+  static constexpr uint32_t dimensions = 3;
+  static constexpr bool layered = false;
+  static constexpr bool mipmaps = true;
+};
+
+template <>
+struct TextureTargetTraits<GL_TEXTURE_2D_ARRAY> : public TexSubImage<3> {
+  static constexpr uint32_t dimensions = 3;
+  static constexpr bool layered = true;
+  static constexpr bool mipmaps = true;
+};
+
+template <>
+struct TextureTargetTraits<GL_TEXTURE_RECTANGLE> : public TexSubImage<2> {
+  static constexpr uint32_t dimensions = 2;
+  static constexpr bool layered = false;
+  static constexpr bool mipmaps = false;
+};
+
+/** \brief texture with a target fixed at compile time.
+ *
+ *  In contrast to GlTexture, which decides at runtime how to upload data or resize the texture, the
+ *  typed texture only offers the functions matching its target, e.g., assignRegion of a GlTexture2D
+ *  takes x, y, width, and height, and only GlTexture3D and GlTexture2DArray have assignLayer. Uploads
+ *  call the glTexSubImage function of the target directly. Thus, mistakes like resizing a 2D texture
+ *  with three dimensions or attaching a 3D texture as a whole to a GlFramebuffer do not compile.
+ *
+ *  Typed textures are GlTextures; thus, they can be used with all functions expecting a GlTexture.
+ *
+ *  \see GlTexture1D, GlTexture2D, GlTexture3D, GlTexture2DArray, GlTextureRectangle
+ **/
+template <GLenum Target>
+class GlTypedTexture : public GlTexture {
+ public:
+  typedef TextureTargetTraits<Target> Traits;
+  static constexpr uint32_t dimensions = Traits::dimensions;
+
+  /** \brief create a one-dimensional empty texture with specified internal format and number of mip levels. **/
+  template <uint32_t D = dimensions, typename std::enable_if<D == 1, int>::type = 0>
+  explicit GlTypedTexture(uint32_t width, TextureFormat format = TextureFormat::RGB, uint32_t levels = 1)
+      : GlTexture(Target, width, 0, 0, format, levels) {}
+
+  /** \brief create a two-dimensional empty texture with specified internal format and number of mip levels. **/
+  template <uint32_t D = dimensions, typename std::enable_if<D == 2, int>::type = 0>
+  GlTypedTexture(uint32_t width, uint32_t height, TextureFormat format = TextureFormat::RGB, uint32_t levels = 1)
+      : GlTexture(Target, width, height, 0, format, levels) {}
+
+  /** \brief create a three-dimensional empty texture or an array of depth layers. **/
+  template <uint32_t D = dimensions, typename std::enable_if<D == 3, int>::type = 0>
+  GlTypedTexture(uint32_t width, uint32_t height, uint32_t depth, TextureFormat format = TextureFormat::RGB,
+                 uint32_t levels = 1)
+      : GlTexture(Target, width, height, depth, format, levels) {}
+
+  /** \brief generate a copy of the texture. **/
+  GlTypedTexture clone() const {
+    return GlTypedTexture(GlTexture::clone());
+  }
+
+  /** \brief Assign data to the texture. **/
+  template <typename T>
+  void assign(PixelFormat pixelfmt, PixelType type, T* data) {
+    upload(0, 0, 0, width(), std::max<uint32_t>(height(), 1), std::max<uint32_t>(depth(), 1), pixelfmt, type, data,
+           nullptr);
+  }
+
+  /** \brief Assign data to the texture, where the pixel type is inferred from T (see PixelTypeOf). **/
+  template <typename T>
+  void assign(PixelFormat pixelfmt, T* data) {
+    assign(pixelfmt, PixelTypeOf<T>::type, data);
+  }
+
+  /** \brief Assign data to the texture, where pixel format and type are inferred from T and the texture format.
+   *
+   *  \throws GlTextureError if data has less values than the texture.
+   **/
+  template <typename T>
+  void assign(const std::vector<T>& data);
+
+  /** \brief Assign data with rows in the given layout, e.g., with padded rows of a cv::Mat. **/
+  template <typename T>
+  void assign(PixelFormat pixelfmt, PixelType type, T* data, const PixelStore& layout) {
+    upload(0, 0, 0, width(), std::max<uint32_t>(height(), 1), std::max<uint32_t>(depth(), 1), pixelfmt, type, data,
+           &layout);
+  }
+
+  /** \brief Assign pixels of the image file (see GlTexture::assign(const GlImageFile&)). **/
+  void assign(const GlImageFile& image) {
+    GlTexture::assign(image);
+  }
+
+  /** \brief Assign data to the region [x, x + width) of a one-dimensional texture.
+   *
+   *  \throws GlTextureError if the region exceeds the texture.
+   **/
+  template <typename T, uint32_t D = dimensions, typename std::enable_if<D == 1, int>::type = 0>
+  void assignRegion(uint32_t x, uint32_t width, PixelFormat pixelfmt, PixelType type, T* data) {
+    upload(x, 0, 0, width, 1, 1, pixelfmt, type, data, nullptr);
+  }
+
+  /** \brief Assign data to the region [x, x + width) x [y, y + height) of a two-dimensional texture. **/
+  template <typename T, uint32_t D = dimensions, typename std::enable_if<D == 2, int>::type = 0>
+  void assignRegion(uint32_t x, uint32_t y, uint32_t width, uint32_t height, PixelFormat pixelfmt, PixelType type,
+                    T* data) {
+    upload(x, y, 0, width, height, 1, pixelfmt, type, data, nullptr);
+  }
+
+  /** \brief Assign data with rows in the given layout to the region of a two-dimensional texture. **/
+  template <typename T, uint32_t D = dimensions, typename std::enable_if<D == 2, int>::type = 0>
+  void assignRegion(uint32_t x, uint32_t y, uint32_t width, uint32_t height, PixelFormat pixelfmt, PixelType type,
+                    T* data, const PixelStore& layout) {
+    upload(x, y, 0, width, height, 1, pixelfmt, type, data, &layout);
+  }
+
+  /** \brief Assign data to the region [x, x + width) x [y, y + height) x [z, z + depth) of the texture. **/
+  template <typename T, uint32_t D = dimensions, typename std::enable_if<D == 3, int>::type = 0>
+  void assignRegion(uint32_t x, uint32_t y, uint32_t z, uint32_t width, uint32_t height, uint32_t depth,
+                    PixelFormat pixelfmt, PixelType type, T* data) {
+    upload(x, y, z, width, height, depth, pixelfmt, type, data, nullptr);
+  }
+
+  /** \brief Assign data with rows in the given layout to the region of a three-dimensional texture. **/
+  template <typename T, uint32_t D = dimensions, typename std::enable_if<D == 3, int>::type = 0>
+  void assignRegion(uint32_t x, uint32_t y, uint32_t z, uint32_t width, uint32_t height, uint32_t depth,
+                    PixelFormat pixelfmt, PixelType type, T* data, const PixelStore& layout) {
+    upload(x, y, z, width, height, depth, pixelfmt, type, data, &layout);
+  }
+
+  /** \brief Assign data to a single layer of a 2D array texture or slice of a 3D texture. **/
+  template <typename T, uint32_t D = dimensions, typename std::enable_if<D == 3, int>::type = 0>
+  void assignLayer(uint32_t layer, PixelFormat pixelfmt, PixelType type, T* data) {
+    upload(0, 0, layer, width(), height(), 1, pixelfmt, type, data, nullptr);
+  }
+
+  /** \brief download a single layer of a 2D array texture or slice of a 3D texture. **/
+  template <uint32_t D = dimensions, typename std::enable_if<D == 3, int>::type = 0>
+  void downloadLayer(uint32_t layer, PixelFormat pixelfmt, PixelType type, void* data) const {
+    readRegion(0, 0, width(), height(), pixelfmt, type, data, 0, layer, nullptr);
+  }
+
+  /** \brief resizing the texture to given width (see GlTexture::resize). **/
+  template <uint32_t D = dimensions, typename std::enable_if<D == 1, int>::type = 0>
+  void resize(uint32_t width, TexResizeMode mode = TexResizeMode::DISCARD) {
+    reallocate(width, 0, 0, mode);
+  }
+
+  /** \brief resizing the texture to given width and height (see GlTexture::resize). **/
+  template <uint32_t D = dimensions, typename std::enable_if<D == 2, int>::type = 0>
+  void resize(uint32_t width, uint32_t height, TexResizeMode mode = TexResizeMode::DISCARD) {
+    reallocate(width, height, 0, mode);
+  }
+
+  /** \brief resizing the texture to given dimensions; array textures get depth layers. **/
+  template <uint32_t D = dimensions, typename std::enable_if<D == 3, int>::type = 0>
+  void resize(uint32_t width, uint32_t height, uint32_t depth, TexResizeMode mode = TexResizeMode::DISCARD) {
+    reallocate(width, height, depth, mode);
+  }
+
+  /** \brief generate Mipmaps (see GlTexture::generateMipmaps); rectangle textures have no mip levels. **/
+  template <bool M = Traits::mipmaps, typename std::enable_if<M, int>::type = 0>
+  void generateMipmaps() {
+    GlTexture::generateMipmaps();
+  }
+
+ protected:
+  /** \brief take over the texture object of a texture with the same target. **/
+  explicit GlTypedTexture(const GlTexture& texture) : GlTexture(texture) {}
+
+  /** \brief upload data to region by the glTexSubImage function of the target; without layout, rows are tight. **/
+  template <typename T>
+  void upload(uint32_t x, uint32_t y, uint32_t z, uint32_t width, uint32_t height, uint32_t depth,
+              PixelFormat pixelfmt, PixelType type, T* data, const PixelStore* layout);
+};
+
+/** \brief one-dimensional texture (GL_TEXTURE_1D). **/
+typedef GlTypedTexture<GL_TEXTURE_1D> GlTexture1D;
+/** \brief two-dimensional texture (GL_TEXTURE_2D). **/
+typedef GlTypedTexture<GL_TEXTURE_2D> GlTexture2D;
+/** \brief three-dimensional texture (GL_TEXTURE_3D). **/
+typedef GlTypedTexture<GL_TEXTURE_3D> GlTexture3D;
+/** \brief array of two-dimensional textures (GL_TEXTURE_2D_ARRAY), where depth is the number of layers. **/
+typedef GlTypedTexture<GL_TEXTURE_2D_ARRAY> GlTexture2DArray;
+
+template <GLenum Target>
+template <typename T>
+void GlTypedTexture<Target>::assign(const std::vector<T>& data) {
+  const TextureFormatInfo& info = info_;
+  uint32_t components = (PixelTypeOf<T>::components > 1) ? PixelTypeOf<T>::components : info.components;
+  if (data.size() * PixelTypeOf<T>::components < numPixels() * components) {
+    throw GlTextureError("Data has less values than the texture.");
+  }
+
+  assign(pixelFormatOf(info, components), PixelTypeOf<T>::type, &data[0]);
+}
+
+template <GLenum Target>
+template <typename T>
+void GlTypedTexture<Target>::upload(uint32_t x, uint32_t y, uint32_t z, uint32_t width, uint32_t height,
+                                    uint32_t depth, PixelFormat pixelfmt, PixelType type, T* data,
+                                    const PixelStore* layout) {
+  if (x + width > storage_->width || y + height > std::max<uint32_t>(storage_->height, 1) ||
+      z + depth > std::max<uint32_t>(storage_->depth, 1)) {
+    throw GlTextureError("Region exceeds the dimensions of the texture.");
+  }
+  if (!pixelTypeMatches<T>(type)) throw GlTextureError("Pixel type does not match the type of the data.");
+  if (width == 0 || height == 0 || depth == 0) return;
+
+  GLuint old_id = bindTransparently();
+  // like GlTexture::subImage, the typed overloads expect rows without padding.
+  PixelStore previous = (layout != nullptr) ? layout->apply(false) : PixelStore::tight().apply(false);
+
+  Traits::upload(Target, x, y, z, width, height, depth, static_cast<GLenum>(pixelfmt), static_cast<GLenum>(type),
+                 data);
+  GLOW_STATS_UPLOADED(static_cast<uint64_t>(width) * height * depth * pixelComponents(pixelfmt) *
+                      pixelTypeSize(type));
+
+  previous.apply(false);
+  releaseTransparently(old_id);
+}
+
+} /* namespace glow */
+
+#endif /* INCLUDE_GLOW_GLTYPEDTEXTURE_H_ */
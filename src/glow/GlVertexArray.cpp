@@ -1,6 +1,8 @@
 #include "GlVertexArray.h"
 #include "glexception.h"
+#include <algorithm>
 #include <cassert>
+#include <vector>
 
 namespace glow {
 
@@ -8,8 +10,10 @@ GLuint GlVertexArray::boundVAO_ = 0;
 
 GlVertexArray::GlVertexArray() {
   glGenVertexArrays(1, &id_);
+  GLOW_STATS_CREATED(VERTEX_ARRAY);
   ptr_ = std::shared_ptr<GLuint>(new GLuint(id_), [](GLuint* ptr) {
     glDeleteVertexArrays(1, ptr);
+    GLOW_STATS_DESTROYED(VERTEX_ARRAY);
     delete ptr;
   });
 }
@@ -21,30 +25,462 @@ void GlVertexArray::bind() {
   assert((boundVAO_ == 0 || boundVAO_ == id_) && "Other vertex array object still active?");
   boundVAO_ = id_;
   glBindVertexArray(id_);
+  GLOW_STATS_CALL(BIND_VERTEX_ARRAY);
 }
 
 void GlVertexArray::release() {
   assert(boundVAO_ == id_ && "Different vertex array object bound in between?");
   boundVAO_ = 0;
   glBindVertexArray(0);
+  GLOW_STATS_CALL(BIND_VERTEX_ARRAY);
 }
 
 void GlVertexArray::enableVertexAttribute(uint32_t idx) {
   GLuint oldvao = bindTransparently();
   glEnableVertexAttribArray(static_cast<GLuint>(idx));
+  GLOW_STATS_CALL(STATE);
   releaseTransparently(oldvao);
 }
 
 void GlVertexArray::disableVertexAttribute(uint32_t idx) {
   GLuint oldvao = bindTransparently();
   glDisableVertexAttribArray(static_cast<GLuint>(idx));
+  GLOW_STATS_CALL(STATE);
   releaseTransparently(oldvao);
 }
 
+void GlVertexArray::setAttributeFormat(uint32_t idx, int32_t size, AttributeType type, bool normalized,
+                                       uint32_t relativeOffset) {
+  // like OpenGL, every attribute initially uses the binding point with its index.
+  if (formats_.find(idx) == formats_.end()) formats_[idx].binding = idx;
+
+  AttributeFormat& format = formats_[idx];
+  format.size = size;
+  format.type = type;
+  format.normalized = normalized;
+  format.relativeOffset = relativeOffset;
+
+  GLuint oldvao = bindTransparently();
+#if __GL_VERSION >= 430L
+  if (type == AttributeType::INT || type == AttributeType::UNSIGNED_INT) {
+    glVertexAttribIFormat(idx, size, static_cast<GLenum>(type), relativeOffset);
+  } else {
+    glVertexAttribFormat(idx, size, static_cast<GLenum>(type), static_cast<GLboolean>(normalized), relativeOffset);
+  }
+  GLOW_STATS_CALL(STATE);
+#else
+  updateAttribute(idx, format);
+#endif
+  glEnableVertexAttribArray(idx);
+  GLOW_STATS_CALL(STATE);
+  releaseTransparently(oldvao);
+
+  CheckGlError();
+}
+
+void GlVertexArray::setAttributeBinding(uint32_t idx, uint32_t binding) {
+  formats_[idx].binding = binding;
+
+  GLuint oldvao = bindTransparently();
+#if __GL_VERSION >= 430L
+  glVertexAttribBinding(idx, binding);
+  GLOW_STATS_CALL(STATE);
+#else
+  updateAttribute(idx, formats_[idx]);
+  glVertexAttribDivisor(idx, bindings_[binding].divisor);
+  GLOW_STATS_CALL(STATE);
+#endif
+  releaseTransparently(oldvao);
+
+  CheckGlError();
+}
+
+void GlVertexArray::bindVertexBuffer(uint32_t binding, const std::shared_ptr<GLuint>& ptr, GLintptr offset,
+                                     uint32_t stride) {
+  if (stride == 0) throw GlVertexArrayError("Stride of a vertex buffer binding must not be 0.");
+
+  VertexBinding& vb = bindings_[binding];
+  if (vb.buffer == ptr && vb.offset == offset && vb.stride == stride) {
+    GLOW_STATS_REDUNDANT_BIND();
+    return;
+  }
+  // keeps the buffer alive, as long as it is used by the vertex array.
+  vb.buffer = ptr;
+  vb.offset = offset;
+  vb.stride = stride;
+
+  GLuint oldvao = bindTransparently();
+#if __GL_VERSION >= 430L
+  glBindVertexBuffer(binding, *ptr, offset, stride);
+  GLOW_STATS_CALL(STATE);
+#else
+  // the buffer is bound once for all attributes of the binding point.
+  GLuint arrayBuffer = *ptr;
+  glBindBuffer(GL_ARRAY_BUFFER, arrayBuffer);
+  GLOW_STATS_CALL(BIND_BUFFER);
+  for (auto& entry : formats_) {
+    if (entry.second.binding == binding) updateAttribute(entry.first, entry.second, arrayBuffer);
+  }
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  GLOW_STATS_CALL(BIND_BUFFER);
+#endif
+  releaseTransparently(oldvao);
+
+  CheckGlError();
+}
+
+void GlVertexArray::setBindingDivisor(uint32_t binding, uint32_t divisor) {
+  bindings_[binding].divisor = divisor;
+
+  GLuint oldvao = bindTransparently();
+#if __GL_VERSION >= 430L
+  glVertexBindingDivisor(binding, divisor);
+  GLOW_STATS_CALL(STATE);
+#else
+  for (auto& entry : formats_) {
+    if (entry.second.binding != binding) continue;
+    glVertexAttribDivisor(entry.first, divisor);
+    GLOW_STATS_CALL(STATE);
+  }
+#endif
+  releaseTransparently(oldvao);
+
+  CheckGlError();
+}
+
+void GlVertexArray::setElementBuffer(const std::shared_ptr<GLuint>& ptr, GLenum type) {
+  indexType_ = type;
+  if (elementBuffer_ == ptr) {
+    GLOW_STATS_REDUNDANT_BIND();
+    return;
+  }
+  elementBuffer_ = ptr;
+
+  // the element buffer binding is state of the bound vertex array object.
+  GLuint oldvao = bindTransparently();
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, *ptr);
+  GLOW_STATS_CALL(BIND_BUFFER);
+  releaseTransparently(oldvao);
+
+  CheckGlError();
+}
+
+void GlVertexArray::setPrimitiveRestart(bool enabled) {
+  primitiveRestart_ = enabled;
+}
+
+const GLvoid* GlVertexArray::prepareElements(uint32_t first) {
+  if (elementBuffer_ == nullptr) throw GlVertexArrayError("Indexed draw needs an element buffer.");
+
+  uint32_t indexSize = (indexType_ == GL_UNSIGNED_BYTE) ? 1 : (indexType_ == GL_UNSIGNED_SHORT) ? 2 : 4;
+  return reinterpret_cast<const GLvoid*>(static_cast<uintptr_t>(first) * indexSize);
+}
+
+GlVertexArray::RestartState GlVertexArray::enableRestart() {
+  RestartState state;
+  if (!primitiveRestart_) return state;
+
+#if __GL_VERSION >= 430L
+  // the restart index is always the maximal value of the index type.
+  if (!glIsEnabled(GL_PRIMITIVE_RESTART_FIXED_INDEX)) {
+    glEnable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
+    GLOW_STATS_CALL(STATE);
+    state.changed = true;
+  }
+#else
+  if (!glIsEnabled(GL_PRIMITIVE_RESTART)) {
+    glEnable(GL_PRIMITIVE_RESTART);
+    GLOW_STATS_CALL(STATE);
+    state.changed = true;
+  }
+  GLint oldindex = 0;
+  glGetIntegerv(GL_PRIMITIVE_RESTART_INDEX, &oldindex);
+  state.index = static_cast<GLuint>(oldindex);
+  GLuint index = (indexType_ == GL_UNSIGNED_BYTE) ? 0xff : (indexType_ == GL_UNSIGNED_SHORT) ? 0xffff : 0xffffffff;
+  if (state.index != index) {
+    glPrimitiveRestartIndex(index);
+    GLOW_STATS_CALL(STATE);
+  }
+#endif
+
+  return state;
+}
+
+void GlVertexArray::restoreRestart(const RestartState& state) {
+  if (!primitiveRestart_) return;
+
+#if __GL_VERSION >= 430L
+  if (state.changed) {
+    glDisable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
+    GLOW_STATS_CALL(STATE);
+  }
+#else
+  if (state.changed) {
+    glDisable(GL_PRIMITIVE_RESTART);
+    GLOW_STATS_CALL(STATE);
+  }
+  GLuint index = (indexType_ == GL_UNSIGNED_BYTE) ? 0xff : (indexType_ == GL_UNSIGNED_SHORT) ? 0xffff : 0xffffffff;
+  if (state.index != index) {
+    glPrimitiveRestartIndex(state.index);
+    GLOW_STATS_CALL(STATE);
+  }
+#endif
+}
+
+void GlVertexArray::drawArrays(PrimitiveType mode, uint32_t first, uint32_t count) {
+  GLuint oldvao = bindTransparently();
+  glDrawArrays(static_cast<GLenum>(mode), first, count);
+  GLOW_STATS_CALL(DRAW);
+  releaseTransparently(oldvao);
+}
+
+void GlVertexArray::drawArraysInstanced(PrimitiveType mode, uint32_t first, uint32_t count, uint32_t instances) {
+  GLuint oldvao = bindTransparently();
+  glDrawArraysInstanced(static_cast<GLenum>(mode), first, count, instances);
+  GLOW_STATS_CALL(DRAW);
+  releaseTransparently(oldvao);
+}
+
+void GlVertexArray::drawElements(PrimitiveType mode, uint32_t count, uint32_t first) {
+  const GLvoid* offset = prepareElements(first);
+  GLuint oldvao = bindTransparently();
+  RestartState restart = enableRestart();
+  glDrawElements(static_cast<GLenum>(mode), count, indexType_, offset);
+  GLOW_STATS_CALL(DRAW);
+  restoreRestart(restart);
+  releaseTransparently(oldvao);
+}
+
+void GlVertexArray::drawElementsBaseVertex(PrimitiveType mode, uint32_t count, uint32_t first, int32_t baseVertex) {
+  const GLvoid* offset = prepareElements(first);
+  GLuint oldvao = bindTransparently();
+  RestartState restart = enableRestart();
+  glDrawElementsBaseVertex(static_cast<GLenum>(mode), count, indexType_, const_cast<GLvoid*>(offset), baseVertex);
+  GLOW_STATS_CALL(DRAW);
+  restoreRestart(restart);
+  releaseTransparently(oldvao);
+}
+
+void GlVertexArray::drawElementsInstanced(PrimitiveType mode, uint32_t count, uint32_t instances, uint32_t first,
+                                          int32_t baseVertex) {
+  const GLvoid* offset = prepareElements(first);
+  GLuint oldvao = bindTransparently();
+  RestartState restart = enableRestart();
+  if (baseVertex == 0) {
+    glDrawElementsInstanced(static_cast<GLenum>(mode), count, indexType_, offset, instances);
+  } else {
+    glDrawElementsInstancedBaseVertex(static_cast<GLenum>(mode), count, indexType_, offset, instances, baseVertex);
+  }
+  GLOW_STATS_CALL(DRAW);
+  restoreRestart(restart);
+  releaseTransparently(oldvao);
+}
+
+void GlVertexArray::multiDrawArraysIndirect(PrimitiveType mode, GlBuffer<DrawArraysIndirectCommand>& commands,
+                                            uint32_t drawCount, uint32_t first) {
+  if (first + drawCount > commands.size()) throw GlVertexArrayError("Draw commands exceed the command buffer.");
+  if (drawCount == 0) return;
+
+  GLuint oldvao = bindTransparently();
+#if __GL_VERSION >= 430L
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commands.id());
+  GLOW_STATS_CALL(BIND_BUFFER);
+  glMultiDrawArraysIndirect(static_cast<GLenum>(mode),
+                            reinterpret_cast<const GLvoid*>(first * sizeof(DrawArraysIndirectCommand)), drawCount, 0);
+  GLOW_STATS_CALL(DRAW);
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+  GLOW_STATS_CALL(BIND_BUFFER);
+#else
+  std::vector<DrawArraysIndirectCommand> cmds(drawCount);
+  readBack(commands, first, drawCount, &cmds[0]);
+
+  // consecutive commands with a single instance are drawn together; the order of the commands is kept.
+  std::vector<GLint> firsts;
+  std::vector<GLsizei> counts;
+  for (uint32_t i = 0; i <= drawCount; ++i) {
+    bool batched = (i < drawCount && cmds[i].instanceCount == 1 && cmds[i].baseInstance == 0);
+    if (batched) {
+      firsts.push_back(cmds[i].first);
+      counts.push_back(cmds[i].count);
+      continue;
+    }
+    if (!counts.empty()) {
+      glMultiDrawArrays(static_cast<GLenum>(mode), &firsts[0], &counts[0], counts.size());
+      GLOW_STATS_CALL(DRAW);
+      firsts.clear();
+      counts.clear();
+    }
+    if (i == drawCount || cmds[i].instanceCount == 0) continue;
+    if (cmds[i].baseInstance != 0) {
+      releaseTransparently(oldvao);
+      throw GlVertexArrayError("Draw command with base instance needs OpenGL 4.2.");
+    }
+    glDrawArraysInstanced(static_cast<GLenum>(mode), cmds[i].first, cmds[i].count, cmds[i].instanceCount);
+    GLOW_STATS_CALL(DRAW);
+  }
+#endif
+  releaseTransparently(oldvao);
+}
+
+void GlVertexArray::multiDrawElementsIndirect(PrimitiveType mode, GlBuffer<DrawElementsIndirectCommand>& commands,
+                                              uint32_t drawCount, uint32_t first) {
+  if (first + drawCount > commands.size()) throw GlVertexArrayError("Draw commands exceed the command buffer.");
+  prepareElements(0);
+  if (drawCount == 0) return;
+
+  GLuint oldvao = bindTransparently();
+  RestartState restart = enableRestart();
+#if __GL_VERSION >= 430L
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commands.id());
+  GLOW_STATS_CALL(BIND_BUFFER);
+  glMultiDrawElementsIndirect(static_cast<GLenum>(mode), indexType_,
+                              reinterpret_cast<const GLvoid*>(first * sizeof(DrawElementsIndirectCommand)), drawCount,
+                              0);
+  GLOW_STATS_CALL(DRAW);
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+  GLOW_STATS_CALL(BIND_BUFFER);
+#else
+  std::vector<DrawElementsIndirectCommand> cmds(drawCount);
+  readBack(commands, first, drawCount, &cmds[0]);
+
+  // consecutive commands with a single instance are drawn together; the order of the commands is kept.
+  std::vector<GLsizei> counts;
+  std::vector<const GLvoid*> offsets;
+  std::vector<GLint> baseVertices;
+  for (uint32_t i = 0; i <= drawCount; ++i) {
+    bool batched = (i < drawCount && cmds[i].instanceCount == 1 && cmds[i].baseInstance == 0);
+    if (batched) {
+      counts.push_back(cmds[i].count);
+      offsets.push_back(prepareElements(cmds[i].firstIndex));
+      baseVertices.push_back(cmds[i].baseVertex);
+      continue;
+    }
+    if (!counts.empty()) {
+      glMultiDrawElementsBaseVertex(static_cast<GLenum>(mode), &counts[0], indexType_, &offsets[0], counts.size(),
+                                    &baseVertices[0]);
+      GLOW_STATS_CALL(DRAW);
+      counts.clear();
+      offsets.clear();
+      baseVertices.clear();
+    }
+    if (i == drawCount || cmds[i].instanceCount == 0) continue;
+    if (cmds[i].baseInstance != 0) {
+      restoreRestart(restart);
+      releaseTransparently(oldvao);
+      throw GlVertexArrayError("Draw command with base instance needs OpenGL 4.2.");
+    }
+    glDrawElementsInstancedBaseVertex(static_cast<GLenum>(mode), cmds[i].count, indexType_,
+                                      prepareElements(cmds[i].firstIndex), cmds[i].instanceCount,
+                                      cmds[i].baseVertex);
+    GLOW_STATS_CALL(DRAW);
+  }
+#endif
+  restoreRestart(restart);
+  releaseTransparently(oldvao);
+}
+
+void GlVertexArray::multiDrawArraysIndirectCount(PrimitiveType mode, GlBuffer<DrawArraysIndirectCommand>& commands,
+                                                 GlBuffer<uint32_t>& drawCount, uint32_t maxDrawCount,
+                                                 uint32_t countIndex) {
+  if (maxDrawCount > commands.size()) throw GlVertexArrayError("Draw commands exceed the command buffer.");
+  if (countIndex >= drawCount.size()) throw GlVertexArrayError("Draw count exceeds the parameter buffer.");
+
+#if __GL_VERSION >= 460L
+  if (maxDrawCount == 0) return;
+
+  GLuint oldvao = bindTransparently();
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commands.id());
+  GLOW_STATS_CALL(BIND_BUFFER);
+  glBindBuffer(GL_PARAMETER_BUFFER, drawCount.id());
+  GLOW_STATS_CALL(BIND_BUFFER);
+  glMultiDrawArraysIndirectCount(static_cast<GLenum>(mode), nullptr, countIndex * sizeof(uint32_t), maxDrawCount, 0);
+  GLOW_STATS_CALL(DRAW);
+  glBindBuffer(GL_PARAMETER_BUFFER, 0);
+  GLOW_STATS_CALL(BIND_BUFFER);
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+  GLOW_STATS_CALL(BIND_BUFFER);
+  releaseTransparently(oldvao);
+#else
+  uint32_t count = 0;
+  readBack(drawCount, countIndex, 1, &count);
+  multiDrawArraysIndirect(mode, commands, std::min(count, maxDrawCount));
+#endif
+}
+
+void GlVertexArray::multiDrawElementsIndirectCount(PrimitiveType mode,
+                                                   GlBuffer<DrawElementsIndirectCommand>& commands,
+                                                   GlBuffer<uint32_t>& drawCount, uint32_t maxDrawCount,
+                                                   uint32_t countIndex) {
+  if (maxDrawCount > commands.size()) throw GlVertexArrayError("Draw commands exceed the command buffer.");
+  if (countIndex >= drawCount.size()) throw GlVertexArrayError("Draw count exceeds the parameter buffer.");
+
+#if __GL_VERSION >= 460L
+  prepareElements(0);
+  if (maxDrawCount == 0) return;
+
+  GLuint oldvao = bindTransparently();
+  RestartState restart = enableRestart();
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commands.id());
+  GLOW_STATS_CALL(BIND_BUFFER);
+  glBindBuffer(GL_PARAMETER_BUFFER, drawCount.id());
+  GLOW_STATS_CALL(BIND_BUFFER);
+  glMultiDrawElementsIndirectCount(static_cast<GLenum>(mode), indexType_, nullptr, countIndex * sizeof(uint32_t),
+                                   maxDrawCount, 0);
+  GLOW_STATS_CALL(DRAW);
+  restoreRestart(restart);
+  glBindBuffer(GL_PARAMETER_BUFFER, 0);
+  GLOW_STATS_CALL(BIND_BUFFER);
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+  GLOW_STATS_CALL(BIND_BUFFER);
+  releaseTransparently(oldvao);
+#else
+  uint32_t count = 0;
+  readBack(drawCount, countIndex, 1, &count);
+  multiDrawElementsIndirect(mode, commands, std::min(count, maxDrawCount));
+#endif
+}
+
+#if __GL_VERSION < 430L
+void GlVertexArray::updateAttribute(uint32_t idx, const AttributeFormat& format) {
+  GLuint arrayBuffer = 0;
+  updateAttribute(idx, format, arrayBuffer);
+  if (arrayBuffer != 0) {
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GLOW_STATS_CALL(BIND_BUFFER);
+  }
+}
+
+void GlVertexArray::updateAttribute(uint32_t idx, const AttributeFormat& format, GLuint& arrayBuffer) {
+  // the vertex array must be bound; without a buffer of the binding point, the pointer is set by bindVertexBuffer.
+  auto it = bindings_.find(format.binding);
+  if (it == bindings_.end() || it->second.buffer == nullptr) return;
+
+  const VertexBinding& vb = it->second;
+  if (arrayBuffer != *vb.buffer) {
+    arrayBuffer = *vb.buffer;
+    glBindBuffer(GL_ARRAY_BUFFER, arrayBuffer);
+    GLOW_STATS_CALL(BIND_BUFFER);
+  }
+
+  GLvoid* offset = reinterpret_cast<GLvoid*>(vb.offset + format.relativeOffset);
+  if (format.type == AttributeType::INT || format.type == AttributeType::UNSIGNED_INT) {
+    glVertexAttribIPointer(idx, format.size, static_cast<GLenum>(format.type), vb.stride, offset);
+  } else {
+    glVertexAttribPointer(idx, format.size, static_cast<GLenum>(format.type),
+                          static_cast<GLboolean>(format.normalized), vb.stride, offset);
+  }
+  GLOW_STATS_CALL(STATE);
+}
+#endif
+
 GLuint GlVertexArray::bindTransparently() {
-  if (boundVAO_ == id_) return id_;
+  if (boundVAO_ == id_) {
+    GLOW_STATS_REDUNDANT_BIND();
+    return id_;
+  }
 
   glBindVertexArray(id_);
+  GLOW_STATS_CALL(BIND_VERTEX_ARRAY);
 
   return boundVAO_;
 }
@@ -53,6 +489,7 @@ void GlVertexArray::releaseTransparently(GLuint old_vao) {
   if (old_vao == id_) return;  // nothing changed.
 
   glBindVertexArray(old_vao);
+  GLOW_STATS_CALL(BIND_VERTEX_ARRAY);
 }
 
 } /* namespace rv */
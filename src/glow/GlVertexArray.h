@@ -5,8 +5,16 @@
 #include "GlBuffer.h"
 #include <memory>
 #include <map>
+#include <tuple>
+#include <type_traits>
 
 namespace glow {
+
+template <typename T>
+struct AttributeTypeOf;
+
+template <typename T>
+struct GlVertexLayout;
 /** \brief data type of the vertex attribute. **/
 enum class AttributeType {
   BYTE = GL_BYTE,
@@ -24,6 +32,61 @@ enum class AttributeType {
   UNSIGNED_INT_10F_11F_11F_REV = GL_UNSIGNED_INT_10F_11F_11F_REV
 };
 
+/** \brief kind of primitives assembled from the vertices of a draw call. **/
+enum class PrimitiveType {
+  POINTS = GL_POINTS,
+  LINES = GL_LINES,
+  LINE_STRIP = GL_LINE_STRIP,
+  LINE_LOOP = GL_LINE_LOOP,
+  TRIANGLES = GL_TRIANGLES,
+  TRIANGLE_STRIP = GL_TRIANGLE_STRIP,
+  TRIANGLE_FAN = GL_TRIANGLE_FAN,
+  LINES_ADJACENCY = GL_LINES_ADJACENCY,
+  TRIANGLES_ADJACENCY = GL_TRIANGLES_ADJACENCY,
+  PATCHES = GL_PATCHES
+};
+
+/** \brief index type of an element buffer with values of type T; only unsigned integers are indices. **/
+template <typename T>
+struct IndexTypeOf;
+
+template <>
+struct IndexTypeOf<uint8_t> {
+  static constexpr GLenum type = GL_UNSIGNED_BYTE;
+};
+
+template <>
+struct IndexTypeOf<uint16_t> {
+  static constexpr GLenum type = GL_UNSIGNED_SHORT;
+};
+
+template <>
+struct IndexTypeOf<uint32_t> {
+  static constexpr GLenum type = GL_UNSIGNED_INT;
+};
+
+/** \brief draw command of GlVertexArray::multiDrawArraysIndirect with the layout expected by OpenGL. **/
+struct DrawArraysIndirectCommand {
+ public:
+  uint32_t count;
+  uint32_t instanceCount;
+  uint32_t first;
+  uint32_t baseInstance;  // needs OpenGL 4.2; must be 0 otherwise.
+};
+
+/** \brief draw command of GlVertexArray::multiDrawElementsIndirect with the layout expected by OpenGL. **/
+struct DrawElementsIndirectCommand {
+ public:
+  uint32_t count;
+  uint32_t instanceCount;
+  uint32_t firstIndex;
+  int32_t baseVertex;
+  uint32_t baseInstance;  // needs OpenGL 4.2; must be 0 otherwise.
+};
+
+static_assert(sizeof(DrawArraysIndirectCommand) == 16, "Unexpected padding of DrawArraysIndirectCommand.");
+static_assert(sizeof(DrawElementsIndirectCommand) == 20, "Unexpected padding of DrawElementsIndirectCommand.");
+
 /** \brief representation of a Vertex Array Object.
  *
  *  In core profile OpenGL, the vertex array object is needed for specification of the vertex
@@ -33,13 +96,52 @@ enum class AttributeType {
  *  It furthermore enables a more "natural" usage of vertex buffer objects with vertex arrays
  *  by making the actual definition of attributes a part of this object.
  *
+ *  Instead of setVertexAttribute, which specifies format and buffer of an attribute together, the
+ *  format of the attributes can be separated from the vertex buffers (glBindVertexBuffer, OpenGL 4.3):
+ *  the format and the binding point of every attribute are set once, and then only the buffer of a
+ *  binding point is exchanged, e.g., for every chunk of a map with the same vertex layout:
  *
- *  \author behley
+ *    vao.setAttributeFormat(0, 3, AttributeType::FLOAT, false, 0);   // position
+ *    vao.setAttributeFormat(1, 3, AttributeType::FLOAT, false, 12);  // normal
+ *    vao.setAttributeBinding(0, 0);
+ *    vao.setAttributeBinding(1, 0);
+ *    for (chunk : chunks) {
+ *      vao.bindVertexBuffer(0, chunk.vertices, 0, 24);
+ *      ...
+ *    }
+ *
+ *  Without OpenGL 4.3, the vertex array emulates the separation by specifying the attribute pointers of
+ *  all attributes of a binding point, when its buffer changes.
  *
- *  TODO: Compatibility with glBindVertexBuffer / glVertexBindingDivisor​? Available with OpenGL version 4.3
+ *  For vertex structs described by GLOW_VERTEX_LAYOUT (see GlVertexLayout.h), all attributes are configured
+ *  by a single call, either from a buffer of interleaved vertices (AoS) or from one buffer per member (SoA):
+ *
+ *    vao.setLayout(surfels);                                           // GlBuffer<Surfel>
+ *    vao.setSplitLayout<Surfel>(positions, normals, radii, timestamps);  // GlBuffer<vec3>, ..., GlBuffer<uint32_t>
+ *
+ *  The element buffer with the indices of indexed draws is also state of the vertex array. The draw
+ *  functions bind the vertex array and draw with the currently bound program, where the index type is
+ *  inferred from the element buffer, e.g., GL_UNSIGNED_SHORT for a GlBuffer<uint16_t>:
+ *
+ *    vao.setElementBuffer(indices);
+ *    vao.setPrimitiveRestart(true);  // the maximal index 0xffff starts a new strip.
+ *    program.bind();
+ *    vao.drawElements(PrimitiveType::TRIANGLE_STRIP, indices.size());
+ *
+ *  Many draws with the same vertex array and program, e.g., one for every chunk of a map, should be
+ *  submitted by a single multiDraw*Indirect call with a buffer of draw commands. The commands can also
+ *  be written by a shader; then, the writes must be made visible by glMemoryBarrier(GL_COMMAND_BARRIER_BIT).
+ *  Without OpenGL 4.3, the commands are read back and drawn by glMultiDrawArrays or
+ *  glMultiDrawElementsBaseVertex; then, command buffers must not use BufferTarget::DRAW_INDIRECT_BUFFER,
+ *  which needs OpenGL 4.0, but, e.g., BufferTarget::COPY_READ_BUFFER.
+ *
+ *  \author behley
  **/
 class GlVertexArray : public GlObject {
  public:
+  friend class GlStateGuard;
+  friend class GlBlitter;
+
   GlVertexArray();
   ~GlVertexArray();
 
@@ -69,6 +171,111 @@ class GlVertexArray : public GlObject {
   void setVertexAttribute(uint32_t idx, GlBuffer<T>& buffer, int32_t size, AttributeType type, bool normalized,
                           uint32_t stride, GLvoid* offset);
 
+  /** \brief set the format of the vertex attribute independent of a buffer and enable the attribute.
+   *
+   *  \param idx index of the vertex attribute
+   *  \param size size or number of components of the attribute (1,2,3, or 4)
+   *  \param type data type of the attribute inside the vertex buffer; INT and UNSIGNED_INT stay integers.
+   *  \param normalized should the data be normalized?
+   *  \param relativeOffset byte offset of the attribute relative to the start of a vertex.
+   **/
+  void setAttributeFormat(uint32_t idx, int32_t size, AttributeType type, bool normalized, uint32_t relativeOffset);
+
+  /** \brief set the binding point (see bindVertexBuffer), from which the attribute gets its values. **/
+  void setAttributeBinding(uint32_t idx, uint32_t binding);
+
+  /** \brief use the buffer for all attributes of the binding point.
+   *
+   *  Binding the same buffer with the same offset and stride again is skipped.
+   *
+   *  \param offset byte offset of the first vertex in the buffer.
+   *  \param stride bytes between consecutive vertices; must not be 0.
+   *  \throws GlVertexArrayError if the stride is 0.
+   **/
+  template <typename T>
+  void bindVertexBuffer(uint32_t binding, GlBuffer<T>& buffer, GLintptr offset, uint32_t stride);
+
+  /** \brief advance the attributes of the binding point only every divisor instances; 0 for every vertex. **/
+  void setBindingDivisor(uint32_t binding, uint32_t divisor);
+
+  /** \brief use interleaved vertices of type T for the attributes given by GLOW_VERTEX_LAYOUT.
+   *
+   *  The members become the attributes firstIndex, firstIndex + 1, ... in the order of GLOW_VERTEX_LAYOUT,
+   *  which all get their values from the binding point firstIndex.
+   **/
+  template <typename T>
+  void setLayout(GlBuffer<T>& buffer, uint32_t firstIndex = 0);
+
+  /** \brief use one buffer per member of vertex type T for the attributes given by GLOW_VERTEX_LAYOUT.
+   *
+   *  Buffer i holds the tightly packed values of member i, which becomes attribute firstIndex + i with
+   *  binding point firstIndex + i. The number of buffers and the size, type, and components of their
+   *  values must match the members, e.g., GlBuffer<vec2> for a float[2] member.
+   **/
+  template <typename T, typename... Ts>
+  void setSplitLayout(uint32_t firstIndex, GlBuffer<Ts>&... buffers);
+  /** \brief use one buffer per member with attributes starting at index 0; see setSplitLayout above. **/
+  template <typename T, typename... Ts>
+  void setSplitLayout(GlBuffer<Ts>&... buffers);
+
+  /** \brief use buffer of uint8_t, uint16_t, or uint32_t values as indices for indexed draws. **/
+  template <typename T>
+  void setElementBuffer(GlBuffer<T>& buffer);
+
+  /** \brief restart primitives at the maximal value of the index type in indexed draws, e.g., for strips.
+   *
+   *  Primitive restart is global state of OpenGL: the indexed draws of the vertex array enable it only for
+   *  the draw and restore the previous state afterwards. Without restart, the state of OpenGL is not changed.
+   **/
+  void setPrimitiveRestart(bool enabled);
+
+  /** \brief draw count vertices starting with vertex first. **/
+  void drawArrays(PrimitiveType mode, uint32_t first, uint32_t count);
+  /** \brief draw instances of count vertices, where gl_InstanceID is the index of the instance. **/
+  void drawArraysInstanced(PrimitiveType mode, uint32_t first, uint32_t count, uint32_t instances);
+
+  /** \brief draw count indices of the element buffer starting with index first.
+   *
+   *  \throws GlVertexArrayError if no element buffer is set.
+   **/
+  void drawElements(PrimitiveType mode, uint32_t count, uint32_t first = 0);
+  /** \brief draw indices, where baseVertex is added to every index, e.g., for meshes in a shared buffer. **/
+  void drawElementsBaseVertex(PrimitiveType mode, uint32_t count, uint32_t first, int32_t baseVertex);
+  /** \brief draw instances of the indexed primitives. **/
+  void drawElementsInstanced(PrimitiveType mode, uint32_t count, uint32_t instances, uint32_t first = 0,
+                             int32_t baseVertex = 0);
+
+  /** \brief draw the drawCount commands of the buffer starting with command first by a single call. **/
+  void multiDrawArraysIndirect(PrimitiveType mode, GlBuffer<DrawArraysIndirectCommand>& commands,
+                               uint32_t drawCount, uint32_t first = 0);
+  /** \brief draw indexed commands of the buffer (see multiDrawArraysIndirect) with the element buffer. **/
+  void multiDrawElementsIndirect(PrimitiveType mode, GlBuffer<DrawElementsIndirectCommand>& commands,
+                                 uint32_t drawCount, uint32_t first = 0);
+
+  /** \brief draw commands, where the number of commands is value countIndex of the drawCount buffer.
+   *
+   *  The number of commands is read by the GPU from the parameter buffer (OpenGL 4.6), e.g., after a culling
+   *  shader wrote the commands of the visible chunks; at most maxDrawCount commands are drawn. Without
+   *  OpenGL 4.6, the number is read back first.
+   **/
+  void multiDrawArraysIndirectCount(PrimitiveType mode, GlBuffer<DrawArraysIndirectCommand>& commands,
+                                    GlBuffer<uint32_t>& drawCount, uint32_t maxDrawCount, uint32_t countIndex = 0);
+  /** \brief draw indexed commands, where the number of commands is given by the drawCount buffer. **/
+  void multiDrawElementsIndirectCount(PrimitiveType mode, GlBuffer<DrawElementsIndirectCommand>& commands,
+                                      GlBuffer<uint32_t>& drawCount, uint32_t maxDrawCount, uint32_t countIndex = 0);
+
+  /** \brief set indices (see setElementBuffer) and draw count of them like drawElements(mode, count, first). **/
+  template <typename T>
+  void drawElements(PrimitiveType mode, GlBuffer<T>& indices, uint32_t count, uint32_t first = 0);
+  /** \brief set indices and draw them like drawElementsBaseVertex(mode, count, first, baseVertex). **/
+  template <typename T>
+  void drawElementsBaseVertex(PrimitiveType mode, GlBuffer<T>& indices, uint32_t count, uint32_t first,
+                              int32_t baseVertex);
+  /** \brief set indices and draw instances like drawElementsInstanced(mode, count, instances, first, baseVertex). **/
+  template <typename T>
+  void drawElementsInstanced(PrimitiveType mode, GlBuffer<T>& indices, uint32_t count, uint32_t instances,
+                             uint32_t first = 0, int32_t baseVertex = 0);
+
   /** \brief enable vertex attribute with given index \a idx **/
   void enableVertexAttribute(uint32_t idx);
   /** \brief disable vertex attribute with given index \a idx **/
@@ -90,8 +297,74 @@ class GlVertexArray : public GlObject {
     bool enabled{false};
   };
 
+  /** \brief set the element buffer with given index type, where the buffer is kept alive by ptr. **/
+  void setElementBuffer(const std::shared_ptr<GLuint>& ptr, GLenum type);
+
+  /** \brief byte offset of index first in the element buffer. **/
+  const GLvoid* prepareElements(uint32_t first);
+
+  /** \brief primitive restart state of OpenGL before an indexed draw. **/
+  struct RestartState {
+   public:
+    bool changed{false};
+    GLuint index{0};  // restart index without OpenGL 4.3.
+  };
+
+  /** \brief enable primitive restart for an indexed draw if needed and return the state to restore. **/
+  RestartState enableRestart();
+  /** \brief restore the primitive restart state before calling enableRestart. **/
+  void restoreRestart(const RestartState& state);
+
+  /** \brief set attributes of the remaining members starting with member I of vertex type T. **/
+  template <typename T, uint32_t I>
+  void setSplitAttributes(uint32_t firstIndex);
+  template <typename T, uint32_t I, typename U, typename... Ts>
+  void setSplitAttributes(uint32_t firstIndex, GlBuffer<U>& buffer, GlBuffer<Ts>&... buffers);
+
+  /** \brief read value index of the buffer without a specific buffer target. **/
+  template <typename T>
+  static void readBack(const GlBuffer<T>& buffer, uint32_t index, uint32_t count, T* data);
+
+  /** \brief set the buffer of the binding point, where the buffer is kept alive by ptr. **/
+  void bindVertexBuffer(uint32_t binding, const std::shared_ptr<GLuint>& ptr, GLintptr offset, uint32_t stride);
+
+  struct AttributeFormat {
+   public:
+    int32_t size{4};
+    AttributeType type{AttributeType::FLOAT};
+    bool normalized{false};
+    uint32_t relativeOffset{0};
+    uint32_t binding{0};
+  };
+
+  struct VertexBinding {
+   public:
+    std::shared_ptr<GLuint> buffer;
+    GLintptr offset{0};
+    uint32_t stride{0};
+    uint32_t divisor{0};
+  };
+
+#if __GL_VERSION < 430L
+  /** \brief specify the attribute pointer of the attribute from its format and binding.
+   *
+   *  arrayBuffer is the buffer bound to GL_ARRAY_BUFFER, which is updated if the buffer of the binding
+   *  must be bound. Like GlBuffer::release, the callers release the array buffer afterwards.
+   **/
+  void updateAttribute(uint32_t idx, const AttributeFormat& format, GLuint& arrayBuffer);
+  /** \brief specify the attribute pointer of a single attribute and release the array buffer afterwards. **/
+  void updateAttribute(uint32_t idx, const AttributeFormat& format);
+#endif
+
   // only needed for book keeping purposes.
   std::map<uint32_t, std::shared_ptr<GLuint> > vertexBuffers_;
+
+  std::map<uint32_t, AttributeFormat> formats_;
+  std::map<uint32_t, VertexBinding> bindings_;
+
+  std::shared_ptr<GLuint> elementBuffer_;
+  GLenum indexType_{GL_UNSIGNED_INT};
+  bool primitiveRestart_{false};
 };
 
 template <typename T>
@@ -113,8 +386,10 @@ void GlVertexArray::setVertexAttribute(uint32_t idx, GlBuffer<T>& buffer, int32_
     glVertexAttribPointer(static_cast<GLuint>(idx), static_cast<GLint>(numComponents), static_cast<GLenum>(type),
                           static_cast<GLboolean>(normalized), static_cast<GLuint>(stride_in_bytes), offset);
   }
+  GLOW_STATS_CALL(STATE);
 
   glEnableVertexAttribArray(static_cast<GLuint>(idx));
+  GLOW_STATS_CALL(STATE);
 
   releaseTransparently(oldvao);
 
@@ -122,6 +397,90 @@ void GlVertexArray::setVertexAttribute(uint32_t idx, GlBuffer<T>& buffer, int32_
   CheckGlError();
 }
 
+template <typename T>
+void GlVertexArray::bindVertexBuffer(uint32_t binding, GlBuffer<T>& buffer, GLintptr offset, uint32_t stride) {
+  bindVertexBuffer(binding, buffer.ptr_, offset, stride);
+}
+
+template <typename T>
+void GlVertexArray::setLayout(GlBuffer<T>& buffer, uint32_t firstIndex) {
+  uint32_t idx = firstIndex;
+  for (const auto& attribute : GlVertexLayout<T>::attributes()) {
+    setAttributeFormat(idx, attribute.size, attribute.type, false, attribute.offset);
+    setAttributeBinding(idx, firstIndex);
+    ++idx;
+  }
+  bindVertexBuffer(firstIndex, buffer, 0, sizeof(T));
+}
+
+template <typename T, typename... Ts>
+void GlVertexArray::setSplitLayout(uint32_t firstIndex, GlBuffer<Ts>&... buffers) {
+  static_assert(sizeof...(Ts) == std::tuple_size<typename GlVertexLayout<T>::Members>::value,
+                "Split layout needs a buffer for every member of the vertex.");
+  setSplitAttributes<T, 0>(firstIndex, buffers...);
+}
+
+template <typename T, typename... Ts>
+void GlVertexArray::setSplitLayout(GlBuffer<Ts>&... buffers) {
+  setSplitLayout<T>(0, buffers...);
+}
+
+template <typename T, uint32_t I>
+void GlVertexArray::setSplitAttributes(uint32_t firstIndex) {}
+
+template <typename T, uint32_t I, typename U, typename... Ts>
+void GlVertexArray::setSplitAttributes(uint32_t firstIndex, GlBuffer<U>& buffer, GlBuffer<Ts>&... buffers) {
+  typedef typename std::tuple_element<I, typename GlVertexLayout<T>::Members>::type Member;
+  static_assert(sizeof(U) == sizeof(Member) && AttributeTypeOf<U>::type == AttributeTypeOf<Member>::type &&
+                    AttributeTypeOf<U>::components == AttributeTypeOf<Member>::components,
+                "Values of the buffer must match the member of the vertex.");
+
+  uint32_t idx = firstIndex + I;
+  setAttributeFormat(idx, AttributeTypeOf<U>::components, AttributeTypeOf<U>::type, false, 0);
+  setAttributeBinding(idx, idx);
+  bindVertexBuffer(idx, buffer, 0, sizeof(U));
+
+  setSplitAttributes<T, I + 1>(firstIndex, buffers...);
+}
+
+template <typename T>
+void GlVertexArray::readBack(const GlBuffer<T>& buffer, uint32_t index, uint32_t count, T* data) {
+  if (count == 0) return;
+
+  // GL_COPY_READ_BUFFER exists in all supported versions and is not used elsewhere.
+  glBindBuffer(GL_COPY_READ_BUFFER, buffer.id());
+  GLOW_STATS_CALL(BIND_BUFFER);
+  glGetBufferSubData(GL_COPY_READ_BUFFER, index * sizeof(T), count * sizeof(T), data);
+  GLOW_STATS_DOWNLOADED(count * sizeof(T));
+  glBindBuffer(GL_COPY_READ_BUFFER, 0);
+  GLOW_STATS_CALL(BIND_BUFFER);
+}
+
+template <typename T>
+void GlVertexArray::setElementBuffer(GlBuffer<T>& buffer) {
+  setElementBuffer(buffer.ptr_, IndexTypeOf<T>::type);
+}
+
+template <typename T>
+void GlVertexArray::drawElements(PrimitiveType mode, GlBuffer<T>& indices, uint32_t count, uint32_t first) {
+  setElementBuffer(indices);
+  drawElements(mode, count, first);
+}
+
+template <typename T>
+void GlVertexArray::drawElementsBaseVertex(PrimitiveType mode, GlBuffer<T>& indices, uint32_t count, uint32_t first,
+                                           int32_t baseVertex) {
+  setElementBuffer(indices);
+  drawElementsBaseVertex(mode, count, first, baseVertex);
+}
+
+template <typename T>
+void GlVertexArray::drawElementsInstanced(PrimitiveType mode, GlBuffer<T>& indices, uint32_t count,
+                                          uint32_t instances, uint32_t first, int32_t baseVertex) {
+  setElementBuffer(indices);
+  drawElementsInstanced(mode, count, instances, first, baseVertex);
+}
+
 } /* namespace rv */
 
 #endif /* INCLUDE_RV_GLVERTEXARRAY_H_ */
@@ -0,0 +1,148 @@
+#ifndef INCLUDE_GLOW_GLVERTEXLAYOUT_H_
+#define INCLUDE_GLOW_GLVERTEXLAYOUT_H_
+
+#include <stdint.h>
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+
+#include "GlVertexArray.h"
+#include "glutil.h"
+
+namespace glow {
+
+template <AttributeType A, int32_t C>
+struct AttributeTypeOfBase {
+ public:
+  static constexpr AttributeType type = A;
+  static constexpr int32_t components = C;
+};
+
+template <AttributeType A, int32_t C>
+constexpr AttributeType AttributeTypeOfBase<A, C>::type;
+template <AttributeType A, int32_t C>
+constexpr int32_t AttributeTypeOfBase<A, C>::components;
+
+/** \brief attribute type and components of a member of a vertex struct with type T.
+ *
+ *  Member types without specialization do not compile. INT and UNSIGNED_INT attributes stay integers in
+ *  the shader (see GlVertexArray::setAttributeFormat); all other types are converted to floats. Arrays of
+ *  up to 4 values are single attributes, e.g., float[2] is a vec2 in the shader.
+ **/
+template <typename T>
+struct AttributeTypeOf;
+
+template <typename T>
+struct AttributeTypeOf<const T> : AttributeTypeOf<T> {};
+
+template <typename T, std::size_t N>
+struct AttributeTypeOf<T[N]> : AttributeTypeOfBase<AttributeTypeOf<T>::type, N * AttributeTypeOf<T>::components> {
+  static_assert(N * AttributeTypeOf<T>::components <= 4, "Vertex attributes have at most 4 components.");
+};
+
+// clang-format off
+template <> struct AttributeTypeOf<uint8_t> : AttributeTypeOfBase<AttributeType::UNSIGNED_BYTE, 1> {};
+template <> struct AttributeTypeOf<int8_t> : AttributeTypeOfBase<AttributeType::BYTE, 1> {};
+template <> struct AttributeTypeOf<uint16_t> : AttributeTypeOfBase<AttributeType::UNSIGNED_SHORT, 1> {};
+template <> struct AttributeTypeOf<int16_t> : AttributeTypeOfBase<AttributeType::SHORT, 1> {};
+template <> struct AttributeTypeOf<uint32_t> : AttributeTypeOfBase<AttributeType::UNSIGNED_INT, 1> {};
+template <> struct AttributeTypeOf<int32_t> : AttributeTypeOfBase<AttributeType::INT, 1> {};
+template <> struct AttributeTypeOf<float> : AttributeTypeOfBase<AttributeType::FLOAT, 1> {};
+template <> struct AttributeTypeOf<vec2> : AttributeTypeOfBase<AttributeType::FLOAT, 2> {};
+template <> struct AttributeTypeOf<vec3> : AttributeTypeOfBase<AttributeType::FLOAT, 3> {};
+template <> struct AttributeTypeOf<vec4> : AttributeTypeOfBase<AttributeType::FLOAT, 4> {};
+template <> struct AttributeTypeOf<Eigen::Vector2f> : AttributeTypeOfBase<AttributeType::FLOAT, 2> {};
+template <> struct AttributeTypeOf<Eigen::Vector3f> : AttributeTypeOfBase<AttributeType::FLOAT, 3> {};
+template <> struct AttributeTypeOf<Eigen::Vector4f> : AttributeTypeOfBase<AttributeType::FLOAT, 4> {};
+// clang-format on
+
+/** \brief format of a vertex attribute given by a member of a vertex struct. **/
+struct VertexAttribute {
+ public:
+  const char* name;    // name of the member.
+  int32_t size;        // number of components.
+  AttributeType type;  // type of the components.
+  uint32_t offset;     // byte offset of the member inside the struct.
+  uint32_t bytes;      // size of the member, i.e., the stride of a buffer with only this member.
+};
+
+/** \brief compile-time description of the attributes of vertex type T.
+ *
+ *  Only defined for types described by GLOW_VERTEX_LAYOUT, which provides:
+ *  - Vertex: the vertex type T.
+ *  - Members: std::tuple of the member types in the given order.
+ *  - attributes(): std::array of the VertexAttribute of every member in the given order.
+ **/
+template <typename T>
+struct GlVertexLayout;
+
+} /* namespace glow */
+
+// clang-format off
+#define GLOW_VERTEX_LAYOUT_CONCAT_(A, B) A##B
+#define GLOW_VERTEX_LAYOUT_CONCAT(A, B) GLOW_VERTEX_LAYOUT_CONCAT_(A, B)
+#define GLOW_VERTEX_LAYOUT_NARGS_(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, N, ...) N
+#define GLOW_VERTEX_LAYOUT_NARGS(...) \
+  GLOW_VERTEX_LAYOUT_NARGS_(__VA_ARGS__, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+
+// apply M to every member and separate the results by commas.
+#define GLOW_VERTEX_LAYOUT_EACH_1(M, A) M(A)
+#define GLOW_VERTEX_LAYOUT_EACH_2(M, A, ...) M(A), GLOW_VERTEX_LAYOUT_EACH_1(M, __VA_ARGS__)
+#define GLOW_VERTEX_LAYOUT_EACH_3(M, A, ...) M(A), GLOW_VERTEX_LAYOUT_EACH_2(M, __VA_ARGS__)
+#define GLOW_VERTEX_LAYOUT_EACH_4(M, A, ...) M(A), GLOW_VERTEX_LAYOUT_EACH_3(M, __VA_ARGS__)
+#define GLOW_VERTEX_LAYOUT_EACH_5(M, A, ...) M(A), GLOW_VERTEX_LAYOUT_EACH_4(M, __VA_ARGS__)
+#define GLOW_VERTEX_LAYOUT_EACH_6(M, A, ...) M(A), GLOW_VERTEX_LAYOUT_EACH_5(M, __VA_ARGS__)
+#define GLOW_VERTEX_LAYOUT_EACH_7(M, A, ...) M(A), GLOW_VERTEX_LAYOUT_EACH_6(M, __VA_ARGS__)
+#define GLOW_VERTEX_LAYOUT_EACH_8(M, A, ...) M(A), GLOW_VERTEX_LAYOUT_EACH_7(M, __VA_ARGS__)
+#define GLOW_VERTEX_LAYOUT_EACH_9(M, A, ...) M(A), GLOW_VERTEX_LAYOUT_EACH_8(M, __VA_ARGS__)
+#define GLOW_VERTEX_LAYOUT_EACH_10(M, A, ...) M(A), GLOW_VERTEX_LAYOUT_EACH_9(M, __VA_ARGS__)
+#define GLOW_VERTEX_LAYOUT_EACH_11(M, A, ...) M(A), GLOW_VERTEX_LAYOUT_EACH_10(M, __VA_ARGS__)
+#define GLOW_VERTEX_LAYOUT_EACH_12(M, A, ...) M(A), GLOW_VERTEX_LAYOUT_EACH_11(M, __VA_ARGS__)
+#define GLOW_VERTEX_LAYOUT_EACH_13(M, A, ...) M(A), GLOW_VERTEX_LAYOUT_EACH_12(M, __VA_ARGS__)
+#define GLOW_VERTEX_LAYOUT_EACH_14(M, A, ...) M(A), GLOW_VERTEX_LAYOUT_EACH_13(M, __VA_ARGS__)
+#define GLOW_VERTEX_LAYOUT_EACH_15(M, A, ...) M(A), GLOW_VERTEX_LAYOUT_EACH_14(M, __VA_ARGS__)
+#define GLOW_VERTEX_LAYOUT_EACH_16(M, A, ...) M(A), GLOW_VERTEX_LAYOUT_EACH_15(M, __VA_ARGS__)
+#define GLOW_VERTEX_LAYOUT_EACH(M, ...) \
+  GLOW_VERTEX_LAYOUT_CONCAT(GLOW_VERTEX_LAYOUT_EACH_, GLOW_VERTEX_LAYOUT_NARGS(__VA_ARGS__))(M, __VA_ARGS__)
+
+#define GLOW_VERTEX_LAYOUT_TYPE(MEMBER) decltype(Vertex::MEMBER)
+#define GLOW_VERTEX_LAYOUT_ATTRIBUTE(MEMBER)                                                            \
+  glow::VertexAttribute{#MEMBER, glow::AttributeTypeOf<decltype(Vertex::MEMBER)>::components,           \
+                        glow::AttributeTypeOf<decltype(Vertex::MEMBER)>::type,                          \
+                        static_cast<uint32_t>(offsetof(Vertex, MEMBER)),                                \
+                        static_cast<uint32_t>(sizeof(Vertex::MEMBER))}
+// clang-format on
+
+/** \brief describe the vertex struct TYPE by its members (at most 16), which become attributes in this order.
+ *
+ *  Must be used in the global namespace, e.g., after the definition of the struct:
+ *
+ *    struct Surfel {
+ *      vec3 position;
+ *      vec3 normal;
+ *      float radius;
+ *      uint32_t timestamp;
+ *    };
+ *    GLOW_VERTEX_LAYOUT(Surfel, position, normal, radius, timestamp);
+ *
+ *  Offsets, sizes, number of components, and attribute types of the members are determined at compile time;
+ *  members without AttributeTypeOf specialization do not compile. See GlVertexArray::setLayout.
+ **/
+#define GLOW_VERTEX_LAYOUT(TYPE, ...)                                                                      \
+  namespace glow {                                                                                         \
+  template <>                                                                                              \
+  struct GlVertexLayout<TYPE> {                                                                            \
+   public:                                                                                                 \
+    typedef TYPE Vertex;                                                                                   \
+    typedef std::tuple<GLOW_VERTEX_LAYOUT_EACH(GLOW_VERTEX_LAYOUT_TYPE, __VA_ARGS__)> Members;              \
+    static_assert(std::is_standard_layout<Vertex>::value, "Vertex type needs a standard layout for offsets."); \
+                                                                                                           \
+    static std::array<VertexAttribute, std::tuple_size<Members>::value> attributes() {                     \
+      return {{GLOW_VERTEX_LAYOUT_EACH(GLOW_VERTEX_LAYOUT_ATTRIBUTE, __VA_ARGS__)}};                        \
+    }                                                                                                      \
+  };                                                                                                       \
+  }                                                                                                        \
+  static_assert(true, "")
+
+#endif /* INCLUDE_GLOW_GLVERTEXLAYOUT_H_ */
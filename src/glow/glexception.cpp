@@ -28,4 +28,7 @@ GlQueryError::GlQueryError(const std::string& msg) : std::runtime_error(msg) {
 
 GlTextureRectangleError::GlTextureRectangleError(const std::string& msg) : std::runtime_error(msg) {
 }
+
+GlStateError::GlStateError(const std::string& msg) : std::runtime_error(msg) {
+}
 }
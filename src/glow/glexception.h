@@ -56,6 +56,11 @@ class GlTextureRectangleError : public std::runtime_error {
  public:
   GlTextureRectangleError(const std::string& msg);
 };
+
+class GlStateError : public std::runtime_error {
+ public:
+  GlStateError(const std::string& msg);
+};
 }
 // ...
 
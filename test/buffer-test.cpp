@@ -1,12 +1,29 @@
 #include <gtest/gtest.h>
 
 #include <glow/GlBuffer.h>
+#include <glow/GlState.h>
+#include <glow/GlVertexArray.h>
+#include <glow/GlVertexLayout.h>
 #include <eigen3/Eigen/Dense>
 #include <random>
 #include "test_utils.h"
 
 using namespace glow;
 
+struct LayoutVertex {
+  vec3 position;
+  uint8_t color[4];
+  float radius;
+  uint32_t timestamp;
+};
+GLOW_VERTEX_LAYOUT(LayoutVertex, position, color, radius, timestamp);
+
+struct SplitVertex {
+  float uv[2];
+  int32_t label;
+};
+GLOW_VERTEX_LAYOUT(SplitVertex, uv, label);
+
 namespace {
 
 TEST(BufferTest, initTest) {
@@ -188,4 +205,170 @@ TEST(BufferTest, eigenTest) {
     }
   }
 }
+
+TEST(BufferTest, vertexBindingTest) {
+  GlBuffer<float> chunk1(BufferTarget::ARRAY_BUFFER, BufferUsage::STATIC_DRAW);
+  GlBuffer<float> chunk2(BufferTarget::ARRAY_BUFFER, BufferUsage::STATIC_DRAW);
+  chunk1.assign(std::vector<float>(24, 1.0f));
+  chunk2.assign(std::vector<float>(24, 2.0f));
+
+  // position and normal interleaved in binding 0, an instance attribute in binding 1.
+  GlVertexArray vao;
+  vao.setAttributeFormat(0, 3, AttributeType::FLOAT, false, 0);
+  vao.setAttributeFormat(1, 3, AttributeType::FLOAT, false, 12);
+  vao.setAttributeFormat(2, 1, AttributeType::INT, false, 0);
+  vao.setAttributeBinding(0, 0);
+  vao.setAttributeBinding(1, 0);
+  vao.setAttributeBinding(2, 1);
+  vao.setBindingDivisor(1, 1);
+  ASSERT_NO_THROW(CheckGlError());
+
+  GLint buffer = 0, divisor = 0, integer = 0;
+  vao.bindVertexBuffer(0, chunk1, 0, 24);
+  vao.bindVertexBuffer(1, chunk2, 0, 4);
+  vao.bindVertexBuffer(0, chunk2, 24, 24);
+  ASSERT_THROW(vao.bindVertexBuffer(0, chunk1, 0, 0), GlVertexArrayError);
+
+  vao.bind();
+  glGetVertexAttribiv(1, GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING, &buffer);
+  ASSERT_EQ(static_cast<GLint>(chunk2.id()), buffer);
+  glGetVertexAttribiv(0, GL_VERTEX_ATTRIB_ARRAY_DIVISOR, &divisor);
+  ASSERT_EQ(0, divisor);
+  glGetVertexAttribiv(2, GL_VERTEX_ATTRIB_ARRAY_DIVISOR, &divisor);
+  ASSERT_EQ(1, divisor);
+  glGetVertexAttribiv(2, GL_VERTEX_ATTRIB_ARRAY_INTEGER, &integer);
+  ASSERT_EQ(GL_TRUE, integer);
+  vao.release();
+  ASSERT_NO_THROW(CheckGlError());
+}
+
+TEST(BufferTest, vertexLayoutTest) {
+  auto attributes = GlVertexLayout<LayoutVertex>::attributes();
+  ASSERT_EQ(4u, attributes.size());
+  ASSERT_EQ(std::string("color"), attributes[1].name);
+  ASSERT_EQ(4, attributes[1].size);
+  ASSERT_EQ(AttributeType::UNSIGNED_BYTE, attributes[1].type);
+  ASSERT_EQ(12u, attributes[1].offset);
+  ASSERT_EQ(16u, attributes[2].offset);
+  ASSERT_EQ(AttributeType::UNSIGNED_INT, attributes[3].type);
+  ASSERT_EQ(4u, attributes[3].bytes);
+
+  GlBuffer<LayoutVertex> vertices(BufferTarget::ARRAY_BUFFER, BufferUsage::STATIC_DRAW);
+  vertices.assign(std::vector<LayoutVertex>(3));
+
+  // interleaved: all attributes from binding point 2.
+  GlVertexArray aos;
+  aos.setLayout(vertices, 2);
+  ASSERT_NO_THROW(CheckGlError());
+
+  GLint value = 0;
+  aos.bind();
+  glGetVertexAttribiv(3, GL_VERTEX_ATTRIB_ARRAY_SIZE, &value);
+  ASSERT_EQ(4, value);
+  glGetVertexAttribiv(3, GL_VERTEX_ATTRIB_ARRAY_TYPE, &value);
+  ASSERT_EQ(GL_UNSIGNED_BYTE, value);
+  glGetVertexAttribiv(5, GL_VERTEX_ATTRIB_ARRAY_INTEGER, &value);
+  ASSERT_EQ(GL_TRUE, value);
+  glGetVertexAttribiv(5, GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING, &value);
+  ASSERT_EQ(static_cast<GLint>(vertices.id()), value);
+  aos.release();
+
+  // split: one buffer per member, where vec2 values match the float[2] member.
+  GlBuffer<vec2> uvs(BufferTarget::ARRAY_BUFFER, BufferUsage::STATIC_DRAW);
+  GlBuffer<int32_t> labels(BufferTarget::ARRAY_BUFFER, BufferUsage::STATIC_DRAW);
+  uvs.assign(std::vector<vec2>(3));
+  labels.assign(std::vector<int32_t>(3));
+
+  GlVertexArray soa;
+  soa.setSplitLayout<SplitVertex>(uvs, labels);
+  ASSERT_NO_THROW(CheckGlError());
+
+  soa.bind();
+  glGetVertexAttribiv(0, GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING, &value);
+  ASSERT_EQ(static_cast<GLint>(uvs.id()), value);
+  glGetVertexAttribiv(0, GL_VERTEX_ATTRIB_ARRAY_SIZE, &value);
+  ASSERT_EQ(2, value);
+  glGetVertexAttribiv(1, GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING, &value);
+  ASSERT_EQ(static_cast<GLint>(labels.id()), value);
+  glGetVertexAttribiv(1, GL_VERTEX_ATTRIB_ARRAY_INTEGER, &value);
+  ASSERT_EQ(GL_TRUE, value);
+  soa.release();
+  ASSERT_NO_THROW(CheckGlError());
+}
+
+TEST(BufferTest, elementBufferTest) {
+  GlBuffer<uint16_t> indices(BufferTarget::ELEMENT_ARRAY_BUFFER, BufferUsage::STATIC_DRAW);
+  indices.assign(std::vector<uint16_t>{0, 1, 2, 0xffff, 2, 1, 3});
+
+  GlVertexArray vao;
+  ASSERT_THROW(vao.drawElements(PrimitiveType::TRIANGLE_STRIP, 7), GlVertexArrayError);
+
+  // the element buffer is state of the vertex array object.
+  vao.setElementBuffer(indices);
+  GLint buffer = 0;
+  vao.bind();
+  glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &buffer);
+  vao.release();
+  ASSERT_EQ(static_cast<GLint>(indices.id()), buffer);
+
+  // primitive restart is global state and only enabled during the draws of the vertex array.
+  GlState before = GlState::queryAll();
+  vao.setPrimitiveRestart(true);
+  vao.drawElements(PrimitiveType::TRIANGLE_STRIP, indices, 7);
+  vao.drawElementsBaseVertex(PrimitiveType::TRIANGLE_STRIP, 7, 0, 1);
+  vao.drawElementsInstanced(PrimitiveType::TRIANGLE_STRIP, 7, 2);
+  ASSERT_NO_THROW(CheckGlError());
+  GlState after = GlState::queryAll();
+  if (after != before) before.difference(after);
+  ASSERT_TRUE(after == before);
+#if __GL_VERSION >= 430L
+  ASSERT_FALSE(glIsEnabled(GL_PRIMITIVE_RESTART_FIXED_INDEX));
+#else
+  ASSERT_FALSE(glIsEnabled(GL_PRIMITIVE_RESTART));
+#endif
+
+  vao.setPrimitiveRestart(false);
+  vao.drawElementsInstanced(PrimitiveType::TRIANGLES, 3, 2, 4, 1);
+  ASSERT_NO_THROW(CheckGlError());
+}
+
+TEST(BufferTest, indirectDrawTest) {
+#if __GL_VERSION >= 430L
+  BufferTarget target = BufferTarget::DRAW_INDIRECT_BUFFER;
+#else
+  BufferTarget target = BufferTarget::COPY_READ_BUFFER;
+#endif
+  GlBuffer<DrawArraysIndirectCommand> arrays(target, BufferUsage::DYNAMIC_DRAW);
+  arrays.assign(std::vector<DrawArraysIndirectCommand>{{3, 1, 0, 0}, {3, 1, 3, 0}, {3, 0, 6, 0}, {3, 2, 0, 0}});
+
+  GlVertexArray vao;
+  vao.multiDrawArraysIndirect(PrimitiveType::TRIANGLES, arrays, 4);
+  vao.multiDrawArraysIndirect(PrimitiveType::TRIANGLES, arrays, 2, 1);
+  ASSERT_THROW(vao.multiDrawArraysIndirect(PrimitiveType::TRIANGLES, arrays, 4, 1), GlVertexArrayError);
+
+  // the number of commands is taken from the parameter buffer, but limited by maxDrawCount.
+  GlBuffer<uint32_t> count(BufferTarget::ARRAY_BUFFER, BufferUsage::DYNAMIC_DRAW);
+  count.assign(std::vector<uint32_t>{2, 8});
+  vao.multiDrawArraysIndirectCount(PrimitiveType::TRIANGLES, arrays, count, 4);
+  vao.multiDrawArraysIndirectCount(PrimitiveType::TRIANGLES, arrays, count, 4, 1);
+  ASSERT_THROW(vao.multiDrawArraysIndirectCount(PrimitiveType::TRIANGLES, arrays, count, 4, 2), GlVertexArrayError);
+
+  GlBuffer<DrawElementsIndirectCommand> elements(target, BufferUsage::DYNAMIC_DRAW);
+  elements.assign(std::vector<DrawElementsIndirectCommand>{{3, 1, 0, 0, 0}, {3, 1, 3, 1, 0}, {3, 2, 0, 2, 0}});
+  ASSERT_THROW(vao.multiDrawElementsIndirect(PrimitiveType::TRIANGLES, elements, 3), GlVertexArrayError);
+
+  GlBuffer<uint32_t> indices(BufferTarget::ELEMENT_ARRAY_BUFFER, BufferUsage::STATIC_DRAW);
+  indices.assign(std::vector<uint32_t>{0, 1, 2, 1, 2, 3});
+  vao.setElementBuffer(indices);
+  vao.multiDrawElementsIndirect(PrimitiveType::TRIANGLES, elements, 3);
+  vao.multiDrawElementsIndirectCount(PrimitiveType::TRIANGLES, elements, count, 3);
+
+#if __GL_VERSION >= 430L
+  // the indirect buffer binding is not changed by the draws.
+  GLint buffer = -1;
+  glGetIntegerv(GL_DRAW_INDIRECT_BUFFER_BINDING, &buffer);
+  ASSERT_EQ(0, buffer);
+#endif
+  ASSERT_NO_THROW(CheckGlError());
+}
 }
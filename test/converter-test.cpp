@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include <glow/GlFormatConverter.h>
+
+#include <vector>
+
+using namespace glow;
+
+namespace {
+
+TEST(ConverterTest, normalizeTest) {
+  // 8-bit BGR image with rows of 5 pixels padded to 16 bytes.
+  uint32_t width = 5, height = 3;
+  std::vector<uint8_t> image(16 * height, 0);
+  for (uint32_t y = 0; y < height; ++y) {
+    for (uint32_t x = 0; x < width; ++x) {
+      image[y * 16 + 3 * x + 0] = 10 * x;  // blue
+      image[y * 16 + 3 * x + 1] = 20 * y;  // green
+      image[y * 16 + 3 * x + 2] = 255;     // red
+    }
+  }
+
+  GlTexture texture(width, height, TextureFormat::RGB_FLOAT);
+  GlFormatConverter converter;
+  converter.convert(texture, PixelFormat::BGR, PixelType::UNSIGNED_BYTE, &image[0],
+                    PixelStore::fromStride(16, PixelFormat::BGR, PixelType::UNSIGNED_BYTE));
+  ASSERT_NO_THROW(CheckGlError());
+
+  std::vector<float> values(3 * width * height);
+  texture.download(PixelFormat::RGB, &values[0]);
+  for (uint32_t i = 0; i < width * height; ++i) {
+    ASSERT_FLOAT_EQ(1.0f, values[3 * i + 0]);
+    ASSERT_FLOAT_EQ(20.0f * (i / width) / 255.0f, values[3 * i + 1]);
+    ASSERT_FLOAT_EQ(10.0f * (i % width) / 255.0f, values[3 * i + 2]);
+  }
+
+  // scratch texture is reused for the next frame.
+  std::fill(image.begin(), image.end(), 0);
+  converter.convert(texture, PixelFormat::BGR, PixelType::UNSIGNED_BYTE, &image[0],
+                    PixelStore::fromStride(16, PixelFormat::BGR, PixelType::UNSIGNED_BYTE));
+  texture.download(PixelFormat::RGB, &values[0]);
+  for (uint32_t i = 0; i < values.size(); ++i) ASSERT_FLOAT_EQ(0.0f, values[i]);
+}
+
+TEST(ConverterTest, depthTest) {
+  // 16-bit depth in millimeters to meters.
+  uint32_t width = 4, height = 2;
+  std::vector<uint16_t> depth(width * height);
+  for (uint32_t i = 0; i < depth.size(); ++i) depth[i] = 1000 * i + 250;
+
+  GlTexture texture(width, height, TextureFormat::RGBA_FLOAT);
+  GlFormatConverter converter;
+  converter.setSwizzle(TexSwizzle::R, TexSwizzle::R, TexSwizzle::ZERO, TexSwizzle::ONE);
+  converter.setScale(vec4(0.001f, 0.002f, 1.0f, 1.0f));
+  converter.setBias(vec4(0.0f, 0.0f, 0.5f, 0.0f));
+  converter.convert(texture, PixelFormat::R_INTEGER, PixelType::UNSIGNED_SHORT, &depth[0]);
+  ASSERT_NO_THROW(CheckGlError());
+
+  std::vector<float> values(4 * width * height);
+  texture.download(PixelFormat::RGBA, &values[0]);
+  for (uint32_t i = 0; i < depth.size(); ++i) {
+    ASSERT_FLOAT_EQ(0.001f * depth[i], values[4 * i + 0]);
+    ASSERT_FLOAT_EQ(0.002f * depth[i], values[4 * i + 1]);
+    ASSERT_FLOAT_EQ(0.5f, values[4 * i + 2]);
+    ASSERT_FLOAT_EQ(1.0f, values[4 * i + 3]);
+  }
+
+  ASSERT_THROW(converter.convert(texture, PixelFormat::R_INTEGER, PixelType::FLOAT, &depth[0]), GlTextureError);
+  GlTexture volume(2, 2, 2, TextureFormat::R_FLOAT);
+  ASSERT_THROW(converter.convert(volume, PixelFormat::R_INTEGER, PixelType::UNSIGNED_SHORT, &depth[0]),
+               GlTextureError);
+}
+
+TEST(ConverterTest, integerTest) {
+  // float texture to integer texture with rounding.
+  uint32_t width = 3, height = 3;
+  std::vector<float> img(width * height);
+  for (uint32_t i = 0; i < img.size(); ++i) img[i] = 0.1f * i;
+
+  GlTexture src(width, height, TextureFormat::R_FLOAT);
+  src.assign(PixelFormat::R, PixelType::FLOAT, &img[0]);
+  GlTexture dst(width, height, TextureFormat::R_INTEGER);
+
+  GlFormatConverter converter;
+  converter.setScale(vec4(10.0f, 1.0f, 1.0f, 1.0f));
+  converter.convert(src, dst);
+  ASSERT_NO_THROW(CheckGlError());
+
+  std::vector<int32_t> values(width * height);
+  dst.download(PixelFormat::R_INTEGER, &values[0]);
+  for (uint32_t i = 0; i < values.size(); ++i) ASSERT_EQ(int32_t(i), values[i]);
+}
+
+}
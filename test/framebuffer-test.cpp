@@ -1,4 +1,6 @@
+#include <glow/GlCapabilities.h>
 #include <glow/GlFramebuffer.h>
+#include <glow/GlFramebufferCache.h>
 #include <glow/GlRenderbuffer.h>
 #include <glow/GlState.h>
 #include <glow/GlTexture.h>
@@ -56,4 +58,226 @@ TEST(FramebufferTest, testStatelessness) {
   if (priorState != GlState::queryAll()) priorState.difference(GlState::queryAll());
   ASSERT_EQ(true, (priorState == GlState::queryAll()));
 }
+
+TEST(FramebufferTest, resizeTest) {
+  GlFramebuffer buf(640, 480);
+  GlTexture texture(640, 480, TextureFormat::RGBA);
+  GlRenderbuffer rbo(640, 480, RenderbufferFormat::DEPTH_STENCIL);
+  buf.attach(FramebufferAttachment::COLOR0, texture);
+  buf.attach(FramebufferAttachment::DEPTH_STENCIL, rbo);
+  ASSERT_TRUE(buf.valid());
+
+  GlState priorState = GlState::queryAll();
+
+  buf.resize(320, 240);
+  ASSERT_NO_THROW(CheckGlError());
+
+  if (priorState != GlState::queryAll()) priorState.difference(GlState::queryAll());
+  ASSERT_EQ(true, (priorState == GlState::queryAll()));
+
+  ASSERT_TRUE(buf.valid());
+  ASSERT_EQ(320u, buf.width());
+  ASSERT_EQ(240u, buf.height());
+  // the framebuffer resizes its own copies of the attachments.
+  ASSERT_EQ(320u, buf.texture(FramebufferAttachment::COLOR0).width());
+  ASSERT_EQ(240u, buf.texture(FramebufferAttachment::COLOR0).height());
+  ASSERT_EQ(320u, buf.renderbuffer(FramebufferAttachment::DEPTH_STENCIL).width());
+  ASSERT_EQ(240u, buf.renderbuffer(FramebufferAttachment::DEPTH_STENCIL).height());
+  // the copies share the size with the objects of the caller.
+  ASSERT_EQ(320u, texture.width());
+  ASSERT_EQ(240u, texture.height());
+  ASSERT_EQ(texture.id(), buf.texture(FramebufferAttachment::COLOR0).id());
+  ASSERT_EQ(320u, rbo.width());
+  ASSERT_EQ(240u, rbo.height());
+  ASSERT_THROW(buf.texture(FramebufferAttachment::DEPTH_STENCIL), GlFramebufferError);
+  ASSERT_THROW(buf.renderbuffer(FramebufferAttachment::COLOR1), GlFramebufferError);
+
+  // attached objects may be destroyed before the framebuffer is resized.
+  GlFramebuffer temporary(8, 8);
+  {
+    GlTexture color(8, 8, TextureFormat::RGBA8);
+    GlRenderbuffer depth(8, 8, RenderbufferFormat::DEPTH_STENCIL);
+    temporary.attach(FramebufferAttachment::COLOR0, color);
+    temporary.attach(FramebufferAttachment::DEPTH_STENCIL, depth);
+  }
+  temporary.resize(4, 4, TexResizeMode::PRESERVE);
+  ASSERT_NO_THROW(CheckGlError());
+  ASSERT_TRUE(temporary.valid());
+  ASSERT_EQ(4u, temporary.texture(FramebufferAttachment::COLOR0).width());
+}
+
+TEST(FramebufferTest, resizeDownloadTest) {
+  GlFramebuffer buf(4, 4);
+  GlTexture texture(4, 4, TextureFormat::R_FLOAT);
+  std::vector<float> values(4 * 4, 1.0f);
+  texture.assign(PixelFormat::R, PixelType::FLOAT, &values[0]);
+  buf.attach(FramebufferAttachment::COLOR0, texture);
+
+  // the original object must download the enlarged texture object; the old size would overflow values.
+  buf.resize(8, 6, TexResizeMode::PRESERVE);
+  texture.download(values);
+  ASSERT_NO_THROW(CheckGlError());
+  ASSERT_EQ(8u * 6u, values.size());
+  for (uint32_t y = 0; y < 4; ++y) {
+    for (uint32_t x = 0; x < 4; ++x) ASSERT_EQ(1.0f, values[y * 8 + x]);
+  }
+
+  // a resize of the original object is seen by the framebuffer, which attaches a new texture object again.
+  texture.resize(16, 12);
+  ASSERT_EQ(16u, buf.texture(FramebufferAttachment::COLOR0).width());
+  buf.bind();
+  buf.release();
+  ASSERT_NO_THROW(CheckGlError());
+  ASSERT_TRUE(buf.valid());
+}
+
+TEST(FramebufferTest, layeredTest) {
+  GlFramebuffer buf(8, 4);
+  GlTexture texture = GlTexture::array2D(8, 4, 3, TextureFormat::RGBA_FLOAT);
+  GlTexture depth = GlTexture::array2D(8, 4, 3, TextureFormat::DEPTH24);
+  buf.attachLayered(FramebufferAttachment::COLOR0, texture);
+  buf.attachLayered(FramebufferAttachment::DEPTH, depth);
+  ASSERT_NO_THROW(CheckGlError());
+  ASSERT_TRUE(buf.valid());
+
+  // clear affects all layers of a layered framebuffer.
+  buf.bind();
+  glClearColor(0.5f, 0.25f, 1.0f, 1.0f);
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+  buf.release();
+
+  std::vector<vec4> values(8 * 4);
+  for (uint32_t l = 0; l < 3; ++l) {
+    texture.downloadLayer(l, PixelFormat::RGBA, PixelType::FLOAT, &values[0]);
+    for (uint32_t i = 0; i < values.size(); ++i) {
+      ASSERT_EQ(0.5f, values[i].x);
+      ASSERT_EQ(0.25f, values[i].y);
+    }
+  }
+
+  // a single layer behaves like a two-dimensional texture.
+  GlFramebuffer single(8, 4);
+  single.attachLayer(FramebufferAttachment::COLOR0, texture, 1);
+  ASSERT_TRUE(single.valid());
+  ASSERT_THROW(single.attachLayer(FramebufferAttachment::COLOR0, texture, 3), GlFramebufferError);
+
+  buf.resize(4, 2);
+  ASSERT_NO_THROW(CheckGlError());
+  ASSERT_TRUE(buf.valid());
+  ASSERT_EQ(4u, buf.texture(FramebufferAttachment::COLOR0).width());
+  ASSERT_EQ(3u, buf.texture(FramebufferAttachment::COLOR0).depth());
+}
+
+TEST(FramebufferTest, multisampleTest) {
+  GlFramebuffer msaa(8, 4);
+  GlTexture color = GlTexture::multisample2D(8, 4, 4, TextureFormat::RGBA_FLOAT);
+  GlRenderbuffer depth(8, 4, RenderbufferFormat::DEPTH24, 4);
+  msaa.attach(FramebufferAttachment::COLOR0, color);
+  msaa.attach(FramebufferAttachment::DEPTH, depth);
+  ASSERT_NO_THROW(CheckGlError());
+  ASSERT_TRUE(msaa.valid());
+  ASSERT_EQ(4u, color.samples());
+  ASSERT_EQ(4u, depth.samples());
+
+  msaa.bind();
+  glClearColor(0.5f, 0.25f, 1.0f, 1.0f);
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+  msaa.release();
+
+  GlFramebuffer resolved(8, 4);
+  GlTexture texture(8, 4, TextureFormat::RGBA_FLOAT);
+  resolved.attach(FramebufferAttachment::COLOR0, texture);
+
+  GlState priorState = GlState::queryAll();
+  msaa.resolveTo(resolved);
+  ASSERT_NO_THROW(CheckGlError());
+  if (priorState != GlState::queryAll()) priorState.difference(GlState::queryAll());
+  ASSERT_EQ(true, (priorState == GlState::queryAll()));
+
+  std::vector<vec4> values;
+  texture.download(values);
+  for (uint32_t i = 0; i < values.size(); ++i) {
+    ASSERT_EQ(0.5f, values[i].x);
+    ASSERT_EQ(0.25f, values[i].y);
+  }
+
+  std::vector<vec4> unresolved;
+  ASSERT_THROW(color.download(unresolved), GlTextureError);
+  ASSERT_THROW(msaa.resolveTo(resolved, GL_DEPTH_BUFFER_BIT, TexMagOp::LINEAR), GlFramebufferError);
+
+  int32_t maxSamples = GlCapabilities::getInstance().get<int32_t>(GL_MAX_SAMPLES);
+  ASSERT_THROW(GlRenderbuffer(8, 4, RenderbufferFormat::RGBA8, maxSamples + 1), GlFramebufferError);
+  ASSERT_THROW(GlTexture::multisample2D(8, 4, maxSamples + 1), GlTextureError);
+}
+
+TEST(FramebufferTest, cacheTest) {
+  GlFramebufferCache cache(2);
+  GlTexture normals(8, 4, TextureFormat::RGBA_FLOAT);
+  GlTexture labels(8, 4, TextureFormat::R_INTEGER);
+  GlRenderbuffer depth(8, 4, RenderbufferFormat::DEPTH24);
+
+  GlFramebuffer& fbo = cache.get(8, 4, {{FramebufferAttachment::COLOR0, normals},
+                                        {FramebufferAttachment::COLOR1, labels},
+                                        {FramebufferAttachment::DEPTH, depth}});
+  ASSERT_NO_THROW(CheckGlError());
+  ASSERT_TRUE(fbo.valid());
+  ASSERT_EQ(1u, cache.size());
+
+  GlState priorState = GlState::queryAll();
+
+  // every draw buffer is cleared with values of its type.
+  int32_t label[] = {7, 0, 0, 0};
+  fbo.clearColor(0, vec4(0.5f, 0.25f, 1.0f, 1.0f));
+  fbo.clearColor(1, label);
+  fbo.clearDepth(0.5f);
+  fbo.invalidate({FramebufferAttachment::DEPTH});
+  ASSERT_NO_THROW(CheckGlError());
+
+  if (priorState != GlState::queryAll()) priorState.difference(GlState::queryAll());
+  ASSERT_EQ(true, (priorState == GlState::queryAll()));
+
+  std::vector<vec4> values;
+  normals.download(values);
+  for (uint32_t i = 0; i < values.size(); ++i) ASSERT_EQ(0.25f, values[i].y);
+  std::vector<int32_t> ids;
+  labels.download(ids);
+  for (uint32_t i = 0; i < ids.size(); ++i) ASSERT_EQ(7, ids[i]);
+
+  // same attachments give the same framebuffer.
+  GlFramebuffer& same = cache.get(8, 4, {{FramebufferAttachment::COLOR0, normals},
+                                         {FramebufferAttachment::COLOR1, labels},
+                                         {FramebufferAttachment::DEPTH, depth}});
+  ASSERT_EQ(fbo.id(), same.id());
+
+  // depth only.
+  GlFramebuffer& shadow = cache.get(8, 4, {{FramebufferAttachment::DEPTH, depth}});
+  ASSERT_TRUE(shadow.valid());
+  ASSERT_NE(fbo.id(), shadow.id());
+  ASSERT_EQ(2u, cache.size());
+
+  // least recently used framebuffer is removed.
+  GLuint id = shadow.id();
+  cache.get(8, 4, {{FramebufferAttachment::COLOR0, labels}});
+  ASSERT_EQ(2u, cache.size());
+  ASSERT_EQ(id, cache.get(8, 4, {{FramebufferAttachment::DEPTH, depth}}).id());
+
+  // cached framebuffers have a fixed size.
+  ASSERT_THROW(shadow.resize(4, 2), GlFramebufferError);
+
+  // framebuffers of textures, which only the cache references, are removed by the next new get.
+  {
+    GlTexture temporary(8, 4, TextureFormat::RGBA8);
+    cache.get(8, 4, {{FramebufferAttachment::COLOR0, temporary}});
+  }
+  ASSERT_EQ(2u, cache.size());
+  cache.get(4, 2, {{FramebufferAttachment::DEPTH, depth}});
+  ASSERT_EQ(2u, cache.size());
+  ASSERT_EQ(id, cache.get(8, 4, {{FramebufferAttachment::DEPTH, depth}}).id());
+
+  cache.clear();
+  ASSERT_EQ(0u, cache.size());
+  ASSERT_NO_THROW(CheckGlError());
+}
 }
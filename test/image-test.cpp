@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+
+#include <glow/GlImageFile.h>
+#include <glow/GlImageLoader.h>
+#include <glow/GlSnapshotWriter.h>
+#include <glow/GlStats.h>
+#include <glow/GlTexture.h>
+#include <glow/GlTextureRectangle.h>
+
+#include <stdint.h>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+using namespace glow;
+
+namespace {
+
+std::string tempFile(const std::string& name, const std::string& header, const void* data, size_t size) {
+  std::string filename = (boost::filesystem::temp_directory_path() / ("glow-image-test-" + name)).string();
+  std::ofstream out(filename.c_str(), std::ios::binary);
+  out << header;
+  out.write(reinterpret_cast<const char*>(data), size);
+
+  return filename;
+}
+
+TEST(ImageTest, pgmTest) {
+  // rows of the file from the top to the bottom.
+  std::vector<uint8_t> pixels{1, 2, 3, 4, 5, 6};
+  std::string filename = tempFile("8bit.pgm", "P5\n# comment\n3 2\n255\n", &pixels[0], pixels.size());
+
+  GlTexture texture = GlTexture::loadTexture(filename);
+  ASSERT_NO_THROW(CheckGlError());
+  ASSERT_EQ(3u, texture.width());
+  ASSERT_EQ(2u, texture.height());
+
+  // first row of the texture is the bottom row of the file.
+  std::vector<uint8_t> values;
+  texture.download(values);
+  ASSERT_EQ(std::vector<uint8_t>({4, 5, 6, 1, 2, 3}), values);
+
+  GlTextureRectangle rect = GlTextureRectangle::loadTexture(filename);
+  values.clear();
+  rect.download(values);
+  ASSERT_NO_THROW(CheckGlError());
+  ASSERT_EQ(std::vector<uint8_t>({4, 5, 6, 1, 2, 3}), values);
+
+  // further images of the same format and size reuse the scratch texture of the flip.
+  GlImageFile image(filename);
+  GlStats::endFrame();
+  texture.assign(image);
+  texture.assign(image);
+  GlStatsSnapshot stats = GlStats::endFrame();
+  ASSERT_NO_THROW(CheckGlError());
+  ASSERT_EQ(0u, stats.created[static_cast<uint32_t>(GlStatsObject::TEXTURE)]);
+  values.clear();
+  texture.download(values);
+  ASSERT_EQ(std::vector<uint8_t>({4, 5, 6, 1, 2, 3}), values);
+
+  boost::filesystem::remove(filename);
+}
+
+TEST(ImageTest, ppm16Test) {
+  // big-endian values 0x0102 and 0xff00 in every row.
+  std::vector<uint8_t> pixels{1, 2, 255, 0, 1, 2, 255, 0, 1, 2, 255, 0};
+  std::string filename = tempFile("16bit.ppm", "P6 2 1 65535\n", &pixels[0], pixels.size());
+
+  GlImageFile image(filename);
+  ASSERT_EQ(TextureFormat::RGB16, image.textureFormat());
+  ASSERT_EQ(PixelType::UNSIGNED_SHORT, image.pixelType());
+
+  GlTexture texture = GlTexture::loadTexture(image);
+  std::vector<uint16_t> values;
+  texture.download(values);
+  ASSERT_NO_THROW(CheckGlError());
+  ASSERT_EQ(std::vector<uint16_t>({0x0102, 0xff00, 0x0102, 0xff00, 0x0102, 0xff00}), values);
+
+  boost::filesystem::remove(filename);
+}
+
+TEST(ImageTest, pfmTest) {
+  std::vector<float> pixels{0.5f, 1.5f, -2.0f, 4.0f};
+  bool little = (*reinterpret_cast<const uint8_t*>(&pixels[0]) == 0);  // 0.5f = 0x3f000000.
+  std::string filename = tempFile("gray.pfm", little ? "Pf\n2 2\n-1.0\n" : "Pf\n2 2\n1.0\n", &pixels[0], 16);
+
+  GlTexture texture = GlTexture::loadTexture(filename);
+  std::vector<float> values;
+  texture.download(values);
+  ASSERT_NO_THROW(CheckGlError());
+  // rows of PFM files are already stored from the bottom to the top.
+  ASSERT_EQ(pixels, values);
+
+  boost::filesystem::remove(filename);
+}
+
+TEST(ImageTest, rawTest) {
+  std::vector<uint16_t> pixels{1, 2, 3, 4, 5, 6, 7, 8};
+  std::string filename = tempFile("image.raw", "GLOWRAW 2 2 2 u16\n", &pixels[0], 16);
+
+  GlTexture texture = GlTexture::loadTexture(filename);
+  std::vector<uint16_t> values;
+  texture.download(values);
+  ASSERT_NO_THROW(CheckGlError());
+  ASSERT_EQ(pixels, values);
+
+  std::string truncated = tempFile("truncated.raw", "GLOWRAW 4 4 2 u16\n", &pixels[0], 16);
+  ASSERT_THROW(GlImageFile image(truncated), GlTextureError);
+  ASSERT_THROW(GlImageFile image("nonexistent.pgm"), GlTextureError);
+
+  boost::filesystem::remove(filename);
+  boost::filesystem::remove(truncated);
+}
+
+TEST(ImageTest, loaderTest) {
+  std::vector<std::string> filenames;
+  for (uint8_t i = 0; i < 4; ++i) {
+    std::vector<uint8_t> pixels(4, i);
+    filenames.push_back(tempFile("frame" + std::to_string(i) + ".pgm", "P5 2 2 255\n", &pixels[0], pixels.size()));
+  }
+
+  GlImageLoader loader;
+  std::vector<GlTexture> textures = loader.load(filenames);
+  ASSERT_EQ(4u, textures.size());
+  for (uint8_t i = 0; i < 4; ++i) {
+    std::vector<uint8_t> values;
+    textures[i].download(values);
+    ASSERT_EQ(std::vector<uint8_t>(4, i), values);
+  }
+
+  // files are fetched in the order of submission; failures are reported at the fetch.
+  loader.submit(filenames[2]);
+  loader.submit("nonexistent.pgm");
+  GlTexture texture(2, 2, TextureFormat::R8);
+  texture.assign(*loader.fetch(true));
+  ASSERT_THROW(loader.fetch(true), GlTextureError);
+  ASSERT_EQ(0u, loader.pending());
+  ASSERT_TRUE(loader.fetch(true) == nullptr);
+  ASSERT_NO_THROW(CheckGlError());
+
+  for (const std::string& filename : filenames) boost::filesystem::remove(filename);
+}
+
+TEST(ImageTest, snapshotTest) {
+  GlTexture texture(3, 2, TextureFormat::RGB8);
+  std::vector<uint8_t> pixels{10, 20, 30, 10, 20, 30, 10, 20, 30, 40, 50, 60, 70, 80, 90, 100, 110, 120};
+  texture.assign(PixelFormat::RGB, PixelType::UNSIGNED_BYTE, &pixels[0]);
+
+  std::string prefix = (boost::filesystem::temp_directory_path() / "glow-image-test-snapshot").string();
+  std::vector<std::string> extensions{".ppm", ".pfm", ".tga", ".raw"};
+
+  GlSnapshotWriter writer(2, 4);
+  for (const std::string& ext : extensions) ASSERT_TRUE(writer.write(texture, prefix + ext));
+  ASSERT_EQ(0u, writer.dropped());
+  ASSERT_THROW(writer.write(texture, prefix + ".png"), GlTextureError);
+
+  writer.finish();
+  ASSERT_EQ(0u, writer.pending());
+  ASSERT_EQ(0u, writer.failed());
+  ASSERT_NO_THROW(CheckGlError());
+
+  // files are written in the row order expected by loadTexture.
+  std::vector<uint8_t> values;
+  GlTexture::loadTexture(prefix + ".ppm").download(values);
+  ASSERT_EQ(pixels, values);
+  values.clear();
+  GlTexture::loadTexture(prefix + ".raw").download(values);
+  ASSERT_EQ(pixels, values);
+
+  std::vector<float> floats;
+  GlTexture::loadTexture(prefix + ".pfm").download(floats);
+  ASSERT_EQ(pixels.size(), floats.size());
+  for (uint32_t i = 0; i < pixels.size(); ++i) ASSERT_NEAR(pixels[i] / 255.0f, floats[i], 1e-5);
+
+  // the first row is a single run; the second row has no runs: 18 bytes header + (1 + 3) + (1 + 9) bytes.
+  ASSERT_EQ(32u, boost::filesystem::file_size(prefix + ".tga"));
+
+  ASSERT_TRUE(texture.save(prefix + ".pgm"));
+  ASSERT_FALSE(texture.save(prefix + ".png"));
+  GlImageFile gray(prefix + ".pgm");
+  ASSERT_EQ(TextureFormat::R8, gray.textureFormat());
+
+  for (const std::string& ext : extensions) boost::filesystem::remove(prefix + ext);
+  boost::filesystem::remove(prefix + ".pgm");
+}
+}
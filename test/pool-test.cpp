@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include <glow/GlFramebuffer.h>
+#include <glow/GlTexturePool.h>
+
+#include <vector>
+
+using namespace glow;
+
+namespace {
+
+TEST(TexturePoolTest, recycleTest) {
+  GlTexturePool pool;
+
+  std::shared_ptr<GlTexture> texture = pool.acquire(16, 8, TextureFormat::R16F);
+  ASSERT_NO_THROW(CheckGlError());
+  GLuint id = texture->id();
+  ASSERT_EQ(16u, texture->width());
+  ASSERT_EQ(8u, texture->height());
+  ASSERT_EQ(0u, pool.freeTextures());
+
+  texture = nullptr;
+  ASSERT_EQ(1u, pool.freeTextures());
+  ASSERT_EQ(16u * 8u * 2u, pool.freeBytes());
+
+  // same parameters get the same texture object; different ones a new one.
+  std::shared_ptr<GlTexture> other = pool.acquire(16, 8, TextureFormat::R_FLOAT);
+  std::shared_ptr<GlTexture> same = pool.acquire(16, 8, TextureFormat::R16F);
+  ASSERT_NE(id, other->id());
+  ASSERT_EQ(id, same->id());
+  ASSERT_EQ(0u, pool.freeTextures());
+
+  std::shared_ptr<GlTexture> array = pool.acquireArray(16, 8, 3, TextureFormat::R16F);
+  ASSERT_NE(id, array->id());
+  ASSERT_EQ(3u, array->depth());
+
+  // resized textures are not recycled.
+  other->resize(4, 4);
+  other = nullptr;
+  ASSERT_EQ(0u, pool.freeTextures());
+
+  pool.clear();
+  ASSERT_EQ(0u, pool.freeBytes());
+  ASSERT_NO_THROW(CheckGlError());
+}
+
+TEST(TexturePoolTest, sharedTest) {
+  GlTexturePool pool;
+  GlFramebuffer fbo(4, 4);
+
+  // the texture object is still used by the framebuffer; thus, it must not be leased again.
+  std::shared_ptr<GlTexture> texture = pool.acquire(4, 4, TextureFormat::RGBA8);
+  fbo.attach(FramebufferAttachment::COLOR0, *texture);
+  texture = nullptr;
+  ASSERT_EQ(0u, pool.freeTextures());
+
+  // the framebuffer's own copy of the texture outlives the lease.
+  fbo.resize(8, 8);
+  ASSERT_NO_THROW(CheckGlError());
+  ASSERT_TRUE(fbo.valid());
+  ASSERT_EQ(8u, fbo.texture(FramebufferAttachment::COLOR0).width());
+}
+
+TEST(TexturePoolTest, trimTest) {
+  GlTexturePool pool(2 * 8 * 8 * 4);
+
+  std::vector<std::shared_ptr<GlTexture>> textures;
+  for (uint32_t i = 0; i < 3; ++i) textures.push_back(pool.acquire(8, 8, TextureFormat::RGBA8));
+  GLuint last = textures[2]->id();
+  textures.clear();
+
+  // only the most recently released textures are kept.
+  ASSERT_EQ(2u, pool.freeTextures());
+  ASSERT_EQ(2u * 8u * 8u * 4u, pool.freeBytes());
+  ASSERT_EQ(last, pool.acquire(8, 8, TextureFormat::RGBA8)->id());
+
+  pool.setMaxBytes(0);
+  ASSERT_EQ(0u, pool.freeTextures());
+
+  // leases may outlive the pool.
+  std::shared_ptr<GlTexture> lease;
+  {
+    GlTexturePool scoped;
+    lease = scoped.acquire(8, TextureFormat::R);
+  }
+  lease = nullptr;
+  ASSERT_NO_THROW(CheckGlError());
+}
+
+TEST(TexturePoolTest, cloneTest) {
+  GlTexturePool pool;
+  GlTexture texture(4, 2, TextureFormat::R_FLOAT);
+  std::vector<float> values{1, 2, 3, 4, 5, 6, 7, 8};
+  texture.assign(values);
+
+  std::shared_ptr<GlTexture> clone = pool.clone(texture);
+  std::vector<float> cloned;
+  clone->download(cloned);
+  ASSERT_NO_THROW(CheckGlError());
+  ASSERT_EQ(values, cloned);
+}
+}
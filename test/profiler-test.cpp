@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include <glow/GlProfiler.h>
+#include <glow/GlQuery.h>
+
+#include <sstream>
+
+using namespace glow;
+
+namespace {
+
+TEST(QueryTest, timestampTest) {
+  GlQuery first(QueryTarget::TIMESTAMP), second(QueryTarget::TIMESTAMP);
+  ASSERT_THROW(first.begin(), GlQueryError);
+
+  first.timestamp();
+  second.timestamp();
+
+  uint64_t t0 = 0, t1 = 0;
+  first.value(t0);
+  second.value(t1);
+  ASSERT_TRUE(first.ready());
+  ASSERT_LE(t0, t1);
+  ASSERT_NO_THROW(CheckGlError());
+}
+
+TEST(ProfilerTest, scopeTest) {
+  GlProfiler profiler(2, 10);
+
+  for (uint32_t i = 0; i < 5; ++i) {
+    profiler.beginFrame();
+    {
+      GlProfiler::Scope outer(profiler, "outer");
+      GlProfiler::Scope inner(profiler, "inner");
+      glFlush();
+    }
+    profiler.endFrame();
+  }
+  profiler.flush();
+  ASSERT_NO_THROW(CheckGlError());
+
+  std::map<std::string, GlProfiler::Statistics> stats = profiler.statistics();
+  ASSERT_EQ(2u, stats.size());
+  ASSERT_TRUE(stats.find("outer") != stats.end());
+  ASSERT_TRUE(stats.find("outer/inner") != stats.end());
+  ASSERT_EQ(5u, stats["outer/inner"].count);
+  ASSERT_LE(stats["outer/inner"].cpuMin, stats["outer/inner"].cpuMax);
+  ASSERT_GE(stats["outer"].gpuMean, 0.0);
+
+  std::stringstream trace;
+  profiler.writeChromeTrace(trace);
+  ASSERT_NE(std::string::npos, trace.str().find("\"name\":\"inner\""));
+  ASSERT_EQ(std::string::npos, trace.str().find("e+"));
+
+  ASSERT_THROW(profiler.end(), GlQueryError);
+  ASSERT_THROW(profiler.begin("no frame"), GlQueryError);
+
+  // scopes closed by endFrame() are not closed again by the destructor of the Scope.
+  {
+    profiler.beginFrame();
+    GlProfiler::Scope open(profiler, "open");
+    profiler.endFrame();
+    profiler.beginFrame();
+  }
+  profiler.endFrame();
+  {
+    profiler.beginFrame();
+    GlProfiler::Scope outer(profiler, "outer");
+    profiler.begin("unclosed");
+    profiler.end();
+    profiler.end();
+    profiler.endFrame();
+  }
+  ASSERT_NO_THROW(profiler.flush());
+}
+}
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include <glow/GlSamplerCache.h>
+#include <glow/GlStats.h>
+
+#include <type_traits>
+#include <unordered_set>
+
+using namespace glow;
+
+namespace {
+
+TEST(SamplerTest, descTest) {
+  GlSamplerDesc desc;
+  ASSERT_EQ(TexMinOp::LINEAR, desc.minifyingOperation());
+  ASSERT_EQ(TexWrapOp::REPEAT, desc.wrapR());
+
+  // with* returns a modified copy.
+  GlSamplerDesc nearest = desc.withFilter(TexMinOp::NEAREST, TexMagOp::NEAREST);
+  ASSERT_EQ(TexMinOp::LINEAR, desc.minifyingOperation());
+  ASSERT_EQ(TexMagOp::NEAREST, nearest.magnifyingOperation());
+  ASSERT_TRUE(nearest != desc);
+  ASSERT_TRUE(nearest == GlSamplerDesc().withFilter(TexMinOp::NEAREST, TexMagOp::NEAREST));
+  ASSERT_EQ(nearest.hash(), GlSamplerDesc().withFilter(TexMinOp::NEAREST, TexMagOp::NEAREST).hash());
+
+  std::unordered_set<GlSamplerDesc, GlSamplerDesc::Hash> descs{desc, nearest, desc.withWrap(TexWrapOp::CLAMP_TO_EDGE),
+                                                               desc.withCompare(GL_LEQUAL), desc.withLod(0, 2)};
+  ASSERT_EQ(5u, descs.size());
+}
+
+TEST(SamplerTest, cacheTest) {
+  GlSamplerCache& cache = GlSamplerCache::getInstance();
+  cache.clear();
+
+  GlSamplerDesc desc = GlSamplerDesc().withWrap(TexWrapOp::CLAMP_TO_EDGE).withCompare(GL_LEQUAL);
+  std::shared_ptr<const GlSampler> sampler = cache.get(desc);
+  static_assert(std::is_const<decltype(cache.get(desc))::element_type>::value, "Cached samplers must be const.");
+  ASSERT_NO_THROW(CheckGlError());
+  ASSERT_EQ(sampler, cache.get(GlSamplerDesc().withWrap(TexWrapOp::CLAMP_TO_EDGE).withCompare(GL_LEQUAL)));
+  ASSERT_NE(sampler, cache.get(GlSamplerDesc()));
+  ASSERT_EQ(2u, cache.size());
+
+  GLint value = 0;
+  glGetSamplerParameteriv(sampler->id(), GL_TEXTURE_WRAP_T, &value);
+  ASSERT_EQ(GL_CLAMP_TO_EDGE, value);
+  glGetSamplerParameteriv(sampler->id(), GL_TEXTURE_COMPARE_MODE, &value);
+  ASSERT_EQ(GL_COMPARE_REF_TO_TEXTURE, value);
+
+  // binding the same sampler again is skipped; only unit 2 must be bound.
+  cache.bind(3, desc);
+  GlStats::endFrame();
+  cache.bind(3, desc);
+  sampler->bind(2, 2);
+  GlStatsSnapshot stats = GlStats::endFrame();
+  if (GlStats::enabled()) {
+    ASSERT_EQ(1u, stats[GlStatsCall::BIND_SAMPLER]);
+  }
+
+  glActiveTexture(GL_TEXTURE2);
+  glGetIntegerv(GL_SAMPLER_BINDING, &value);
+  glActiveTexture(GL_TEXTURE0);
+  ASSERT_EQ(static_cast<GLint>(sampler->id()), value);
+
+  sampler->release(2);
+  sampler->release(3);
+  cache.clear();
+  ASSERT_EQ(0u, cache.size());
+  ASSERT_NO_THROW(CheckGlError());
+}
+}
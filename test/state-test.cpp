@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+
+#include <glow/GlFramebuffer.h>
+#include <glow/GlState.h>
+#include <glow/GlStateGuard.h>
+#include <glow/GlTexture.h>
+
+using namespace glow;
+
+namespace {
+
+TEST(StateTest, queryTest) {
+  GlState state = GlState::query(GL_VIEWPORT, GL_DEPTH_TEST, GL_ACTIVE_TEXTURE);
+  GlState all = GlState::queryAll();
+
+  ASSERT_TRUE(state.contains(GL_VIEWPORT));
+  ASSERT_TRUE(state.contains(GL_DEPTH_TEST));
+  ASSERT_FALSE(state.contains(GL_BLEND));
+
+  ASSERT_EQ(all.get<bool>(GL_DEPTH_TEST), state.get<bool>(GL_DEPTH_TEST));
+  ASSERT_EQ(all.get<int32_t>(GL_ACTIVE_TEXTURE), state.get<int32_t>(GL_ACTIVE_TEXTURE));
+  ASSERT_THROW(state.get<int32_t>(GL_BLEND), std::runtime_error);
+  ASSERT_THROW(GlState::query(GL_MAX_TEXTURE_SIZE), std::runtime_error);
+
+  ASSERT_TRUE(GlState::queryAll() == all);
+}
+
+TEST(StateTest, guardTest) {
+  glViewport(0, 0, 100, 50);
+  glEnable(GL_DEPTH_TEST);
+
+  GlState before = GlState::queryAll();
+
+  GlFramebuffer fbo(10, 10);
+  GlRenderbuffer rbo(10, 10, RenderbufferFormat::RGBA);
+  fbo.attach(FramebufferAttachment::COLOR0, rbo);
+
+  {
+    GlStateGuard guard(GlStateCategory::VIEWPORT | GlStateCategory::DEPTH | GlStateCategory::FRAMEBUFFER |
+                       GlStateCategory::TEXTURE_UNITS);
+
+    guard.setViewport(0, 0, 10, 10);
+    guard.setDepthTest(false);
+    guard.setActiveTexture(3);
+    fbo.bind();
+
+    GlState inside = GlState::query(GL_VIEWPORT, GL_DEPTH_TEST, GL_ACTIVE_TEXTURE, GL_DRAW_FRAMEBUFFER_BINDING);
+    ASSERT_FALSE(inside.get<bool>(GL_DEPTH_TEST));
+    ASSERT_EQ(GL_TEXTURE3, inside.get<int32_t>(GL_ACTIVE_TEXTURE));
+    ASSERT_EQ(static_cast<int32_t>(fbo.id()), inside.get<int32_t>(GL_DRAW_FRAMEBUFFER_BINDING));
+
+    ASSERT_THROW(guard.setBlend(true), GlStateError);  // not guarded.
+  }
+
+  GlState after = GlState::queryAll();
+  if (after != before) before.difference(after);
+  ASSERT_TRUE(after == before);
+  ASSERT_NO_THROW(CheckGlError());
+}
+
+TEST(StateTest, foreignFramebufferTest) {
+  // framebuffers bound without glow, e.g., by a QOpenGLWidget, must be restored by copies, etc.
+  GLuint framebuffers[2];
+  glGenFramebuffers(2, framebuffers);
+  GlRenderbuffer rbo(10, 10, RenderbufferFormat::RGBA8);
+  for (uint32_t i = 0; i < 2; ++i) {
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffers[i]);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, rbo.id());
+  }
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffers[0]);
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffers[1]);
+
+  GlTexture src(10, 10, TextureFormat::RGBA8), dst(5, 5, TextureFormat::RGBA8);
+  GlState before = GlState::queryAll();
+  dst.copy(src);
+  GlTexture copy = src.clone();
+
+  GlState after = GlState::queryAll();
+  if (after != before) before.difference(after);
+  ASSERT_TRUE(after == before);
+  ASSERT_EQ(static_cast<int32_t>(framebuffers[0]), after.get<int32_t>(GL_DRAW_FRAMEBUFFER_BINDING));
+  ASSERT_EQ(static_cast<int32_t>(framebuffers[1]), after.get<int32_t>(GL_READ_FRAMEBUFFER_BINDING));
+
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  glDeleteFramebuffers(2, framebuffers);
+  ASSERT_NO_THROW(CheckGlError());
+}
+
+}
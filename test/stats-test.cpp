@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include <glow/GlBuffer.h>
+#include <glow/GlStats.h>
+#include <glow/GlTexture.h>
+
+#include <vector>
+
+using namespace glow;
+
+namespace {
+
+TEST(StatsTest, countTest) {
+  GlStats::endFrame();  // start with a fresh frame.
+
+  {
+    GlBuffer<float> buffer(BufferTarget::ARRAY_BUFFER, BufferUsage::STATIC_DRAW);
+    std::vector<float> values(100, 1.0f);
+    buffer.assign(values);
+    buffer.get(values);
+
+    GlTexture texture(10, 10, TextureFormat::RGBA_FLOAT);
+    std::vector<float> pixels(4 * 10 * 10, 0.5f);
+    texture.assign(PixelFormat::RGBA, PixelType::FLOAT, &pixels[0]);
+    texture.download(pixels);
+  }
+
+  GlStatsSnapshot stats = GlStats::endFrame();
+  ASSERT_NO_THROW(CheckGlError());
+
+  if (!GlStats::enabled()) {
+    // counting compiled out: nothing should be counted at all.
+    ASSERT_EQ(0u, stats.totalCalls());
+    ASSERT_EQ(0u, stats.bytesUploaded);
+    return;
+  }
+
+  ASSERT_EQ(100 * sizeof(float) + 400 * sizeof(float), stats.bytesUploaded);
+  ASSERT_EQ(100 * sizeof(float) + 400 * sizeof(float), stats.bytesDownloaded);
+  ASSERT_EQ(2u, stats[GlStatsCall::UPLOAD]);
+  ASSERT_EQ(2u, stats[GlStatsCall::DOWNLOAD]);
+
+  ASSERT_EQ(1u, stats.created[static_cast<uint32_t>(GlStatsObject::BUFFER)]);
+  ASSERT_EQ(1u, stats.destroyed[static_cast<uint32_t>(GlStatsObject::BUFFER)]);
+  ASSERT_EQ(1u, stats.created[static_cast<uint32_t>(GlStatsObject::TEXTURE)]);
+  ASSERT_EQ(1u, stats.destroyed[static_cast<uint32_t>(GlStatsObject::TEXTURE)]);
+  ASSERT_GT(stats[GlStatsCall::BIND_BUFFER], 0u);
+  ASSERT_GT(stats[GlStatsCall::BIND_TEXTURE], 0u);
+
+  // counters are reset for the next frame.
+  ASSERT_EQ(0u, GlStats::current().totalCalls());
+  ASSERT_EQ(stats.bytesUploaded, GlStats::lastFrame().bytesUploaded);
+}
+
+TEST(StatsTest, copyTest) {
+  GlTexture src(10, 10, TextureFormat::RGBA8), dst(10, 10, TextureFormat::RGBA8);
+  GlStats::endFrame();
+
+  dst.copy(src);
+
+  GlStatsSnapshot stats = GlStats::endFrame();
+  ASSERT_NO_THROW(CheckGlError());
+  if (GlStats::enabled()) {
+    // a single copy of 4 bytes per texel.
+    ASSERT_EQ(1u, stats[GlStatsCall::COPY]);
+    ASSERT_EQ(10u * 10 * 4, stats.bytesCopied);
+  } else {
+    ASSERT_EQ(0u, stats.bytesCopied);
+  }
+}
+
+TEST(StatsTest, redundantBindTest) {
+  GlBuffer<float> buffer(BufferTarget::ARRAY_BUFFER, BufferUsage::STATIC_DRAW);
+  std::vector<float> values(10, 1.0f);
+
+  buffer.bind();
+  GlStats::endFrame();
+
+  buffer.assign(values);  // already bound: no bind needed.
+  buffer.release();
+
+  GlStatsSnapshot stats = GlStats::endFrame();
+  if (GlStats::enabled()) {
+    ASSERT_EQ(1u, stats.redundantBinds);
+    ASSERT_EQ(1u, stats[GlStatsCall::BIND_BUFFER]);  // only the release.
+  } else {
+    ASSERT_EQ(0u, stats.redundantBinds);
+  }
+}
+
+}
@@ -3,6 +3,10 @@
 #include <glow/GlTexture.h>
 #include <glow/GlState.h>
 #include <glow/GlTextureRectangle.h>
+#include <glow/GlTextureView.h>
+#include <glow/GlTypedTexture.h>
+
+#include <cstring>
 
 using namespace glow;
 
@@ -103,6 +107,576 @@ TEST(TextureTest, cloneTest) {
   }
 }
 
+TEST(TextureTest, clone1DTest) {
+  GlTexture texture(100, TextureFormat::RGBA_FLOAT);
+  ASSERT_NO_THROW(CheckGlError());
+
+  std::vector<float> img(100 * 4);
+  for (uint32_t i = 0; i < img.size(); ++i) {
+    img[i] = 0.5f * i;
+  }
+
+  texture.assign(PixelFormat::RGBA, PixelType::FLOAT, &img[0]);
+  ASSERT_NO_THROW(CheckGlError());
+
+  GlTexture clone = texture.clone();
+  ASSERT_NO_THROW(CheckGlError());
+  ASSERT_EQ(texture.width(), clone.width());
+
+  std::vector<float> device_mem;
+  clone.download(device_mem);
+  ASSERT_EQ(img.size(), device_mem.size());
+
+  for (uint32_t i = 0; i < img.size(); ++i) {
+    ASSERT_EQ(img[i], device_mem[i]);
+  }
+}
+
+TEST(TextureTest, clone3DTest) {
+  GlTexture texture(20, 10, 5, TextureFormat::RGBA_FLOAT);
+  ASSERT_NO_THROW(CheckGlError());
+
+  std::vector<float> img(20 * 10 * 5 * 4);
+  for (uint32_t i = 0; i < img.size(); ++i) {
+    img[i] = 3.25f * i;
+  }
+
+  texture.assign(PixelFormat::RGBA, PixelType::FLOAT, &img[0]);
+  ASSERT_NO_THROW(CheckGlError());
+
+  GlState state_before = GlState::queryAll();
+
+  GlTexture clone = texture.clone();
+  ASSERT_NO_THROW(CheckGlError());
+
+  GlState state_afterwards = GlState::queryAll();
+  ASSERT_TRUE(state_before == state_afterwards);
+
+  ASSERT_EQ(texture.width(), clone.width());
+  ASSERT_EQ(texture.height(), clone.height());
+  ASSERT_EQ(texture.depth(), clone.depth());
+
+  std::vector<float> device_mem;
+  clone.download(device_mem);
+  ASSERT_EQ(img.size(), device_mem.size());
+
+  for (uint32_t i = 0; i < img.size(); ++i) {
+    ASSERT_EQ(img[i], device_mem[i]);
+  }
+}
+
+TEST(TextureTest, arrayTest) {
+  GlTexture texture = GlTexture::array2D(6, 4, 3, TextureFormat::R_FLOAT, 2);
+  ASSERT_NO_THROW(CheckGlError());
+  ASSERT_EQ(3u, texture.depth());
+
+  std::vector<std::vector<float>> layers(3, std::vector<float>(6 * 4));
+  for (uint32_t l = 0; l < layers.size(); ++l) {
+    for (uint32_t i = 0; i < layers[l].size(); ++i) layers[l][i] = 100.0f * l + i;
+    texture.assignLayer(l, PixelFormat::R, PixelType::FLOAT, &layers[l][0]);
+  }
+  ASSERT_NO_THROW(CheckGlError());
+
+  for (uint32_t l = 0; l < layers.size(); ++l) {
+    std::vector<float> values(6 * 4);
+    texture.downloadLayer(l, PixelFormat::R, PixelType::FLOAT, &values[0]);
+    ASSERT_EQ(layers[l], values);
+  }
+
+  // the layers are drawn at once into the layered clone.
+  GlTexture clone = texture.clone();
+  std::vector<float> values;
+  clone.download(values);
+  ASSERT_NO_THROW(CheckGlError());
+  ASSERT_EQ(static_cast<size_t>(6 * 4 * 3), values.size());
+  for (uint32_t l = 0; l < layers.size(); ++l) {
+    for (uint32_t i = 0; i < layers[l].size(); ++i) ASSERT_EQ(layers[l][i], values[l * 6 * 4 + i]);
+  }
+
+  GlTexture integer = GlTexture::array2D(6, 4, 3, TextureFormat::R_INTEGER);
+  integer.copy(texture);
+  std::vector<int32_t> ints(6 * 4);
+  integer.downloadLayer(2, PixelFormat::R_INTEGER, PixelType::INT, &ints[0]);
+  ASSERT_NO_THROW(CheckGlError());
+  for (uint32_t i = 0; i < ints.size(); ++i) ASSERT_EQ(int32_t(layers[2][i]), ints[i]);
+
+  ASSERT_THROW(texture.assignLayer(3, PixelFormat::R, PixelType::FLOAT, &layers[0][0]), GlTextureError);
+}
+
+TEST(TextureTest, copyIntegerTest) {
+  // copy between integer and float formats needs a conversion by the cached copy program.
+  GlTexture texture(10, 10, TextureFormat::R_INTEGER);
+  std::vector<int32_t> img(10 * 10);
+  for (uint32_t i = 0; i < img.size(); ++i) {
+    img[i] = i;
+  }
+  texture.assign(PixelFormat::R_INTEGER, PixelType::INT, &img[0]);
+
+  GlTexture texture2(10, 10, TextureFormat::R_FLOAT);
+  texture2.copy(texture);
+  ASSERT_NO_THROW(CheckGlError());
+
+  std::vector<float> device_mem;
+  texture2.download(device_mem);
+  ASSERT_EQ(img.size(), device_mem.size());
+
+  for (uint32_t i = 0; i < img.size(); ++i) {
+    ASSERT_EQ(static_cast<float>(img[i]), device_mem[i]);
+  }
+}
+
+TEST(TextureTest, copyLinearTest) {
+  GlTexture texture(2, 1, TextureFormat::R_FLOAT);
+  std::vector<float> img{0.0f, 100.0f};
+  texture.assign(PixelFormat::R, PixelType::FLOAT, &img[0]);
+
+  // same kind of format: glBlitFramebuffer with GL_LINEAR.
+  GlTexture scaled(4, 1, TextureFormat::R_FLOAT);
+  GlState before = GlState::queryAll();
+  scaled.copy(texture, TexMagOp::LINEAR);
+  GlState after = GlState::queryAll();
+  if (after != before) before.difference(after);
+  ASSERT_TRUE(after == before);
+
+  std::vector<float> values;
+  scaled.download(values);
+  ASSERT_NO_THROW(CheckGlError());
+  std::vector<float> expected{0.0f, 25.0f, 75.0f, 100.0f};
+  for (uint32_t i = 0; i < expected.size(); ++i) ASSERT_NEAR(expected[i], values[i], 0.5f);
+
+  // other kind of format: linearly sampled by the copy program.
+  GlTexture integer(4, 1, TextureFormat::R_INTEGER);
+  integer.copy(texture, TexMagOp::LINEAR);
+  std::vector<int32_t> integers;
+  integer.download(integers);
+  ASSERT_NO_THROW(CheckGlError());
+  for (uint32_t i = 0; i < expected.size(); ++i) ASSERT_NEAR(expected[i], integers[i], 1.0f);
+
+  // integer values cannot be interpolated.
+  GlTexture wide(8, 1, TextureFormat::R_INTEGER);
+  ASSERT_THROW(wide.copy(integer, TexMagOp::LINEAR), GlTextureError);
+  ASSERT_NO_THROW(wide.copy(integer));
+}
+
+TEST(TextureTest, resizeTest) {
+  GlTexture texture(10, 20, TextureFormat::R_FLOAT);
+
+  std::vector<float> img(10 * 20);
+  for (uint32_t i = 0; i < img.size(); ++i) {
+    img[i] = 0.5f * i;
+  }
+  texture.assign(PixelFormat::R, PixelType::FLOAT, &img[0]);
+
+  GLuint id = texture.id();
+  texture.resize(15, 10, TexResizeMode::PRESERVE);
+  ASSERT_NO_THROW(CheckGlError());
+  // only immutable storage needs a new texture object.
+  if (!texture.immutable()) {
+    ASSERT_EQ(id, texture.id());
+  }
+  ASSERT_EQ(15u, texture.width());
+  ASSERT_EQ(10u, texture.height());
+
+  std::vector<float> device_mem;
+  texture.download(device_mem);
+  ASSERT_EQ(static_cast<size_t>(15 * 10), device_mem.size());
+
+  // only the overlapping region is defined.
+  for (uint32_t y = 0; y < 10; ++y) {
+    for (uint32_t x = 0; x < 10; ++x) {
+      ASSERT_EQ(img[x + y * 10], device_mem[x + y * 15]);
+    }
+  }
+}
+
+TEST(TextureTest, levelsTest) {
+  ASSERT_EQ(1u, GlTexture::maxLevels(1));
+  ASSERT_EQ(8u, GlTexture::maxLevels(128, 100));
+  ASSERT_EQ(9u, GlTexture::maxLevels(10, 20, 300));
+
+  GlTexture texture(64, 32, TextureFormat::RGBA_FLOAT, GlTexture::maxLevels(64, 32));
+  ASSERT_NO_THROW(CheckGlError());
+  ASSERT_EQ(7u, texture.levels());
+#if __GL_VERSION >= 420L
+  ASSERT_TRUE(texture.immutable());
+#endif
+
+  texture.generateMipmaps();
+  ASSERT_NO_THROW(CheckGlError());
+}
+
+#if __GL_VERSION >= 430L
+TEST(TextureTest, viewTest) {
+  GlTexture texture(10, 10, TextureFormat::R_FLOAT);
+  std::vector<float> img(10 * 10);
+  for (uint32_t i = 0; i < img.size(); ++i) {
+    img[i] = 0.25f * i;
+  }
+  texture.assign(PixelFormat::R, PixelType::FLOAT, &img[0]);
+
+  // same bits seen as integer values.
+  GlTextureView view(texture, TextureFormat::R_INTEGER);
+  ASSERT_NO_THROW(CheckGlError());
+  ASSERT_EQ(texture.width(), view.width());
+  ASSERT_EQ(texture.height(), view.height());
+
+  std::vector<int32_t> values(10 * 10);
+  view.download(PixelFormat::R_INTEGER, &values[0]);
+  for (uint32_t i = 0; i < img.size(); ++i) {
+    int32_t expected;
+    std::memcpy(&expected, &img[i], sizeof(float));
+    ASSERT_EQ(expected, values[i]);
+  }
+
+  ASSERT_THROW(view.resize(20, 20), GlTextureError);
+}
+#endif
+
+TEST(TextureTest, assignRegionTest) {
+  GlTexture texture(10, 20, TextureFormat::R_FLOAT);
+  std::vector<float> img(10 * 20, 1.0f);
+  texture.assign(PixelFormat::R, PixelType::FLOAT, &img[0]);
+
+  // update a single row.
+  std::vector<float> row(10, 2.0f);
+  texture.assignRegion(0, 5, 0, 10, 1, 1, PixelFormat::R, PixelType::FLOAT, &row[0]);
+  ASSERT_NO_THROW(CheckGlError());
+
+  ASSERT_THROW(texture.assignRegion(5, 0, 0, 10, 1, 1, PixelFormat::R, PixelType::FLOAT, &row[0]), GlTextureError);
+
+  std::vector<float> device_mem;
+  texture.download(device_mem);
+  ASSERT_EQ(img.size(), device_mem.size());
+  for (uint32_t i = 0; i < device_mem.size(); ++i) {
+    ASSERT_EQ((i / 10 == 5) ? 2.0f : 1.0f, device_mem[i]);
+  }
+}
+
+TEST(TextureTest, assignRegion3DTest) {
+  GlTexture texture(4, 4, 3, TextureFormat::R_FLOAT);
+  std::vector<float> img(4 * 4 * 3, 0.0f);
+  texture.assign(PixelFormat::R, PixelType::FLOAT, &img[0]);
+
+  // update a single slice.
+  std::vector<float> slice(4 * 4, 3.0f);
+  texture.assignRegion(0, 0, 1, 4, 4, 1, PixelFormat::R, PixelType::FLOAT, &slice[0]);
+  ASSERT_NO_THROW(CheckGlError());
+
+  std::vector<float> device_mem;
+  texture.download(device_mem);
+  ASSERT_EQ(img.size(), device_mem.size());
+  for (uint32_t i = 0; i < device_mem.size(); ++i) {
+    ASSERT_EQ((i / 16 == 1) ? 3.0f : 0.0f, device_mem[i]);
+  }
+}
+
+TEST(TextureTest, downloadRegionTest) {
+  GlTexture texture(8, 6, TextureFormat::R_FLOAT, 2);
+  std::vector<float> img(8 * 6);
+  for (uint32_t i = 0; i < img.size(); ++i) img[i] = i;
+  texture.assign(PixelFormat::R, PixelType::FLOAT, &img[0]);
+
+  // 3 x 2 pixels starting at (2, 3).
+  std::vector<float> region(3 * 2);
+  texture.downloadRegion(2, 3, 3, 2, PixelFormat::R, PixelType::FLOAT, &region[0]);
+  ASSERT_NO_THROW(CheckGlError());
+  for (uint32_t i = 0; i < region.size(); ++i) {
+    ASSERT_EQ(img[(3 + i / 3) * 8 + 2 + i % 3], region[i]);
+  }
+
+  ASSERT_THROW(texture.downloadRegion(6, 0, 3, 1, PixelFormat::R, PixelType::FLOAT, &region[0]), GlTextureError);
+  ASSERT_THROW(texture.downloadRegion(0, 0, 1, 1, PixelFormat::R, PixelType::FLOAT, &region[0], 2), GlTextureError);
+
+  // level 1 has 4 x 3 pixels.
+  std::vector<float> constant(8 * 6, 5.0f);
+  texture.assign(PixelFormat::R, PixelType::FLOAT, &constant[0]);
+  texture.generateMipmaps();
+  std::vector<float> level(4 * 3);
+  texture.downloadRegion(0, 0, 4, 3, PixelFormat::R, PixelType::FLOAT, &level[0], 1);
+  for (uint32_t i = 0; i < level.size(); ++i) ASSERT_FLOAT_EQ(5.0f, level[i]);
+  ASSERT_THROW(texture.downloadRegion(0, 0, 5, 1, PixelFormat::R, PixelType::FLOAT, &level[0], 1), GlTextureError);
+}
+
+TEST(TextureTest, downloadRegion3DTest) {
+  GlTexture texture(4, 4, 3, TextureFormat::R_FLOAT);
+  std::vector<float> img(4 * 4 * 3);
+  for (uint32_t i = 0; i < img.size(); ++i) img[i] = i;
+  texture.assign(PixelFormat::R, PixelType::FLOAT, &img[0]);
+
+  // second row of the last slice.
+  std::vector<float> row(4);
+  texture.downloadRegion(0, 1, 4, 1, PixelFormat::R, PixelType::FLOAT, &row[0], 0, 2);
+  ASSERT_NO_THROW(CheckGlError());
+  for (uint32_t i = 0; i < row.size(); ++i) ASSERT_EQ(img[2 * 16 + 4 + i], row[i]);
+
+  ASSERT_THROW(texture.downloadRegion(0, 0, 4, 1, PixelFormat::R, PixelType::FLOAT, &row[0], 0, 3), GlTextureError);
+}
+
+TEST(TextureTest, pixelStoreTest) {
+  // rows of 5 RGB pixels padded to 16 bytes.
+  PixelStore padded = PixelStore::fromStride(16, PixelFormat::RGB, PixelType::UNSIGNED_BYTE);
+  ASSERT_EQ(5u, padded.rowLength);
+  ASSERT_EQ(2u, padded.alignment);
+  ASSERT_EQ(3u * 16 + 15, padded.size(5, 4, PixelFormat::RGB, PixelType::UNSIGNED_BYTE));
+  ASSERT_THROW(PixelStore::fromStride(17, PixelFormat::RGB, PixelType::UNSIGNED_BYTE), GlTextureError);
+
+  // upload the 4 x 3 region at (1, 1) of a host image with 6 x 4 pixels.
+  std::vector<float> host(6 * 4);
+  for (uint32_t i = 0; i < host.size(); ++i) host[i] = i;
+  PixelStore layout;
+  layout.rowLength = 6;
+  layout.skipPixels = 1;
+  layout.skipRows = 1;
+
+  GlTexture texture(4, 3, TextureFormat::R_FLOAT);
+  texture.assign(PixelFormat::R, PixelType::FLOAT, &host[0], layout);
+  ASSERT_NO_THROW(CheckGlError());
+
+  GLint rowLength = -1;
+  glGetIntegerv(GL_UNPACK_ROW_LENGTH, &rowLength);
+  ASSERT_EQ(0, rowLength);
+
+  std::vector<float> values(4 * 3);
+  texture.download(PixelFormat::R, &values[0]);
+  for (uint32_t i = 0; i < values.size(); ++i) ASSERT_EQ(host[(i / 4 + 1) * 6 + i % 4 + 1], values[i]);
+
+  // download into rows of 6 pixels; the padding stays untouched.
+  PixelStore rows;
+  rows.rowLength = 6;
+  std::vector<float> result(6 * 3, -1.0f);
+  texture.download(PixelFormat::R, PixelType::FLOAT, &result[0], rows);
+  for (uint32_t i = 0; i < result.size(); ++i) {
+    ASSERT_EQ((i % 6 < 4) ? values[(i / 6) * 4 + i % 6] : -1.0f, result[i]);
+  }
+
+  std::vector<float> region(6 * 2, -1.0f);
+  texture.downloadRegion(1, 1, 2, 2, PixelFormat::R, PixelType::FLOAT, &region[0], rows);
+  ASSERT_EQ(values[5], region[0]);
+  ASSERT_EQ(values[6], region[1]);
+  ASSERT_EQ(-1.0f, region[2]);
+  ASSERT_EQ(values[9], region[6]);
+
+  // the layout of the caller is restored after the transfers.
+  PixelStore aligned;
+  aligned.alignment = 2;
+  PixelStore previous = aligned.apply(false);
+  aligned.apply(true);
+  texture.assign(PixelFormat::R, PixelType::FLOAT, &host[0], layout);
+  texture.download(PixelFormat::R, PixelType::FLOAT, &result[0], rows);
+  texture.downloadRegion(1, 1, 2, 2, PixelFormat::R, PixelType::FLOAT, &region[0], rows);
+  ASSERT_NO_THROW(CheckGlError());
+  GLint value = -1;
+  glGetIntegerv(GL_UNPACK_ALIGNMENT, &value);
+  ASSERT_EQ(2, value);
+  glGetIntegerv(GL_UNPACK_ROW_LENGTH, &value);
+  ASSERT_EQ(0, value);
+  glGetIntegerv(GL_PACK_ALIGNMENT, &value);
+  ASSERT_EQ(2, value);
+  glGetIntegerv(GL_PACK_ROW_LENGTH, &value);
+  ASSERT_EQ(0, value);
+  ASSERT_EQ(2u, PixelStore::current(false).alignment);
+  previous.apply(false);
+  previous.apply(true);
+  glGetIntegerv(GL_PACK_ALIGNMENT, &value);
+  ASSERT_EQ(4, value);
+}
+
+TEST(TextureTest, tightRowsTest) {
+  // rows of 3 and 15 bytes are not multiples of the default alignment of 4.
+  GlTexture gray(3, 2, TextureFormat::R8);
+  std::vector<uint8_t> pixels{1, 2, 3, 4, 5, 6};
+  gray.assign(pixels);
+  std::vector<uint8_t> values;
+  gray.download(values);
+  ASSERT_NO_THROW(CheckGlError());
+  ASSERT_EQ(pixels, values);
+
+  GlTexture color(5, 2, TextureFormat::RGB8);
+  std::vector<uint8_t> colors(5 * 2 * 3);
+  for (uint32_t i = 0; i < colors.size(); ++i) colors[i] = i;
+  color.assign(PixelFormat::RGB, &colors[0]);
+  std::vector<uint8_t> colorValues(colors.size() + 4, 255);
+  color.download(&colorValues[0]);
+  ASSERT_NO_THROW(CheckGlError());
+  for (uint32_t i = 0; i < colors.size(); ++i) ASSERT_EQ(colors[i], colorValues[i]);
+  for (uint32_t i = colors.size(); i < colorValues.size(); ++i) ASSERT_EQ(255, colorValues[i]);
+
+  std::vector<uint8_t> region(2 * 2 * 3);
+  color.downloadRegion(3, 0, 2, 2, PixelFormat::RGB, PixelType::UNSIGNED_BYTE, &region[0]);
+  ASSERT_EQ(colors[9], region[0]);
+  ASSERT_EQ(colors[24], region[6]);
+
+  // the default layout of OpenGL is restored afterwards.
+  GLint alignment = 0;
+  glGetIntegerv(GL_PACK_ALIGNMENT, &alignment);
+  ASSERT_EQ(4, alignment);
+  glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+  ASSERT_EQ(4, alignment);
+}
+
+TEST(TextureTest, pixelTypeTest) {
+  // the pixel type must match the type of typed data; untyped data is taken as given.
+  GlTexture texture(2, 2, TextureFormat::R8);
+  std::vector<float> values(4, 0.5f);
+  ASSERT_THROW(texture.assign(PixelFormat::R, PixelType::UNSIGNED_BYTE, &values[0]), GlTextureError);
+  ASSERT_THROW(texture.assignRegion(0, 0, 0, 1, 1, 1, PixelFormat::R, PixelType::INT, &values[0]), GlTextureError);
+
+  std::vector<uint8_t> pixels{1, 2, 3, 4};
+  const void* data = &pixels[0];
+  texture.assign(PixelFormat::R, PixelType::UNSIGNED_BYTE, data);
+  std::vector<uint8_t> result;
+  texture.download(result);
+  ASSERT_NO_THROW(CheckGlError());
+  ASSERT_EQ(pixels, result);
+
+  GlTexture2D typed(2, 2, TextureFormat::R8);
+  ASSERT_THROW(typed.assign(PixelFormat::R, PixelType::UNSIGNED_BYTE, &values[0]), GlTextureError);
+}
+
+TEST(TextureTest, typedTest) {
+  static_assert(TextureFormatTraits<TextureFormat::RG_FLOAT>::components == 2, "RG_FLOAT has two components.");
+  static_assert(PixelTypeOf<const uint16_t>::type == PixelType::UNSIGNED_SHORT, "uint16_t is UNSIGNED_SHORT.");
+  static_assert(PixelTypeOf<vec4>::components == 4, "vec4 has four components.");
+
+  // pixel format and type are inferred from the texture format and the element type.
+  GlTexture texture(4, 2, TextureFormat::RG_FLOAT);
+  std::vector<float> img(4 * 2 * 2);
+  for (uint32_t i = 0; i < img.size(); ++i) img[i] = 0.5f * i;
+  texture.assign(img);
+  ASSERT_NO_THROW(CheckGlError());
+
+  std::vector<float> values;
+  texture.download(values);
+  ASSERT_EQ(img.size(), values.size());
+  for (uint32_t i = 0; i < img.size(); ++i) ASSERT_EQ(img[i], values[i]);
+
+  std::vector<vec4> pixels;
+  texture.download(pixels);
+  ASSERT_EQ(static_cast<size_t>(4 * 2), pixels.size());
+  for (uint32_t i = 0; i < pixels.size(); ++i) {
+    ASSERT_EQ(img[2 * i], pixels[i].x);
+    ASSERT_EQ(img[2 * i + 1], pixels[i].y);
+  }
+
+  ASSERT_THROW(texture.assign(std::vector<float>(3)), GlTextureError);
+
+  // float values of an integer texture.
+  GlTexture integer(3, 3, TextureFormat::R_INTEGER);
+  std::vector<int32_t> ints(3 * 3);
+  for (uint32_t i = 0; i < ints.size(); ++i) ints[i] = int32_t(i) - 4;
+  integer.assign(PixelFormat::R_INTEGER, &ints[0]);
+
+  std::vector<vec4> converted;
+  integer.download(converted);
+  ASSERT_NO_THROW(CheckGlError());
+  ASSERT_EQ(ints.size(), converted.size());
+  for (uint32_t i = 0; i < ints.size(); ++i) {
+    ASSERT_EQ(float(ints[i]), converted[i].x);
+    ASSERT_EQ(0.0f, converted[i].y);
+  }
+}
+
+TEST(TextureTest, compactFormatsTest) {
+  static_assert(TextureFormatTraits<TextureFormat::R16F>::pixelType == GL_HALF_FLOAT, "R16F uses half floats.");
+  static_assert(TextureFormatTraits<TextureFormat::R8UI>::integer, "R8UI is an integer format.");
+
+  // half floats are converted from and to floats by the driver.
+  GlTexture half(4, 3, TextureFormat::R16F);
+  std::vector<float> ranges(4 * 3);
+  for (uint32_t i = 0; i < ranges.size(); ++i) ranges[i] = 0.25f * i - 1.0f;  // exactly representable.
+  half.assign(ranges);
+  std::vector<float> halfValues;
+  half.download(halfValues);
+  ASSERT_NO_THROW(CheckGlError());
+  ASSERT_EQ(ranges.size(), halfValues.size());
+  for (uint32_t i = 0; i < ranges.size(); ++i) ASSERT_EQ(ranges[i], halfValues[i]);
+
+  GlTexture labels(5, 2, TextureFormat::R8UI);
+  std::vector<uint8_t> ids(5 * 2);
+  for (uint32_t i = 0; i < ids.size(); ++i) ids[i] = 25 * i;
+  labels.assign(PixelFormat::R_INTEGER, &ids[0]);
+  std::vector<uint8_t> labelValues;
+  labels.download(labelValues);
+  ASSERT_NO_THROW(CheckGlError());
+  // rows of 5 bytes are tightly packed; padded rows would shift the second row.
+  ASSERT_EQ(ids, labelValues);
+
+  GlTexture depth(3, 3, TextureFormat::DEPTH16);
+  std::vector<float> depths(3 * 3, 0.5f);
+  depths[4] = 1.0f;
+  depth.assign(depths);
+  std::vector<float> depthValues;
+  depth.download(depthValues);
+  ASSERT_NO_THROW(CheckGlError());
+  ASSERT_EQ(depths.size(), depthValues.size());
+  for (uint32_t i = 0; i < depths.size(); ++i) ASSERT_NEAR(depths[i], depthValues[i], 1.0f / 65535.0f);
+
+  // gray textures store a single channel, but return (R, R, R, 1) when sampled.
+  GlTexture gray(2, 2, TextureFormat::GRAY);
+  std::vector<uint8_t> intensities{0, 64, 128, 255};
+  gray.assign(PixelFormat::R, &intensities[0]);
+  std::vector<uint8_t> grayValues;
+  gray.download(grayValues);
+  ASSERT_EQ(intensities, grayValues);
+
+  GLint swizzle[4];
+  gray.bind();
+  glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+  gray.release();
+  ASSERT_NO_THROW(CheckGlError());
+  ASSERT_EQ(GL_RED, swizzle[0]);
+  ASSERT_EQ(GL_RED, swizzle[1]);
+  ASSERT_EQ(GL_RED, swizzle[2]);
+  ASSERT_EQ(GL_ONE, swizzle[3]);
+}
+
+TEST(TextureTest, targetTest) {
+  GlTexture1D line(4, TextureFormat::R_FLOAT);
+  std::vector<float> values{1.0f, 2.0f, 3.0f, 4.0f};
+  line.assign(values);
+  float value = 5.0f;
+  line.assignRegion(2, 1, PixelFormat::R, PixelType::FLOAT, &value);
+  std::vector<float> lineValues;
+  line.download(lineValues);
+  ASSERT_NO_THROW(CheckGlError());
+  ASSERT_EQ(std::vector<float>({1.0f, 2.0f, 5.0f, 4.0f}), lineValues);
+  ASSERT_THROW(line.assignRegion(3, 2, PixelFormat::R, PixelType::FLOAT, &values[0]), GlTextureError);
+
+  GlTexture2D image(2, 2, TextureFormat::R_FLOAT);
+  image.assign(values);
+  image.assignRegion(1, 1, 1, 1, PixelFormat::R, PixelType::FLOAT, &value);
+  image.resize(4, 2, TexResizeMode::PRESERVE);
+  std::vector<float> row(4);
+  image.downloadRegion(0, 1, 2, 1, PixelFormat::R, PixelType::FLOAT, &row[0]);
+  ASSERT_NO_THROW(CheckGlError());
+  ASSERT_EQ(3.0f, row[0]);
+  ASSERT_EQ(5.0f, row[1]);
+
+  GlTexture2DArray layers(2, 2, 3, TextureFormat::R_FLOAT);
+  layers.assignLayer(1, PixelFormat::R, PixelType::FLOAT, &values[0]);
+  std::vector<float> layer(4);
+  layers.downloadLayer(1, PixelFormat::R, PixelType::FLOAT, &layer[0]);
+  ASSERT_NO_THROW(CheckGlError());
+  ASSERT_EQ(values, layer);
+
+  // rows of 3 bytes are uploaded tightly packed by the typed path as well.
+  GlTexture2D gray(3, 2, TextureFormat::R8);
+  std::vector<uint8_t> pixels{1, 2, 3, 4, 5, 6};
+  gray.assign(pixels);
+  std::vector<uint8_t> grayValues;
+  gray.download(grayValues);
+  ASSERT_NO_THROW(CheckGlError());
+  ASSERT_EQ(pixels, grayValues);
+
+  // typed textures are textures; thus, a clone keeps the target.
+  GlTexture3D volume(2, 2, 2, TextureFormat::R_FLOAT);
+  GlTexture3D copy = volume.clone();
+  ASSERT_EQ(2u, copy.depth());
+  GlTexture& texture = copy;
+  ASSERT_THROW(texture.resize(4, 4, TexResizeMode::DISCARD), GlTextureError);
+  ASSERT_NO_THROW(CheckGlError());
+}
+
 TEST(TextureRectangleTest, loadTexture) {
 }
 
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+
+#include <glow/GlTextureUploader.h>
+
+#include <vector>
+
+using namespace glow;
+
+namespace {
+
+TEST(UploaderTest, uploadTest) {
+  uint32_t width = 11, height = 7;
+  GlTexture texture(width, height, TextureFormat::R_FLOAT);
+  GlTextureUploader uploader(width * height * sizeof(float), 2);
+
+  ASSERT_THROW(uploader.upload(texture, PixelFormat::R, PixelType::FLOAT), GlTextureError);
+
+  // more frames than buffers: the ring must wait for the previous transfers.
+  for (uint32_t frame = 0; frame < 5; ++frame) {
+    float* ptr = reinterpret_cast<float*>(uploader.map());
+    for (uint32_t i = 0; i < width * height; ++i) ptr[i] = frame * 1000.0f + i;
+    uploader.upload(texture, PixelFormat::R, PixelType::FLOAT);
+
+    std::vector<float> values(width * height);
+    texture.download(PixelFormat::R, &values[0]);
+    for (uint32_t i = 0; i < width * height; ++i) ASSERT_EQ(frame * 1000.0f + i, values[i]);
+  }
+
+  std::vector<float> data(width * height, 3.0f);
+  uploader.upload(texture, PixelFormat::R, PixelType::FLOAT, &data[0]);
+  std::vector<float> values(width * height);
+  texture.download(PixelFormat::R, &values[0]);
+  for (uint32_t i = 0; i < width * height; ++i) ASSERT_EQ(3.0f, values[i]);
+
+  GlTexture large(width + 1, height, TextureFormat::R_FLOAT);
+  ASSERT_THROW(uploader.upload(large, PixelFormat::R, PixelType::FLOAT, &data[0]), GlTextureError);
+
+  // a frame, which does not fit, must leave the written buffer usable.
+  float* ptr = reinterpret_cast<float*>(uploader.map());
+  for (uint32_t i = 0; i < width * height; ++i) ptr[i] = 5.0f;
+  ASSERT_THROW(uploader.upload(large, PixelFormat::R, PixelType::FLOAT), GlTextureError);
+  ASSERT_EQ(ptr, uploader.map());
+  uploader.upload(texture, PixelFormat::R, PixelType::FLOAT);
+  texture.download(PixelFormat::R, &values[0]);
+  for (uint32_t i = 0; i < width * height; ++i) ASSERT_EQ(5.0f, values[i]);
+}
+
+TEST(UploaderTest, workerTest) {
+  uint32_t width = 8, height = 4, numFrames = 6;
+  GlTexture texture(width, height, TextureFormat::R_FLOAT);
+  GlTextureUploader uploader(width * height * sizeof(float));
+
+  for (uint32_t frame = 0; frame < numFrames; ++frame) {
+    uploader.submit([frame](void* ptr, size_t size) {
+      float* values = reinterpret_cast<float*>(ptr);
+      for (uint32_t i = 0; i < size / sizeof(float); ++i) values[i] = frame;
+    });
+  }
+
+  ASSERT_THROW(uploader.map(), GlTextureError);
+
+  // frames must arrive in order of submission; a frame, which does not fit, stays in the queue.
+  GlTexture large(width + 1, height, TextureFormat::R_FLOAT);
+  bool rejected = false;
+  uint32_t frame = 0;
+  while (frame < numFrames) {
+    if (!rejected && uploader.pending() > 0) {
+      try {
+        uploader.update(large, PixelFormat::R, PixelType::FLOAT);
+      } catch (const GlTextureError&) {
+        rejected = true;
+      }
+    }
+    if (!uploader.update(texture, PixelFormat::R, PixelType::FLOAT)) continue;
+
+    std::vector<float> values(width * height);
+    texture.download(PixelFormat::R, &values[0]);
+    for (uint32_t i = 0; i < width * height; ++i) ASSERT_EQ(float(frame), values[i]);
+    frame += 1;
+  }
+
+  ASSERT_EQ(0u, uploader.pending());
+}
+
+}